@@ -30,13 +30,34 @@ RESOURCES += \
 SOURCES += \
     $$SRC/DHCPServer/DHCPServer.cpp \
     $$SRC/EventsCoordinator/EventsCoordinator.cpp \
+    $$SRC/EventsCoordinator/SimulationScheduler.cpp \
+    $$SRC/EventsCoordinator/TickExecutor.cpp \
+    $$SRC/EventsCoordinator/TimerService.cpp \
+    $$SRC/EventsCoordinator/TimingWheel.cpp \
     $$SRC/IP/IP.cpp \
     $$SRC/PortBindingManager/PortBindingManager.cpp \
     $$SRC/Port/Port.cpp \
+    $$SRC/Queue/ActiveQueueManager.cpp \
+    $$SRC/Queue/OutputQueue.cpp \
+    $$SRC/Transport/BbrControl.cpp \
+    $$SRC/Transport/CongestionControl.cpp \
+    $$SRC/Transport/CubicControl.cpp \
+    $$SRC/Transport/TCPReceiver.cpp \
+    $$SRC/Transport/TCPSender.cpp \
+    $$SRC/Routing/ForwardingTable.cpp \
+    $$SRC/Routing/EpochReclaimer.cpp \
+    $$SRC/Routing/LinkStateDatabase.cpp \
+    $$SRC/Routing/RipAdvertiser.cpp \
+    $$SRC/Routing/RoutingTable.cpp \
+    $$SRC/Routing/ShortestPath.cpp \
+    $$SRC/Routing/SpfThrottle.cpp \
     $$SRC/MACAddress/MACAddress.cpp \
     $$SRC/MACAddress/MACAddressGenerator.cpp \
     $$SRC/DataGenerator/DataGenerator.cpp \
+    $$SRC/Packet/ControlMessage.cpp \
     $$SRC/Packet/Packet.cpp \
+    $$SRC/Packet/PacketPath.cpp \
+    $$SRC/Packet/PacketPool.cpp \
     $$SRC/Header/DataLinkHeader.cpp \
     $$SRC/Header/TCPHeader.cpp \
     $$SRC/NetworkSimulator/Simulator.cpp \
@@ -56,14 +77,39 @@ SOURCES += \
 HEADERS += \
     $$SRC/DHCPServer/DHCPServer.h \
     $$SRC/EventsCoordinator/EventsCoordinator.h \
+    $$SRC/EventsCoordinator/SimulationScheduler.h \
+    $$SRC/EventsCoordinator/TickExecutor.h \
+    $$SRC/EventsCoordinator/TimerService.h \
+    $$SRC/EventsCoordinator/TimingWheel.h \
     $$SRC/Globals/Globals.h \
     $$SRC/IP/IP.h \
     $$SRC/PortBindingManager/PortBindingManager.h \
     $$SRC/Port/Port.h \
+    $$SRC/Queue/ActiveQueueManager.h \
+    $$SRC/Queue/MpscRing.h \
+    $$SRC/Queue/OutputQueue.h \
+    $$SRC/Transport/BbrControl.h \
+    $$SRC/Transport/CongestionControl.h \
+    $$SRC/Transport/CubicControl.h \
+    $$SRC/Transport/TCPReceiver.h \
+    $$SRC/Transport/TCPSender.h \
+    $$SRC/Queue/SpscRing.h \
+    $$SRC/Routing/ForwardingTable.h \
+    $$SRC/Routing/DaryHeap.h \
+    $$SRC/Routing/EpochReclaimer.h \
+    $$SRC/Routing/LinkStateDatabase.h \
+    $$SRC/Routing/RcuPointer.h \
+    $$SRC/Routing/RipAdvertiser.h \
+    $$SRC/Routing/RoutingTable.h \
+    $$SRC/Routing/ShortestPath.h \
+    $$SRC/Routing/SpfThrottle.h \
     $$SRC/MACAddress/MACAddress.h \
     $$SRC/MACAddress/MACAddressGenerator.h \
     $$SRC/DataGenerator/DataGenerator.h \
+    $$SRC/Packet/ControlMessage.h \
     $$SRC/Packet/Packet.h \
+    $$SRC/Packet/PacketPath.h \
+    $$SRC/Packet/PacketPool.h \
     $$SRC/Header/DataLinkHeader.h \
     $$SRC/Header/TCPHeader.h \
     $$SRC/NetworkSimulator/Simulator.h \
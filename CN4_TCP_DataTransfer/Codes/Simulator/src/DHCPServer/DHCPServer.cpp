@@ -5,13 +5,15 @@
 #include "DHCPServer.h"
 #include "../IP/IPHeader.h"
 #include "../Network/Router.h"
+#include "../EventsCoordinator/EventsCoordinator.h"
+#include "../Packet/ControlMessage.h"
+#include "../Packet/PacketPool.h"
 
 DHCPServer::DHCPServer(int asId, const QSharedPointer<Router> &router, QObject *parent)
     : QObject(parent),
     m_asId(asId),
     m_router(router),
-    m_nextAvailableId(1),
-    m_currentTime(0)
+    m_nextAvailableId(1)
 {
     QString logFileName;
     if (m_asId == 1) {
@@ -52,29 +54,28 @@ void DHCPServer::receivePacket(const PacketPtr_t &packet)
         return;
     }
 
-    QString payload = packet->getPayload();
-    qDebug() << "DHCP Server processing packet with payload:" << payload;
-    writeLog(QString("DHCP Server processing packet with payload: %1").arg(payload));
+    qDebug() << "DHCP Server processing control packet with opcode"
+             << static_cast<int>(packet->controlType());
+    writeLog(QString("DHCP Server processing control packet with opcode %1")
+               .arg(static_cast<int>(packet->controlType())));
 
-    if (payload.contains("DHCP_REQUEST")) {
+    if (packet->controlType() == UT::PacketControlType::DHCPRequest) {
         assignIP(packet);
     }
 }
 
 void DHCPServer::assignIP(const PacketPtr_t &packet)
 {
-    QString     payload = packet->getPayload();
+    ControlMessageReader message(packet->getPayload());
 
-    QStringList parts   = payload.split(":");
-
-    if(parts.size() < 2)
+    if(message.type() != UT::PacketControlType::DHCPRequest)
     {
         qWarning() << "Malformed DHCP_REQUEST packet.";
         writeLog("Malformed DHCP_REQUEST packet.");
         return;
     }
 
-    int clientId = parts[1].toInt();
+    int clientId = static_cast<int>(message.sequence());
 
     if (m_asId == 1) {
         if (!((clientId >= 1 && clientId <= 16) || (clientId >= 24 && clientId <= 31))) {
@@ -149,11 +150,7 @@ void DHCPServer::assignIP(const PacketPtr_t &packet)
             }
         }
 
-        DHCPLease newLease;
-        newLease.ipAddress = assignedIpAddress;
-        newLease.clientId = clientId;
-
-        m_leases.append(newLease);
+        DHCPLease newLease = addLease(assignedIpAddress, clientId);
 
         QString newLeaseMsg = QString("New IP assigned (IPv6): %1 for client %2")
                                 .arg(newLease.ipAddress).arg(clientId);
@@ -174,8 +171,7 @@ void DHCPServer::assignIP(const PacketPtr_t &packet)
         }
     }
 
-    DHCPLease lease = { ipAddress, clientId, m_currentTime + LEASE_DURATION };
-    m_leases.append(lease);
+    DHCPLease lease = addLease(ipAddress, clientId);
 
     QString newIpMsg = QString("New IP assigned: %1 for client %2").arg(ipAddress).arg(clientId);
     qDebug() << newIpMsg;
@@ -184,10 +180,29 @@ void DHCPServer::assignIP(const PacketPtr_t &packet)
     sendOffer(lease);
 }
 
+DHCPServer::DHCPLease DHCPServer::addLease(const QString &ipAddress, int clientId)
+{
+    auto *coordinator = EventsCoordinator::instance();
+    const SimTime_t duration = coordinator->toTicks(std::chrono::seconds(LEASE_DURATION));
+
+    // The lease runs out in simulation time; the coordinator's timer service reclaims it.
+    DHCPLease lease = { ipAddress, clientId, coordinator->timers()->now() + duration };
+    coordinator->timers()->scheduleIn(duration, this, [this, ipAddress]() { reclaimLease(ipAddress); });
+    m_leases.append(lease);
+
+    return lease;
+}
+
 void DHCPServer::sendOffer(const DHCPLease &lease)
 {
-    QString payload = QString("DHCP_OFFER:%1:%2").arg(lease.ipAddress).arg(lease.clientId);
-    auto    offerPacket = QSharedPointer<Packet>::create(PacketType::Control, payload.toUtf8());
+    quint32 serverAddress =
+      m_router ? ControlAddress::fromString(m_router->getIPAddress()) : 0;
+    ControlMessageWriter offer(UT::PacketControlType::DHCPOffer, serverAddress,
+                               static_cast<quint32>(lease.clientId), 1);
+    offer.addAddress(lease.ipAddress);
+
+    auto    offerPacket = PacketPool::acquire(UT::PacketControlType::DHCPOffer, PacketType::Control,
+                                              offer.finish());
 
     offerPacket->setTTL(10);
 
@@ -212,7 +227,7 @@ void DHCPServer::sendOffer(const DHCPLease &lease)
 
                 QString broadcastMsg = QString("DHCP Server on Router %1 broadcasted DHCP offer: %2 via Port %3")
                                          .arg(m_router->getId())
-                                         .arg(payload)
+                                         .arg(lease.ipAddress)
                                          .arg(port->getPortNumber());
                 qDebug() << broadcastMsg;
                 writeLog(broadcastMsg);
@@ -224,16 +239,10 @@ void DHCPServer::sendOffer(const DHCPLease &lease)
     }
 }
 
-void DHCPServer::tick(int currentTime)
-{
-    m_currentTime = currentTime;
-    reclaimExpiredLeases();
-}
-
-void DHCPServer::reclaimExpiredLeases()
+void DHCPServer::reclaimLease(const QString &ipAddress)
 {
     for (int i = m_leases.size() - 1; i >= 0; --i) {
-        if (m_leases[i].leaseExpirationTime <= m_currentTime) {
+        if (m_leases[i].ipAddress == ipAddress) {
             QString msg = QString("Reclaiming expired IP: %1").arg(m_leases[i].ipAddress);
             qDebug() << msg;
             writeLog(msg);
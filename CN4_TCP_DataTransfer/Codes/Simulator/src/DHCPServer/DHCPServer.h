@@ -8,6 +8,7 @@
 
 #include "../Port/Port.h"
 #include "../Packet/Packet.h"
+#include "../EventsCoordinator/SimulationScheduler.h"
 
 class Router;
 
@@ -20,7 +21,6 @@ public:
     ~DHCPServer() override;
 
     void receivePacket(const PacketPtr_t &packet);
-    void tick(int currentTime);
 
 Q_SIGNALS:
     void broadcastPacket(const PacketPtr_t &packet);
@@ -29,12 +29,13 @@ private:
     struct DHCPLease {
         QString ipAddress;
         int clientId;
-        int leaseExpirationTime;
+        SimTime_t leaseExpirationTime; // tick
     };
 
     void assignIP(const PacketPtr_t &packet);
+    DHCPLease addLease(const QString &ipAddress, int clientId);
     void sendOffer(const DHCPLease &lease);
-    void reclaimExpiredLeases();
+    void reclaimLease(const QString &ipAddress);
 
     int m_asId;
     QSharedPointer<Port> m_port;
@@ -43,7 +44,6 @@ private:
     QString m_ipPrefix;
 
     int m_nextAvailableId;
-    int m_currentTime;
     QFile m_logFile;
     QTextStream m_logStream;
     void writeLog(const QString &message);
@@ -1,4 +1,5 @@
 #include "DataGenerator.h"
+#include "../Packet/PacketPool.h"
 
 #include <QDebug>
 #include <QFile>
@@ -63,7 +64,7 @@ DataGenerator::splitFileToPackets(const QString &filePath, size_t packetSize, si
     {
         QByteArray             payload = data.mid(i, packetSize);
         QSharedPointer<Packet> packet =
-          QSharedPointer<Packet>::create(PacketType::Data, payload, 64);
+          PacketPool::acquire(PacketType::Data, payload, 64);
 
         /**
          * ======================================================
@@ -1,4 +1,6 @@
 #include <QDebug>
+#include <algorithm>
+#include <limits>
 
 #include "QCoreApplication"
 #include "EventsCoordinator.h"
@@ -6,22 +8,14 @@
 
 EventsCoordinator::EventsCoordinator(QThread *parent) :
     QThread {parent},
-    m_timer {new QTimer(this)},
     m_dataGenerator {nullptr},
     m_routingChangedThisTick(false),
     m_convergenceTickCounter(0)
 {
-    connect(m_timer, &QTimer::timeout, this, &EventsCoordinator::onTick);
 }
 
 EventsCoordinator::~EventsCoordinator() {
-    QMetaObject::invokeMethod(this, [this]() {
-        if (m_timer) {
-            m_timer->stop();
-            delete m_timer;
-            m_timer = nullptr;
-        }
-    });
+    m_scheduler.stop();
     quit();
     wait();
 }
@@ -46,24 +40,32 @@ void EventsCoordinator::release()
 }
 
 void EventsCoordinator::startClock(Millis interval) {
-    QMetaObject::invokeMethod(this, [this, interval]() {
-        if (!m_timer) {
-            m_timer = new QTimer();
-            connect(m_timer, &QTimer::timeout, this, &EventsCoordinator::onTick);
-        }
-        
-        m_timer->start(interval.count());
-        qDebug() << "Clock started with interval:" << interval.count() << "ms";
-    });
+    m_cycleDuration = interval;
+    m_clockRunning  = true;
+    ensureTicking();
+
+    qDebug() << "Clock started at tick" << m_scheduler.now() << "(1 tick =" << interval.count() << "ms)";
+}
+
+void EventsCoordinator::setCycleDuration(Millis interval) {
+    m_cycleDuration = interval;
 }
 
 void EventsCoordinator::stopClock() {
-    QMetaObject::invokeMethod(this, [this]() {
-        if (m_timer && m_timer->isActive()) {
-            m_timer->stop();
-            qDebug() << "Clock stopped.";
-        }
-    });
+    if (m_clockRunning) {
+        m_clockRunning = false;
+        qDebug() << "Clock stopped at tick" << m_scheduler.now();
+    }
+}
+
+void EventsCoordinator::ensureTicking() {
+    if (!m_executor) {
+        setWorkerCount(0);
+    }
+
+    if (m_tickEvent == 0) {
+        m_tickEvent = m_scheduler.scheduleEvery(1, [this]() { onTick(); }, EventPriority::Tick);
+    }
 }
 
 void
@@ -86,7 +88,34 @@ EventsCoordinator::setDataGenerator(QSharedPointer<DataGenerator> generator)
 }
 
 void EventsCoordinator::onTick() {
-    ++m_currentTime;
+    if (m_nodesChanged) {
+        m_executor->setNodes(m_nodes);
+        m_nodesChanged = false;
+    }
+
+    TickContext context;
+    context.now         = m_scheduler.now();
+    context.routingTick = m_clockRunning;
+    context.dataTick    = m_sendingData;
+
+    // Node timers fire between ticks, never during a phase.
+    m_timers.advance(context.now);
+
+    quint64 moved = m_executor->runTick(context);
+    m_linksIdle   = (moved == 0);
+
+    if (m_sendingData) {
+        onNextTickForPCs();
+
+        // Convergence counts every tick, but in the data phase alone a tick that moved nothing
+        // can skip ahead, typically to a sender's retransmission deadline.
+        if (m_sendingData && !m_clockRunning && m_linksIdle) skipIdleTicks(context.now);
+    }
+
+    if (!m_clockRunning) {
+        return;
+    }
+
     emit tick();
 
     // if (m_packetQueue.empty()) {
@@ -125,6 +154,23 @@ void EventsCoordinator::onTick() {
     m_routingChangedThisTick = false;
 }
 
+void EventsCoordinator::skipIdleTicks(SimTime_t now) {
+    // Nothing moved, so the next tick that can do anything is the one of the first node timer,
+    // scheduled event or PC wake-up (a retransmission deadline, say). The ticks in between would
+    // only run empty phases.
+    SimTime_t wakeup = std::numeric_limits<SimTime_t>::max();
+    SimTime_t time;
+    if (m_timers.nextExpiry(time)) wakeup = qMin(wakeup, time);
+    if (m_scheduler.nextEventTime(time)) wakeup = qMin(wakeup, time);
+    for (const auto &pc : m_pcs) wakeup = qMin(wakeup, pc->nextWakeup(now));
+
+    // With nothing pending at all keep ticking, so whatever is started next is picked up at once.
+    if (wakeup == std::numeric_limits<SimTime_t>::max() || wakeup <= now + 1) return;
+
+    m_scheduler.postpone(m_tickEvent, wakeup);
+    m_skippedTicks += wakeup - now - 1;
+}
+
 void EventsCoordinator::onPacketsGenerated(const std::vector<QSharedPointer<Packet>> &packets)
 {
     m_packetQueue.insert(m_packetQueue.end(), packets.begin(), packets.end());
@@ -153,19 +199,133 @@ EventsCoordinator::startPacketSending()
 {
     stopClock();
 
-    disconnect(m_timer, &QTimer::timeout, this, &EventsCoordinator::onTick);
-    connect(m_timer, &QTimer::timeout, this, [this]() { emit nextTickForPCs(); });
-
-    m_timer->setInterval(Millis(2));
-    m_timer->setSingleShot(false);
-    m_timer->start();
+    m_quietDataTickCounter = 0;
+    m_sendingData          = true;
+    ensureTicking();
 }
 
 void
 EventsCoordinator::stopPacketSending()
 {
-    m_timer->stop();
-    connect(m_timer, &QTimer::timeout, this, &EventsCoordinator::onTick);
+    m_sendingData = false;
+}
+
+void
+EventsCoordinator::onNextTickForPCs()
+{
+    emit nextTickForPCs();
+
+    if(m_endRequested.exchange(false))
+    {
+        stopPacketSending();
+        emit thisIsTheEnd();
+        return;
+    }
+
+    // Once nothing moves over the links for a while and no PC is still waiting on its transfer, every
+    // packet has been either delivered or dropped and the data phase is over. A sender with segments
+    // outstanding keeps the run going until its retransmission timer has had its say.
+    bool transferPending = std::any_of(m_pcs.begin(), m_pcs.end(),
+                                       [](const QSharedPointer<PC> &pc) { return pc->hasPendingTransfer(); });
+
+    if(m_linksIdle && m_scheduler.pendingOneShotEvents() == 0 && !transferPending)
+    {
+        if(++m_quietDataTickCounter >= REQUIRED_STABLE_TICKS)
+        {
+            qDebug() << "No packets in flight for" << m_quietDataTickCounter
+                     << "ticks. Data phase finished at tick" << m_scheduler.now();
+            stopPacketSending();
+            emit thisIsTheEnd();
+        }
+    }
+    else
+    {
+        m_quietDataTickCounter = 0;
+    }
+}
+
+void
+EventsCoordinator::setWorkerCount(int workerCount)
+{
+    m_executor     = QSharedPointer<TickExecutor>::create(workerCount);
+    m_nodesChanged = true;
+}
+
+TickExecutor *
+EventsCoordinator::executor()
+{
+    return m_executor.data();
+}
+
+SimulationScheduler *
+EventsCoordinator::scheduler()
+{
+    return &m_scheduler;
+}
+
+SimTime_t
+EventsCoordinator::currentTime() const
+{
+    return m_scheduler.now();
+}
+
+SimTime_t
+EventsCoordinator::toTicks(Millis duration) const
+{
+    if(m_cycleDuration.count() <= 0) return duration.count();
+    return std::max<SimTime_t>(1, duration.count() / m_cycleDuration.count());
+}
+
+EventId_t
+EventsCoordinator::scheduleIn(SimTime_t delay, SimulationScheduler::Callback_t callback)
+{
+    return m_scheduler.scheduleIn(delay, std::move(callback), EventPriority::Control);
+}
+
+TimerService *
+EventsCoordinator::timers()
+{
+    return &m_timers;
+}
+
+void
+EventsCoordinator::requestEnd()
+{
+    m_endRequested.store(true);
+}
+
+void
+EventsCoordinator::runUntilIdle()
+{
+    ensureTicking();
+
+    // Tick until a whole tick moves nothing over any link and no delayed action is pending.
+    m_linksIdle = false;
+    while(!(m_linksIdle && m_scheduler.pendingOneShotEvents() == 0))
+    {
+        if(!m_scheduler.step()) break;
+    }
+}
+
+void
+EventsCoordinator::runEventLoop()
+{
+    ensureTicking();
+
+    qDebug() << "Event loop running from tick" << m_scheduler.now() << "on"
+             << m_executor->workerCount() << "workers";
+    // Queued signals are delivered between ticks, never in the middle of one.
+    m_scheduler.run([]() { QCoreApplication::processEvents(); });
+    qDebug() << "Event loop finished at tick" << m_scheduler.now() << "after"
+             << m_scheduler.executedEvents() << "events and" << m_skippedTicks << "skipped idle ticks;"
+             << m_executor->stolenTasks()
+             << "node tasks were stolen by idle workers.";
+}
+
+void
+EventsCoordinator::stopEventLoop()
+{
+    m_scheduler.stop();
 }
 
 QSharedPointer<DataGenerator>
@@ -176,18 +336,21 @@ EventsCoordinator::dataGenerator() const
 
 void EventsCoordinator::addRouter(const QSharedPointer<Router> &router) {
     m_routers.push_back(router);
-    connect(router.data(), &Router::routingTableUpdated, this, &EventsCoordinator::onRoutingTableUpdated);
+    m_nodes.push_back(router.data());
+    m_nodesChanged = true;
+    connect(router.data(), &Router::routingTableUpdated, this, &EventsCoordinator::onRoutingTableUpdated,
+            Qt::DirectConnection);
     qDebug() << "Router" << router->getId() << "added to EventsCoordinator.";
 }
 
+void EventsCoordinator::addPC(const QSharedPointer<PC> &pc) {
+    m_pcs.push_back(pc);
+    m_nodes.push_back(pc.data());
+    m_nodesChanged = true;
+    connect(pc.data(), &PC::thisIsTheEnd, this, &EventsCoordinator::requestEnd, Qt::DirectConnection);
+    qDebug() << "PC" << pc->getId() << "added to EventsCoordinator.";
+}
+
 void EventsCoordinator::run() {
-    m_timer = new QTimer();
-    connect(m_timer, &QTimer::timeout, this, &EventsCoordinator::onTick);
-    m_timer->start(1000);
-    qDebug() << "Clock started with interval:" << 1000 << "ms";
-
-    exec();
-    m_timer->stop();
-    delete m_timer;
-    m_timer = nullptr;
+    runEventLoop();
 }
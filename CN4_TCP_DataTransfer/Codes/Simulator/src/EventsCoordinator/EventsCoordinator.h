@@ -3,6 +3,9 @@
 
 #include "../Network/PC.h"
 #include "../Network/Router.h"
+#include "SimulationScheduler.h"
+#include "TickExecutor.h"
+#include "TimerService.h"
 
 #include <chrono>
 #include <vector>
@@ -10,7 +13,6 @@
 #include <QObject>
 #include <QSharedPointer>
 #include <QThread>
-#include <QTimer>
 
 class DataGenerator;
 class Packet;
@@ -31,13 +33,28 @@ public:
     static void                   release();
 
     void                          startClock(Millis interval);
+    void                          setCycleDuration(Millis interval);
     void                          stopClock();
 
     void                          setDataGenerator(QSharedPointer<DataGenerator> generator);
     QSharedPointer<DataGenerator> dataGenerator() const;
 
     void                          addRouter(const QSharedPointer<Router> &router);
+    void                          addPC(const QSharedPointer<PC> &pc);
 
+    void                          setWorkerCount(int workerCount);
+    TickExecutor                 *executor();
+
+    SimulationScheduler          *scheduler();
+    SimTime_t                     currentTime() const;
+    SimTime_t                     toTicks(Millis duration) const;
+    EventId_t                     scheduleIn(SimTime_t delay, SimulationScheduler::Callback_t callback);
+    TimerService                 *timers();
+
+    void                          requestEnd();
+    void                          runUntilIdle();
+    void                          runEventLoop();
+    void                          stopEventLoop();
 
     bool                          convergencePhaseDone() const;
     void                          setConvergencePhaseDone(bool newConvergencePhaseDone);
@@ -61,21 +78,37 @@ private slots:
     void onRoutingTableUpdated(int routerId);
 
 private:
+    void                                ensureTicking();
+    void                                skipIdleTicks(SimTime_t now);
+    void                                onNextTickForPCs();
+
     inline static EventsCoordinator    *m_self          = nullptr;
-    QTimer                             *m_timer         = nullptr;
+    SimulationScheduler                 m_scheduler;
+    TimerService                        m_timers;
+    QSharedPointer<TickExecutor>        m_executor;
+    std::vector<Node *>                 m_nodes;
+    bool                                m_nodesChanged  = false;
+    EventId_t                           m_tickEvent     = 0;
+    bool                                m_clockRunning  = false;
+    bool                                m_sendingData   = false;
+    bool                                m_linksIdle     = false;
+    quint64                             m_skippedTicks  = 0;
+    std::atomic<bool>                   m_endRequested {false};
+    Millis                              m_cycleDuration = Millis(100);
     QSharedPointer<DataGenerator>       m_dataGenerator = nullptr;
 
     std::vector<QSharedPointer<Packet>> m_packetQueue;
     std::vector<QSharedPointer<Router>> m_routers;
     std::vector<QSharedPointer<PC>>     m_pcs;
 
-    bool                                m_routingChangedThisTick;
+    std::atomic<bool>                   m_routingChangedThisTick;
     bool                                m_convergencePhaseDone = false;
     int                                 m_convergenceTickCounter;
     const int                           REQUIRED_STABLE_TICKS = 20;
 
+    int                                 m_quietDataTickCounter = 0;
+
     void                                synchronizeRoutersWithDHCP();
-    int                                 m_currentTime = 0;
 };
 
 #endif    // EVENTSCOORDINATOR_H
@@ -0,0 +1,228 @@
+#include "SimulationScheduler.h"
+
+#include <algorithm>
+
+SimulationScheduler::SimulationScheduler() :
+    m_nextSequence(0),
+    m_nextId(0),
+    m_now(0),
+    m_stopRequested(false),
+    m_running(false),
+    m_executedEvents(0)
+{}
+
+SimTime_t
+SimulationScheduler::now() const
+{
+    return m_now.load(std::memory_order_acquire);
+}
+
+EventId_t
+SimulationScheduler::scheduleAt(SimTime_t time, Callback_t callback, EventPriority priority)
+{
+    return push(std::max(time, now()), 0, std::move(callback), priority);
+}
+
+EventId_t
+SimulationScheduler::scheduleIn(SimTime_t delay, Callback_t callback, EventPriority priority)
+{
+    return push(now() + delay, 0, std::move(callback), priority);
+}
+
+EventId_t
+SimulationScheduler::scheduleEvery(SimTime_t period, Callback_t callback, EventPriority priority)
+{
+    if(period == 0) period = 1;
+    return push(now() + period, period, std::move(callback), priority);
+}
+
+bool
+SimulationScheduler::cancel(EventId_t id)
+{
+    QMutexLocker locker(&m_mutex);
+    m_recurring.remove(id);
+    m_postponed.remove(id);
+    return m_live.remove(id);
+}
+
+void
+SimulationScheduler::postpone(EventId_t id, SimTime_t time)
+{
+    QMutexLocker locker(&m_mutex);
+    if(m_recurring.contains(id)) m_postponed.insert(id, time);
+}
+
+bool
+SimulationScheduler::nextEventTime(SimTime_t &time) const
+{
+    QMutexLocker locker(&m_mutex);
+    if(m_heap.empty()) return false;
+
+    time = m_heap.front().time;
+    return true;
+}
+
+EventId_t
+SimulationScheduler::push(SimTime_t time, SimTime_t period, Callback_t callback,
+                          EventPriority priority)
+{
+    QMutexLocker locker(&m_mutex);
+
+    EventId_t    id = ++m_nextId;
+    m_heap.push_back(Event{time, priority, m_nextSequence++, id, period, std::move(callback)});
+    std::push_heap(m_heap.begin(), m_heap.end(), EventLater());
+
+    m_live.insert(id);
+    if(period > 0) m_recurring.insert(id);
+
+    return id;
+}
+
+bool
+SimulationScheduler::popNext(Event &event)
+{
+    QMutexLocker locker(&m_mutex);
+
+    while(!m_heap.empty())
+    {
+        std::pop_heap(m_heap.begin(), m_heap.end(), EventLater());
+        event = std::move(m_heap.back());
+        m_heap.pop_back();
+
+        if(!m_live.contains(event.id)) continue;    // cancelled, dropped lazily
+
+        if(event.period == 0) m_live.remove(event.id);
+        return true;
+    }
+
+    return false;
+}
+
+bool
+SimulationScheduler::nextTickDue() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_heap.empty() || m_heap.front().time > now();
+}
+
+bool
+SimulationScheduler::step()
+{
+    Event event;
+    if(!popNext(event)) return false;
+
+    m_now.store(event.time, std::memory_order_release);
+    event.callback();
+    m_executedEvents.fetch_add(1, std::memory_order_relaxed);
+
+    if(event.period > 0)
+    {
+        QMutexLocker locker(&m_mutex);
+
+        // The callback may have cancelled its own timer.
+        if(m_live.contains(event.id))
+        {
+            event.time     += event.period;
+            auto postponed  = m_postponed.find(event.id);
+            if(postponed != m_postponed.end())
+            {
+                event.time = std::max(event.time, postponed.value());
+                m_postponed.erase(postponed);
+            }
+            event.sequence  = m_nextSequence++;
+            m_heap.push_back(std::move(event));
+            std::push_heap(m_heap.begin(), m_heap.end(), EventLater());
+        }
+    }
+
+    return true;
+}
+
+void
+SimulationScheduler::run(const Callback_t &betweenTicks)
+{
+    m_stopRequested.store(false);
+    m_running.store(true);
+
+    while(!m_stopRequested.load(std::memory_order_acquire))
+    {
+        // Every event of the current tick has run; the caller may look outside before the clock moves.
+        if(betweenTicks && nextTickDue()) betweenTicks();
+
+        if(!step()) break;
+    }
+
+    m_running.store(false);
+}
+
+void
+SimulationScheduler::runUntil(SimTime_t time)
+{
+    m_stopRequested.store(false);
+    m_running.store(true);
+
+    while(!m_stopRequested.load(std::memory_order_acquire))
+    {
+        {
+            QMutexLocker locker(&m_mutex);
+            if(m_heap.empty() || m_heap.front().time > time) break;
+        }
+
+        if(!step()) break;
+    }
+
+    if(now() < time) m_now.store(time, std::memory_order_release);
+    m_running.store(false);
+}
+
+void
+SimulationScheduler::runUntilIdle()
+{
+    m_stopRequested.store(false);
+    m_running.store(true);
+
+    while(!m_stopRequested.load(std::memory_order_acquire) && pendingOneShotEvents() > 0)
+    {
+        if(!step()) break;
+    }
+
+    m_running.store(false);
+}
+
+void
+SimulationScheduler::stop()
+{
+    m_stopRequested.store(true, std::memory_order_release);
+}
+
+bool
+SimulationScheduler::isRunning() const
+{
+    return m_running.load(std::memory_order_acquire);
+}
+
+bool
+SimulationScheduler::isIdle() const
+{
+    return pendingEvents() == 0;
+}
+
+size_t
+SimulationScheduler::pendingEvents() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_live.size();
+}
+
+size_t
+SimulationScheduler::pendingOneShotEvents() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_live.size() - m_recurring.size();
+}
+
+quint64
+SimulationScheduler::executedEvents() const
+{
+    return m_executedEvents.load(std::memory_order_relaxed);
+}
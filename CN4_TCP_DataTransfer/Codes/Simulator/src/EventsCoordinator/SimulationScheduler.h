@@ -0,0 +1,124 @@
+#ifndef SIMULATIONSCHEDULER_H
+#define SIMULATIONSCHEDULER_H
+
+#include <atomic>
+#include <functional>
+#include <vector>
+
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+
+/**
+ * Virtual simulation time, measured in ticks (one tick == one `cycle_duration`).
+ */
+typedef quint64 SimTime_t;
+typedef quint64 EventId_t;
+
+/**
+ * What a node is asked to do on one tick of the executor.
+ */
+struct TickContext
+{
+    SimTime_t now         = 0;
+    bool      routingTick = false;    // routing protocols are converging
+    bool      dataTick    = false;    // PCs are sending data packets
+};
+
+/**
+ * Ordering of events that share the same timestamp. Lower values run first, so packets that
+ * arrive at tick t are delivered before the handlers of tick t look at their buffers.
+ */
+enum class EventPriority : int
+{
+    Delivery = 0,
+    Timer    = 1,
+    Tick     = 2,
+    Control  = 3
+};
+
+/**
+ * Discrete-event scheduler with a virtual clock.
+ *
+ * Events are kept in a binary heap ordered by (time, priority, insertion order). The clock jumps
+ * straight to the next pending event, so a run takes as long as the work it contains rather than
+ * wall-clock time. A recurring event still runs every period; one that finds nothing to do can
+ * postpone() its next run to skip the idle stretch. Events may be posted from any thread;
+ * callbacks run on the thread that drives the scheduler.
+ */
+class SimulationScheduler
+{
+public:
+    typedef std::function<void()> Callback_t;
+
+    SimulationScheduler();
+
+    SimTime_t now() const;
+
+    EventId_t scheduleAt(SimTime_t time, Callback_t callback,
+                         EventPriority priority = EventPriority::Control);
+    EventId_t scheduleIn(SimTime_t delay, Callback_t callback,
+                         EventPriority priority = EventPriority::Control);
+    EventId_t scheduleEvery(SimTime_t period, Callback_t callback,
+                            EventPriority priority = EventPriority::Tick);
+    bool      cancel(EventId_t id);
+    /**
+     * Moves the next run of the recurring event @p id to @p time, if that is later than its next
+     * period. Meant to be called from the event's own callback.
+     */
+    void      postpone(EventId_t id, SimTime_t time);
+    /** Time of the earliest pending event; false if there is none. */
+    bool      nextEventTime(SimTime_t &time) const;
+
+    bool      step();
+    void      run(const Callback_t &betweenTicks = {});
+    void      runUntil(SimTime_t time);
+    void      runUntilIdle();
+    void      stop();
+
+    bool      isRunning() const;
+    bool      isIdle() const;
+    size_t    pendingEvents() const;
+    size_t    pendingOneShotEvents() const;
+    quint64   executedEvents() const;
+
+private:
+    struct Event
+    {
+        SimTime_t     time;
+        EventPriority priority;
+        quint64       sequence;
+        EventId_t     id;
+        SimTime_t     period;
+        Callback_t    callback;
+    };
+
+    struct EventLater
+    {
+        bool
+        operator()(const Event &a, const Event &b) const
+        {
+            if(a.time != b.time) return a.time > b.time;
+            if(a.priority != b.priority) return a.priority > b.priority;
+            return a.sequence > b.sequence;
+        }
+    };
+
+    EventId_t push(SimTime_t time, SimTime_t period, Callback_t callback, EventPriority priority);
+    bool      popNext(Event &event);
+    bool      nextTickDue() const;
+
+    mutable QMutex              m_mutex;
+    std::vector<Event>          m_heap;
+    QSet<EventId_t>             m_live;
+    QSet<EventId_t>             m_recurring;
+    QHash<EventId_t, SimTime_t> m_postponed;
+    quint64                     m_nextSequence;
+    EventId_t                   m_nextId;
+    std::atomic<SimTime_t>      m_now;
+    std::atomic<bool>           m_stopRequested;
+    std::atomic<bool>           m_running;
+    std::atomic<quint64>        m_executedEvents;
+};
+
+#endif    // SIMULATIONSCHEDULER_H
@@ -0,0 +1,188 @@
+#include "TickExecutor.h"
+#include "../Network/Node.h"
+
+#include <QDebug>
+
+TickExecutor::TickExecutor(int workerCount) :
+    m_generation(0),
+    m_pendingWorkers(0),
+    m_phase(TickPhase::Receive),
+    m_quit(false)
+{
+    if(workerCount <= 0) workerCount = QThread::idealThreadCount();
+    if(workerCount <= 0) workerCount = 1;
+
+    m_queues = std::vector<WorkerQueue>(workerCount);
+
+    for(int i = 1; i < workerCount; ++i)
+    {
+        QThread *thread = QThread::create([this, i]() { workerLoop(i); });
+        thread->setObjectName(QString("TickWorker-%1").arg(i));
+        thread->start();
+        m_threads.push_back(thread);
+    }
+
+    qDebug() << "TickExecutor started with" << workerCount << "workers.";
+}
+
+TickExecutor::~TickExecutor()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_quit = true;
+        m_phaseStarted.wakeAll();
+    }
+
+    for(QThread *thread : m_threads)
+    {
+        thread->wait();
+        delete thread;
+    }
+}
+
+void
+TickExecutor::setNodes(const std::vector<Node *> &nodes)
+{
+    for(auto &queue : m_queues)
+    {
+        queue.nodes.clear();
+    }
+
+    for(size_t i = 0; i < nodes.size(); ++i)
+    {
+        m_queues[i % m_queues.size()].nodes.push_back(nodes[i]);
+    }
+}
+
+quint64
+TickExecutor::runTick(const TickContext &context)
+{
+    m_context = context;
+
+    runPhase(TickPhase::Receive);
+    runPhase(TickPhase::Route);
+    runPhase(TickPhase::Transmit);
+
+    quint64 work = 0;
+    for(auto &queue : m_queues)
+    {
+        work       += queue.work;
+        queue.work  = 0;
+    }
+
+    return work;
+}
+
+void
+TickExecutor::runPhase(TickPhase phase)
+{
+    for(auto &queue : m_queues)
+    {
+        queue.cursor.store(0, std::memory_order_relaxed);
+    }
+
+    if(!m_threads.empty())
+    {
+        QMutexLocker locker(&m_mutex);
+        m_phase          = phase;
+        m_pendingWorkers = static_cast<int>(m_threads.size());
+        ++m_generation;
+        m_phaseStarted.wakeAll();
+    }
+
+    workOn(0, phase);
+
+    if(!m_threads.empty())
+    {
+        QMutexLocker locker(&m_mutex);
+        while(m_pendingWorkers > 0)
+        {
+            m_phaseFinished.wait(&m_mutex);
+        }
+    }
+}
+
+void
+TickExecutor::workOn(int self, TickPhase phase)
+{
+    const int    workers = static_cast<int>(m_queues.size());
+    WorkerQueue &own     = m_queues[self];
+    quint64      work    = 0;
+
+    // Own nodes first, then whatever the other workers have not claimed yet.
+    for(int k = 0; k < workers; ++k)
+    {
+        WorkerQueue &queue = m_queues[(self + k) % workers];
+
+        for(size_t i = queue.cursor.fetch_add(1, std::memory_order_relaxed); i < queue.nodes.size();
+            i        = queue.cursor.fetch_add(1, std::memory_order_relaxed))
+        {
+            Node *node = queue.nodes[i];
+
+            switch(phase)
+            {
+                case TickPhase::Receive:
+                    work += node->receivePhase(m_context);
+                    break;
+                case TickPhase::Route:
+                    work += node->routePhase(m_context);
+                    break;
+                case TickPhase::Transmit:
+                    work += node->transmitPhase(m_context);
+                    break;
+            }
+
+            if(k != 0) ++own.stolen;
+        }
+    }
+
+    own.work += work;
+}
+
+void
+TickExecutor::workerLoop(int self)
+{
+    quint64 seenGeneration = 0;
+
+    for(;;)
+    {
+        TickPhase phase;
+        {
+            QMutexLocker locker(&m_mutex);
+            while(m_generation == seenGeneration && !m_quit)
+            {
+                m_phaseStarted.wait(&m_mutex);
+            }
+
+            if(m_quit) return;
+
+            seenGeneration = m_generation;
+            phase          = m_phase;
+        }
+
+        workOn(self, phase);
+
+        {
+            QMutexLocker locker(&m_mutex);
+            if(--m_pendingWorkers == 0) m_phaseFinished.wakeAll();
+        }
+    }
+}
+
+int
+TickExecutor::workerCount() const
+{
+    return static_cast<int>(m_queues.size());
+}
+
+quint64
+TickExecutor::stolenTasks() const
+{
+    quint64 stolen = 0;
+    for(const auto &queue : m_queues)
+    {
+        stolen += queue.stolen;
+    }
+
+    return stolen;
+}
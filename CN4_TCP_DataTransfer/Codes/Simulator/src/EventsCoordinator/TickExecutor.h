@@ -0,0 +1,68 @@
+#ifndef TICKEXECUTOR_H
+#define TICKEXECUTOR_H
+
+#include <atomic>
+#include <vector>
+
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+
+#include "SimulationScheduler.h"
+
+class Node;
+
+enum class TickPhase
+{
+    Receive,
+    Route,
+    Transmit
+};
+
+/**
+ * Runs the nodes of the network on a fixed pool of worker threads, one tick at a time.
+ *
+ * A tick is split into the receive, route and transmit phases with a barrier between them. Nodes
+ * are statically assigned to workers round-robin; a worker that runs out of its own nodes steals
+ * unclaimed ones from the other workers, so a few busy routers do not hold the whole tick back.
+ * The thread calling runTick() acts as worker 0.
+ */
+class TickExecutor
+{
+public:
+    explicit TickExecutor(int workerCount = 0);
+    ~TickExecutor();
+
+    void    setNodes(const std::vector<Node *> &nodes);
+    quint64 runTick(const TickContext &context);
+
+    int     workerCount() const;
+    quint64 stolenTasks() const;
+
+private:
+    struct alignas(64) WorkerQueue
+    {
+        std::vector<Node *> nodes;
+        std::atomic<size_t> cursor {0};
+        quint64             work   = 0;    // written by the owning worker only
+        quint64             stolen = 0;
+    };
+
+    void    runPhase(TickPhase phase);
+    void    workOn(int self, TickPhase phase);
+    void    workerLoop(int self);
+
+    std::vector<WorkerQueue> m_queues;
+    std::vector<QThread *>   m_threads;
+
+    QMutex                   m_mutex;
+    QWaitCondition           m_phaseStarted;
+    QWaitCondition           m_phaseFinished;
+    quint64                  m_generation;
+    int                      m_pendingWorkers;
+    TickPhase                m_phase;
+    TickContext              m_context;
+    bool                     m_quit;
+};
+
+#endif    // TICKEXECUTOR_H
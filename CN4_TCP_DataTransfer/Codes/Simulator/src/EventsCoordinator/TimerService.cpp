@@ -0,0 +1,119 @@
+#include "TimerService.h"
+
+#include <vector>
+
+TimerService::TimerService() :
+    m_nextId(0)
+{}
+
+TimerService::TimerId_t
+TimerService::scheduleIn(SimTime_t delay, QObject *context, Callback_t callback)
+{
+    return add(delay, 0, context, std::move(callback));
+}
+
+TimerService::TimerId_t
+TimerService::scheduleEvery(SimTime_t period, QObject *context, Callback_t callback)
+{
+    if(period == 0) period = 1;
+    return add(period, period, context, std::move(callback));
+}
+
+TimerService::TimerId_t
+TimerService::add(SimTime_t delay, SimTime_t period, QObject *context, Callback_t callback)
+{
+    QMutexLocker locker(&m_mutex);
+
+    const TimerId_t id = ++m_nextId;
+
+    Timer timer;
+    timer.callback   = std::move(callback);
+    timer.context    = context;
+    timer.hasContext = context != nullptr;
+    timer.period     = period;
+    timer.wheelId    = m_wheel.schedule(m_wheel.now() + qMax<SimTime_t>(delay, 1), id);
+    m_timers.insert(id, std::move(timer));
+
+    return id;
+}
+
+bool
+TimerService::cancel(TimerId_t id)
+{
+    QMutexLocker locker(&m_mutex);
+
+    auto it = m_timers.find(id);
+    if(it == m_timers.end()) return false;
+
+    m_wheel.cancel(it.value().wheelId);
+    m_timers.erase(it);
+    return true;
+}
+
+int
+TimerService::advance(SimTime_t now)
+{
+    std::vector<TimerId_t> due;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_wheel.advance(now, [&due](TimingWheel::TimerId_t, quint64 id) { due.push_back(id); });
+    }
+
+    // Callbacks run without the lock so they can schedule and cancel timers; a timer cancelled by
+    // an earlier callback of the same tick does not run.
+    int run = 0;
+    for(TimerId_t id : due)
+    {
+        Callback_t callback;
+        {
+            QMutexLocker locker(&m_mutex);
+
+            auto it = m_timers.find(id);
+            if(it == m_timers.end()) continue;
+
+            Timer &timer = it.value();
+            if(timer.hasContext && timer.context.isNull())
+            {
+                m_timers.erase(it);
+                continue;
+            }
+
+            if(timer.period > 0)
+            {
+                callback      = timer.callback;
+                timer.wheelId = m_wheel.schedule(m_wheel.now() + timer.period, id);
+            }
+            else
+            {
+                callback = std::move(timer.callback);
+                m_timers.erase(it);
+            }
+        }
+
+        callback();
+        ++run;
+    }
+
+    return run;
+}
+
+SimTime_t
+TimerService::now() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_wheel.now();
+}
+
+size_t
+TimerService::pendingTimers() const
+{
+    QMutexLocker locker(&m_mutex);
+    return static_cast<size_t>(m_timers.size());
+}
+
+bool
+TimerService::nextExpiry(SimTime_t &expiry) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_wheel.nextExpiry(expiry);
+}
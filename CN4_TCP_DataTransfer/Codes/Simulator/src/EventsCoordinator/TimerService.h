@@ -0,0 +1,63 @@
+#ifndef TIMERSERVICE_H
+#define TIMERSERVICE_H
+
+#include "TimingWheel.h"
+
+#include <functional>
+
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QPointer>
+
+/**
+ * Simulation-time timers for the nodes: OSPF hellos and LSA refreshes, buffer retention, DHCP
+ * leases. One service is owned by the EventsCoordinator and advanced once per tick, before the
+ * nodes' phases, so a callback never runs while a phase is touching the same node.
+ *
+ * Timers are kept in a TimingWheel: scheduling and cancelling are O(1) and a tick with nothing
+ * due costs nothing, whatever the number of timers waiting. A timer may be tied to a context
+ * object; once that object is destroyed the timer is dropped instead of run. Timers can be
+ * scheduled and cancelled from any thread.
+ */
+class TimerService
+{
+public:
+    typedef quint64               TimerId_t;
+    typedef std::function<void()> Callback_t;
+
+    static constexpr TimerId_t NO_TIMER = 0;
+
+    TimerService();
+
+    TimerId_t scheduleIn(SimTime_t delay, QObject *context, Callback_t callback);
+    TimerId_t scheduleEvery(SimTime_t period, QObject *context, Callback_t callback);
+    bool      cancel(TimerId_t id);
+
+    /** Moves the clock to @p now and runs the callbacks that came due. Returns the number run. */
+    int       advance(SimTime_t now);
+
+    SimTime_t now() const;
+    size_t    pendingTimers() const;
+    /** The tick the next timer fires on; false if none is pending. */
+    bool      nextExpiry(SimTime_t &expiry) const;
+
+private:
+    struct Timer
+    {
+        Callback_t             callback;
+        QPointer<QObject>      context;
+        bool                   hasContext = false;
+        SimTime_t              period     = 0;    // 0 for a one-shot timer
+        TimingWheel::TimerId_t wheelId    = TimingWheel::NO_TIMER;
+    };
+
+    TimerId_t add(SimTime_t delay, SimTime_t period, QObject *context, Callback_t callback);
+
+    mutable QMutex          m_mutex;
+    TimingWheel             m_wheel;
+    QHash<TimerId_t, Timer> m_timers;
+    TimerId_t               m_nextId;
+};
+
+#endif    // TIMERSERVICE_H
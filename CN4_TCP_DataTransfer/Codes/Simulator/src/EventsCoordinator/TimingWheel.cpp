@@ -0,0 +1,185 @@
+#include "TimingWheel.h"
+
+namespace
+{
+constexpr int     INDEX_BITS = 24;
+constexpr quint32 INDEX_MASK = (1u << INDEX_BITS) - 1;
+}    // namespace
+
+TimingWheel::TimingWheel(SimTime_t now) :
+    m_now(now),
+    m_heads(FIRING + 1, NIL),
+    m_size(0)
+{}
+
+TimingWheel::TimerId_t
+TimingWheel::schedule(SimTime_t expiry, quint64 data)
+{
+    int node;
+    if(!m_free.empty())
+    {
+        node = m_free.back();
+        m_free.pop_back();
+    }
+    else
+    {
+        node = static_cast<int>(m_nodes.size());
+        if(static_cast<quint32>(node) >= INDEX_MASK) qFatal("TimingWheel: too many timers");
+        m_nodes.emplace_back();
+    }
+
+    m_nodes[node].expiry = qMax(expiry, m_now + 1);
+    m_nodes[node].data   = data;
+    place(node);
+    ++m_size;
+
+    return idOf(node);
+}
+
+bool
+TimingWheel::cancel(TimerId_t id)
+{
+    const int node = nodeOf(id);
+    if(node == NIL) return false;
+
+    release(node);
+    return true;
+}
+
+bool
+TimingWheel::isPending(TimerId_t id) const
+{
+    return nodeOf(id) != NIL;
+}
+
+SimTime_t
+TimingWheel::now() const
+{
+    return m_now;
+}
+
+size_t
+TimingWheel::size() const
+{
+    return m_size;
+}
+
+bool
+TimingWheel::nextExpiry(SimTime_t &expiry) const
+{
+    bool found = false;
+    for(const Node &node : m_nodes)
+    {
+        if(node.list == NIL) continue;
+        if(!found || node.expiry < expiry) expiry = node.expiry;
+        found = true;
+    }
+
+    return found;
+}
+
+int
+TimingWheel::slotOf(int level, SimTime_t time)
+{
+    return level * SLOTS + static_cast<int>((time >> (level * SLOT_BITS)) & (SLOTS - 1));
+}
+
+TimingWheel::TimerId_t
+TimingWheel::idOf(int node) const
+{
+    return (TimerId_t(m_nodes[node].generation) << INDEX_BITS) | TimerId_t(node + 1);
+}
+
+int
+TimingWheel::nodeOf(TimerId_t id) const
+{
+    const int node = static_cast<int>(id & INDEX_MASK) - 1;
+    if(node < 0 || node >= static_cast<int>(m_nodes.size())) return NIL;
+
+    const Node &n = m_nodes[node];
+    if(n.list == NIL || n.generation != quint8(id >> INDEX_BITS)) return NIL;
+    return node;
+}
+
+void
+TimingWheel::place(int node)
+{
+    const SimTime_t expiry = m_nodes[node].expiry;
+    const SimTime_t delta  = expiry - m_now;
+
+    for(int level = 0; level < LEVELS; ++level)
+    {
+        if(delta < (SimTime_t(1) << ((level + 1) * SLOT_BITS)))
+        {
+            link(node, slotOf(level, expiry));
+            return;
+        }
+    }
+
+    // Beyond the horizon: park in the farthest slot of the last level and place again from there.
+    link(node, slotOf(LEVELS - 1, m_now + (SimTime_t(1) << (LEVELS * SLOT_BITS)) - 1));
+}
+
+void
+TimingWheel::link(int node, int list)
+{
+    Node &n = m_nodes[node];
+    n.list  = list;
+    n.prev  = NIL;
+    n.next  = m_heads[list];
+    if(n.next != NIL) m_nodes[n.next].prev = node;
+    m_heads[list] = node;
+}
+
+void
+TimingWheel::unlink(int node)
+{
+    Node &n = m_nodes[node];
+    if(n.prev != NIL)
+        m_nodes[n.prev].next = n.next;
+    else
+        m_heads[n.list] = n.next;
+    if(n.next != NIL) m_nodes[n.next].prev = n.prev;
+
+    n.prev = n.next = n.list = NIL;
+}
+
+void
+TimingWheel::release(int node)
+{
+    unlink(node);
+    ++m_nodes[node].generation;
+    m_free.push_back(node);
+    --m_size;
+}
+
+void
+TimingWheel::moveSlot(int from, int to)
+{
+    while(m_heads[from] != NIL)
+    {
+        const int node = m_heads[from];
+        unlink(node);
+        if(to == NIL)
+            place(node);
+        else
+            link(node, to);
+    }
+}
+
+void
+TimingWheel::cascade()
+{
+    // Entering a new level-n slot moves its timers down, coarsest first so that they can cascade
+    // again within the same tick.
+    int level = 1;
+    while(level < LEVELS && (m_now & ((SimTime_t(1) << (level * SLOT_BITS)) - 1)) == 0)
+    {
+        ++level;
+    }
+
+    for(int n = level - 1; n >= 1; --n)
+    {
+        moveSlot(slotOf(n, m_now), NIL);
+    }
+}
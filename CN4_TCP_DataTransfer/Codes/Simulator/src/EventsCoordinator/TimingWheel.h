@@ -0,0 +1,112 @@
+#ifndef TIMINGWHEEL_H
+#define TIMINGWHEEL_H
+
+#include "SimulationScheduler.h"
+
+#include <vector>
+
+/**
+ * Hierarchical timing wheel for large numbers of timers counted in ticks.
+ *
+ * Four levels of 64 slots each cover 2^24 ticks ahead; a level-n slot spans 64^n ticks. A timer
+ * goes into the finest level whose range reaches its expiry, and the timers of a coarse slot are
+ * spread over the finer levels when the clock enters that slot. Scheduling and cancelling are
+ * O(1), and advancing the clock only touches the timers that are due or moved down a level, so
+ * idle timers cost nothing per tick. Timers further away than the horizon wait in the last level
+ * and are placed again each time it comes round.
+ *
+ * A timer carries one 64-bit value for its owner. Ids pack a slot index and a generation, so an id
+ * whose timer has fired or been cancelled is recognised as such. Not thread-safe: a wheel belongs
+ * to the node that advances it.
+ */
+class TimingWheel
+{
+public:
+    typedef quint32 TimerId_t;
+
+    static constexpr TimerId_t NO_TIMER = 0;
+
+    explicit TimingWheel(SimTime_t now = 0);
+
+    /** Schedules a timer for @p expiry; a time that is not after now fires on the next advance. */
+    TimerId_t schedule(SimTime_t expiry, quint64 data);
+    bool      cancel(TimerId_t id);
+    bool      isPending(TimerId_t id) const;
+
+    /**
+     * Moves the clock to @p now and calls @p onExpire(id, data) for every timer that came due, in
+     * expiry order. The callback may schedule and cancel timers. Returns the number fired.
+     */
+    template <typename Callback>
+    int
+    advance(SimTime_t now, Callback &&onExpire)
+    {
+        int fired = 0;
+        if(m_size == 0 && m_now < now) m_now = now;    // nothing to cascade or fire
+
+        while(m_now < now)
+        {
+            ++m_now;
+            cascade();
+
+            moveSlot(slotOf(0, m_now), FIRING);
+            while(m_heads[FIRING] != NIL)
+            {
+                const int       node = m_heads[FIRING];
+                const TimerId_t id   = idOf(node);
+                const quint64   data = m_nodes[node].data;
+
+                release(node);
+                onExpire(id, data);
+                ++fired;
+            }
+        }
+
+        return fired;
+    }
+
+    SimTime_t now() const;
+    size_t    size() const;
+
+    /**
+     * The earliest expiry among the pending timers; false if there are none. Walks every timer, so
+     * it is meant for idle spells rather than every tick.
+     */
+    bool      nextExpiry(SimTime_t &expiry) const;
+
+private:
+    static constexpr int LEVELS    = 4;
+    static constexpr int SLOT_BITS = 6;
+    static constexpr int SLOTS     = 1 << SLOT_BITS;
+    static constexpr int FIRING    = LEVELS * SLOTS;    // list being fired by advance()
+    static constexpr int NIL       = -1;
+
+    struct Node
+    {
+        SimTime_t expiry     = 0;
+        quint64   data       = 0;
+        int       prev       = NIL;
+        int       next       = NIL;
+        int       list       = NIL;    // slot the node is linked into, NIL while free
+        quint8    generation = 0;
+    };
+
+    static int slotOf(int level, SimTime_t time);
+
+    TimerId_t  idOf(int node) const;
+    int        nodeOf(TimerId_t id) const;
+    void       place(int node);
+    void       link(int node, int list);
+    void       unlink(int node);
+    void       release(int node);
+    void       moveSlot(int from, int to);
+    void       cascade();
+
+    SimTime_t         m_now;
+    std::vector<Node> m_nodes;
+    std::vector<int>  m_heads;
+    std::vector<int>  m_free;
+    size_t            m_size;
+};
+
+#endif    // TIMINGWHEEL_H
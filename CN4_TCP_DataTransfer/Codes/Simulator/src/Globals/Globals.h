@@ -16,8 +16,10 @@ enum class PacketType
     Control
 };
 
+// Opcode of a control packet; also the type byte of the control message wire format.
 enum class PacketControlType
 {
+    None,
     Request,
     Response,
     Acknowledge,
@@ -29,6 +31,10 @@ enum class PacketControlType
     DHCPNak,
     RIP,
     OSPF,
+    OSPFLSA,
+    EBGP,
+    IBGP,
+    Count    // number of opcodes
 };
 
 enum class DistributionType
@@ -69,6 +69,14 @@ uint8_t TCPHeader::getFlags() const {
     return m_flags;
 }
 
+bool TCPHeader::hasFlag(uint8_t flag) const {
+    return (m_flags & flag) == flag;
+}
+
+void TCPHeader::setFlag(uint8_t flag, bool on) {
+    m_flags = on ? (m_flags | flag) : (m_flags & ~flag);
+}
+
 void TCPHeader::setWindowSize(uint16_t windowSize) {
     m_windowSize = windowSize;
 }
@@ -93,6 +101,25 @@ uint16_t TCPHeader::getUrgentPointer() const {
     return m_urgentPointer;
 }
 
+bool TCPHeader::addSackBlock(uint32_t left, uint32_t right) {
+    if (m_sackBlockCount >= MAX_SACK_BLOCKS || right <= left) return false;
+
+    m_sackBlocks[m_sackBlockCount++] = SackBlock{left, right};
+    return true;
+}
+
+int TCPHeader::sackBlockCount() const {
+    return m_sackBlockCount;
+}
+
+TCPHeader::SackBlock TCPHeader::sackBlock(int index) const {
+    return index >= 0 && index < m_sackBlockCount ? m_sackBlocks[index] : SackBlock{};
+}
+
+void TCPHeader::clearSackBlocks() {
+    m_sackBlockCount = 0;
+}
+
 QString TCPHeader::toString() const {
     return QString("Source Port: %1, Destination Port: %2, Sequence Number: %3, Acknowledgment Number: %4, Data Offset: %5, Flags: %6, Window Size: %7, Checksum: %8, Urgent Pointer: %9")
     .arg(m_sourcePort)
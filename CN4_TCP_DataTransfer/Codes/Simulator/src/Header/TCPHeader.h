@@ -1,12 +1,32 @@
 #ifndef TCPHEADER_H
 #define TCPHEADER_H
 
+#include <array>
 #include <cstdint>
 #include <QString>
 
 class TCPHeader
 {
 public:
+    // Flag bits of the 8-bit flags field; ECE and CWR carry ECN feedback (RFC 3168).
+    static constexpr uint8_t FLAG_FIN = 0x01;
+    static constexpr uint8_t FLAG_SYN = 0x02;
+    static constexpr uint8_t FLAG_RST = 0x04;
+    static constexpr uint8_t FLAG_PSH = 0x08;
+    static constexpr uint8_t FLAG_ACK = 0x10;
+    static constexpr uint8_t FLAG_URG = 0x20;
+    static constexpr uint8_t FLAG_ECE = 0x40;
+    static constexpr uint8_t FLAG_CWR = 0x80;
+
+    // SACK option (RFC 2018): blocks of segments received above the acknowledgment number, each
+    // [left, right). Three fit next to the timestamps option.
+    struct SackBlock
+    {
+        uint32_t left = 0;
+        uint32_t right = 0;
+    };
+    static constexpr int MAX_SACK_BLOCKS = 3;
+
     explicit TCPHeader(uint16_t sourcePort = 0,
                        uint16_t destPort = 0,
                        uint32_t sequenceNumber = 0,
@@ -35,6 +55,9 @@ public:
     void setFlags(uint8_t flags);
     uint8_t getFlags() const;
 
+    bool hasFlag(uint8_t flag) const;
+    void setFlag(uint8_t flag, bool on = true);
+
     void setWindowSize(uint16_t windowSize);
     uint16_t getWindowSize() const;
 
@@ -44,6 +67,12 @@ public:
     void setUrgentPointer(uint16_t urgentPointer);
     uint16_t getUrgentPointer() const;
 
+    // Returns false, adding nothing, once MAX_SACK_BLOCKS are set or when the block is empty.
+    bool addSackBlock(uint32_t left, uint32_t right);
+    int sackBlockCount() const;
+    SackBlock sackBlock(int index) const;
+    void clearSackBlocks();
+
     QString toString() const;
 
 private:
@@ -52,10 +81,12 @@ private:
     uint32_t m_sequenceNumber;
     uint32_t m_acknowledgmentNumber;
     uint8_t m_dataOffset;
-    uint8_t m_flags;  // Flags like URG, ACK, PSH, RST, SYN, FIN
+    uint8_t m_flags;  // Flags like CWR, ECE, URG, ACK, PSH, RST, SYN, FIN
     uint16_t m_windowSize;
     uint16_t m_checksum;
     uint16_t m_urgentPointer;
+    std::array<SackBlock, MAX_SACK_BLOCKS> m_sackBlocks {};
+    uint8_t m_sackBlockCount = 0;
 };
 
 #endif // TCPHEADER_H
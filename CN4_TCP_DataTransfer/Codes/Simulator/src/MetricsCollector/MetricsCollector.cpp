@@ -1,5 +1,7 @@
 #include <QDebug>
 #include "MetricsCollector.h"
+#include "../Packet/PacketPath.h"
+#include "../Packet/PacketPool.h"
 
 MetricsCollector::MetricsCollector(QObject *parent) :
     QObject(parent),
@@ -16,14 +18,12 @@ void MetricsCollector::recordPacketSent() {
     m_sentPackets++;
 }
 
-void MetricsCollector::recordPacketReceived(const QVector<QString> &path) {
+void MetricsCollector::recordPacketReceived(const PacketPath &path) {
     QMutexLocker locker(&m_mutex);
     m_receivedPackets++;
 
-    for (const auto &routerIP : path) {
-        if (routerIP.startsWith("192.168.")) {
-            m_routerUsage[routerIP]++;
-        }
+    for (int i = 0; i < path.size(); ++i) {
+        m_pathUsage[path.at(i)]++;
     }
 }
 
@@ -34,17 +34,20 @@ MetricsCollector::recordWaitCycle(size_t waitCycle)
     m_waitCyclesBuffer.emplaceBack(waitCycle);
 }
 
-void MetricsCollector::increamentHops() { m_totalHops++; }
+void MetricsCollector::increamentHops(int count) {
+    QMutexLocker locker(&m_mutex);
+    m_totalHops += count;
+}
 
-void MetricsCollector::recordPacketDropped() {
+void MetricsCollector::recordPacketDropped(int count) {
     QMutexLocker locker(&m_mutex);
-    m_droppedPackets++;
+    m_droppedPackets += count;
 }
 
-void MetricsCollector::recordRouterUsage(const QString &routerIP) {
+void MetricsCollector::recordRouterUsage(const QString &routerIP, int count) {
     QMutexLocker locker(&m_mutex);
     if (routerIP.startsWith("192.168.")) {
-        m_routerUsage[routerIP]++;
+        m_routerUsage[routerIP] += count;
     }
 }
 
@@ -63,6 +66,7 @@ void MetricsCollector::printStatistics() const {
 
     double lossRate = (m_sentPackets > 0) ? 100 - (((double)m_receivedPackets / m_sentPackets) * 100.0) : 0.0;
     qDebug() << "Packet Loss Rate:" << lossRate << "%";
+    qDebug() << "Packet Pool Hits:" << PacketPool::hits() << "// Misses:" << PacketPool::misses();
 
     double averageHopCount = (m_receivedPackets > 0) ? ((double)m_totalHops / m_receivedPackets) : 0.0;
     qDebug() << "Total Hop " << m_totalHops << " // Average Hop Count:" << averageHopCount;
@@ -149,18 +153,26 @@ void MetricsCollector::printStatistics() const {
         qDebug() << "No wait cycles data available within the acceptable range.";
     }
 
+    QMap<QString, int> routerUsage = m_routerUsage;
+    for (auto it = m_pathUsage.constBegin(); it != m_pathUsage.constEnd(); ++it) {
+        QString routerIP = PacketPath::addressAt(it.key());
+        if (routerIP.startsWith("192.168.")) {
+            routerUsage[routerIP] += it.value();
+        }
+    }
+
     qDebug() << "Router Usage:";
-    if (m_routerUsage.isEmpty()) {
+    if (routerUsage.isEmpty()) {
         qDebug() << "No router usage data available.";
     } else {
-        for (auto it = m_routerUsage.constBegin(); it != m_routerUsage.constEnd(); ++it) {
+        for (auto it = routerUsage.constBegin(); it != routerUsage.constEnd(); ++it) {
             qDebug() << it.key() << ":" << it.value() << "packets";
         }
     }
 
     QString poorRouter;
     int maxUsage = 0;
-    for (auto it = m_routerUsage.constBegin(); it != m_routerUsage.constEnd(); ++it) {
+    for (auto it = routerUsage.constBegin(); it != routerUsage.constEnd(); ++it) {
         if (it.value() > maxUsage) {
             maxUsage = it.value();
             poorRouter = it.key();
@@ -1,11 +1,14 @@
 #ifndef METRICSCOLLECTOR_H
 #define METRICSCOLLECTOR_H
 
+#include <QHash>
 #include <QMap>
 #include <QMutex>
 #include <QString>
 #include <QObject>
 
+class PacketPath;
+
 class MetricsCollector : public QObject
 {
     Q_OBJECT
@@ -15,15 +18,15 @@ public:
     ~MetricsCollector() override = default;
 
     void recordPacketSent();
-    void recordPacketReceived(const QVector<QString> &path);
-    void recordPacketDropped();
+    void recordPacketReceived(const PacketPath &path);
+    void recordPacketDropped(int count = 1);
 
-    void recordRouterUsage(const QString &routerIP);
+    void recordRouterUsage(const QString &routerIP, int count = 1);
     void recordHopCount(int hopCount);
     void recordWaitCycle(size_t waitCycle);
 
     void printStatistics() const;
-    void increamentHops();
+    void increamentHops(int count = 1);
 
 private:
     mutable QMutex m_mutex;
@@ -34,6 +37,7 @@ private:
     int m_totalHops;
     QVector<size_t>    m_waitCyclesBuffer;
     QMap<QString, int> m_routerUsage;
+    QHash<quint16, int> m_pathUsage;    // per PacketPath address index, resolved when printing
 };
 
 #endif // METRICSCOLLECTOR_H
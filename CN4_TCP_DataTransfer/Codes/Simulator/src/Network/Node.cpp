@@ -1,5 +1,6 @@
 #include "Node.h"
 #include "../IP/IP.h"
+#include "../Packet/PacketPath.h"
 
 int Node::s_globalNodeId = 0;
 
@@ -15,6 +16,36 @@ int Node::getNextGlobalId()
     return ++s_globalNodeId;
 }
 
+quint16 Node::pathIndex() const
+{
+    // Re-intern only when DHCP has changed the address since the last call.
+    QString address = m_ipAddress->getIp();
+    if (address != m_pathAddress || m_pathAddress.isEmpty()) {
+        m_pathIndex   = PacketPath::indexOf(address);
+        m_pathAddress = address;
+    }
+
+    return m_pathIndex;
+}
+
+quint64 Node::receivePhase(const TickContext &context)
+{
+    Q_UNUSED(context)
+    return 0;
+}
+
+quint64 Node::routePhase(const TickContext &context)
+{
+    Q_UNUSED(context)
+    return 0;
+}
+
+quint64 Node::transmitPhase(const TickContext &context)
+{
+    Q_UNUSED(context)
+    return 0;
+}
+
 int Node::getId() const
 {
     QMutexLocker locker(&m_mutex);
@@ -7,6 +7,7 @@
 
 #include "../IP/IP.h"
 #include "../MACAddress/MACAddress.h"
+#include "../EventsCoordinator/SimulationScheduler.h"
 
 enum class NodeType
 {
@@ -29,6 +30,17 @@ public:
 
     static int getNextGlobalId();
 
+    /** Index of the node's current address in the PacketPath table, for recording hops. */
+    quint16 pathIndex() const;
+
+    /**
+     * Per-tick phases run by the TickExecutor. Every node finishes a phase before any node starts
+     * the next one. Each hook returns the number of packets it moved so idle ticks can be detected.
+     */
+    virtual quint64 receivePhase(const TickContext &context);
+    virtual quint64 routePhase(const TickContext &context);
+    virtual quint64 transmitPhase(const TickContext &context);
+
 protected:
     int m_id;
     QSharedPointer<IP> m_ipAddress;
@@ -38,6 +50,11 @@ protected:
     mutable QMutex m_mutex;
 
     static int s_globalNodeId;
+
+private:
+    // Cache for pathIndex(); only touched by the worker running this node.
+    mutable QString m_pathAddress;
+    mutable quint16 m_pathIndex = 0;
 };
 
 #endif // NODE_H
@@ -3,10 +3,13 @@
 #include "../DataGenerator/DataGenerator.h"
 #include "../EventsCoordinator/EventsCoordinator.h"
 #include "../MACAddress/MACADdressGenerator.h"
+#include "../Packet/ControlMessage.h"
 #include "../Packet/Packet.h"
+#include "../Packet/PacketPool.h"
 
 #include <QDebug>
 #include <QThread>
+#include <limits>
 
 PC::PC(int id, const QString &ipAddress, QObject *parent) :
     Node(id, ipAddress, NodeType::PC, parent)
@@ -15,19 +18,16 @@ PC::PC(int id, const QString &ipAddress, QObject *parent) :
     m_port->setPortNumber(1);
     m_port->setRouterIP(m_ipAddress->getIp());
 
-    connect(m_port.get(), &Port::packetReceived, this, &PC::processPacket);
+    m_sender.setEcn(s_ecnEnabled);
+    m_sender.setCongestionControl(s_defaultCongestionControl);
+
+    connect(m_port.get(), &Port::packetReceived, this, &PC::processPacket, Qt::DirectConnection);
 
     QSharedPointer<MACAddressGenerator> generator = QSharedPointer<MACAddressGenerator>::create();
     m_macAddress                                  = generator->generate();
 
     qDebug() << "PC initialized: ID =" << m_id << ", IP =" << m_ipAddress->getIp();
 
-    auto eventsCoordinator = EventsCoordinator::instance();
-
-    connect(eventsCoordinator, &EventsCoordinator::nextTickForPCs, this, &PC::generatePacket);
-
-    connect(this, &PC::thisIsTheEnd, eventsCoordinator, &EventsCoordinator::thisIsTheEnd);
-
     setObjectName(QString::number(m_id));
 }
 
@@ -49,50 +49,197 @@ PC::initialize()
              << ", running in thread" << (quintptr)QThread::currentThreadId();
 }
 
+quint64
+PC::receivePhase(const TickContext &context)
+{
+    m_now = context.now;
+    return m_port->drainIngress([this](const QList<PacketPtr_t> &burst) {
+        for(const auto &packet : burst)
+        {
+            processPacket(packet);
+        }
+    });
+}
+
+quint64
+PC::routePhase(const TickContext &context)
+{
+    m_now = context.now;
+    if(context.dataTick) generatePacket();
+    return 0;
+}
+
+quint64
+PC::transmitPhase(const TickContext &context)
+{
+    Q_UNUSED(context)
+    return m_port->flush();
+}
+
 void
-PC::generatePacket()
+PC::setBurstSize(int size)
 {
-    m_workingWithDataPackets = true;
-    /**
-     * ======================================================
-     * ======================================================
-     * ======================================================
-     * ======================================================
-     * @attention Send Packets from buffer to the destination.
-     * @attention Be aware that you must follow the TCP congestion control algorithms here.
-     * ======================================================
-     * ======================================================
-     * ======================================================
-     * ======================================================
-     **/
+    m_burstSize = qBound(1, size, Port::MAX_BURST_SIZE);
+}
+
+void
+PC::setTrafficClass(int trafficClass)
+{
+    m_trafficClass = qBound(0, trafficClass, OutputQueue::CLASS_COUNT - 1);
+}
+
+void
+PC::setEcnEnabled(bool enabled)
+{
+    s_ecnEnabled = enabled;
+}
+
+void
+PC::setReceiveBufferSize(int segments)
+{
+    s_receiveBufferSize = qMax(1, segments);
+}
+
+void
+PC::setDefaultCongestionControl(CongestionAlgorithm algorithm)
+{
+    s_defaultCongestionControl = algorithm;
+}
+
+void
+PC::setCongestionControl(CongestionAlgorithm algorithm)
+{
+    QMutexLocker locker(&m_receiveMutex);
+    m_sender.setCongestionControl(algorithm);
+}
+
+TCPSenderStats
+PC::senderStats() const
+{
+    QMutexLocker locker(&m_receiveMutex);
+    return m_sender.stats();
+}
+
+bool
+PC::hasPendingTransfer() const
+{
+    QMutexLocker locker(&m_receiveMutex);
+    return !m_packetStorage.isEmpty() || m_sender.outstanding() > 0 || !m_pendingAcks.isEmpty();
+}
+
+SimTime_t
+PC::nextWakeup(SimTime_t now) const
+{
+    QMutexLocker locker(&m_receiveMutex);
+
+    // A paced sender earns its budget tick by tick, so it is never idle while it has data.
+    quint32    sequence;
+    QByteArray payload;
+    bool       paced = m_sender.congestionControl().pacingRate() > 0;
+    if(!m_pendingAcks.isEmpty() || m_sender.nextRetransmission(sequence, payload)
+       || (!m_packetStorage.isEmpty() && (paced || m_sender.canSendNew())))
+        return now + 1;
+
+    if(m_sender.timerRunning()) return qMax(now + 1, m_sender.rtoDeadline());
+
+    return std::numeric_limits<SimTime_t>::max();
+}
+
+QMap<QString, TCPReceiverStats>
+PC::receiverStats() const
+{
+    QMutexLocker locker(&m_receiveMutex);
 
-    if(m_packetStorage.isEmpty())
+    QMap<QString, TCPReceiverStats> stats;
+    for(auto it = m_receivers.cbegin(); it != m_receivers.cend(); ++it)
     {
-        // qWarning() << "PC" << m_id << "has no packets to send.";
-        return;
+        stats.insert(it.key(), it->receiver.stats());
     }
+    return stats;
+}
 
-    // qInfo() << Q_FUNC_INFO << "PC" << m_id << "ip:" << m_ipAddress->getIp() << "has"
-    //         << m_packetStorage.size() << "packets to send.";
+QByteArray
+PC::receivedData(const QString &sourceIP) const
+{
+    QMutexLocker locker(&m_receiveMutex);
+    return m_receivers.value(sourceIP).data;
+}
 
+void
+PC::generatePacket()
+{
+    QMutexLocker locker(&m_receiveMutex);
 
-    static const QString destination   = "192.168.100.24";
-    auto                 destinationIP = QSharedPointer<IP>::create(destination);
+    m_workingWithDataPackets = true;
 
-    auto                 packet        = m_packetStorage.takeFirst();
+    // ACKs queued while receiving go first, ahead of this PC's own data.
+    sendPendingAcks();
 
-    packet->addToPath(m_ipAddress->getIp());
-    packet->addToPathTaken(m_ipAddress->getIp());
-    packet->addToPath(destination);
-    packet->setDestinationIP(destinationIP);
-    packet->setSourceIP(m_ipAddress);
+    m_sender.onTick(m_now);
+
+    // Lost segments go before new data. The burst is bounded by the burst size, the room on the link
+    // and the sender's window; whatever does not fit stays for the next tick.
+    bool               hadData = !m_packetStorage.isEmpty();
+    QList<PacketPtr_t> burst;
+    quint32            sequence;
+    QByteArray         payload;
+
+    while(burst.size() < m_burstSize && m_port->canSend(burst.size() + 1))
+    {
+        if(m_sender.nextRetransmission(sequence, payload))
+        {
+            burst.append(makeSegment(sequence, payload));
+            m_sender.onRetransmitted(sequence, m_now);
+        }
+        else if(!m_packetStorage.isEmpty() && m_sender.canSendNew())
+        {
+            PacketPtr_t packet = m_packetStorage.takeFirst();
+            addressSegment(packet, m_sender.onSent(packet->getPayload(), m_now));
+            burst.append(packet);
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    if(burst.isEmpty()) return;
 
-    if(m_packetStorage.length() == 0)
+    m_port->sendPackets(burst);
+
+    if(hadData && m_packetStorage.isEmpty())
     {
         qDebug() << "PC" << m_id << "sent the last packet.";
     }
+}
 
-    m_port->sendPacket(packet);
+PacketPtr_t
+PC::makeSegment(quint32 sequence, const QByteArray &payload)
+{
+    auto packet = PacketPool::acquire(PacketType::Data, payload);
+    addressSegment(packet, sequence);
+    return packet;
+}
+
+void
+PC::addressSegment(const PacketPtr_t &packet, quint32 sequence)
+{
+    static const QString destination      = "192.168.100.24";
+    static const quint16 destinationIndex = PacketPath::indexOf(destination);
+    if(!m_destinationIP) m_destinationIP = QSharedPointer<IP>::create(destination);
+
+    packet->addToPath(pathIndex());
+    packet->addToPathTaken(pathIndex());
+    packet->addToPath(destinationIndex);
+    packet->setDestinationIP(m_destinationIP);
+    packet->setSourceIP(m_ipAddress);
+    packet->setTrafficClass(m_trafficClass);
+    packet->setEcn(m_sender.ecn() ? EcnCodepoint::Ect0 : EcnCodepoint::NotEct);
+    packet->setSequenceNumber(static_cast<int>(sequence));
+
+    TCPHeader header = packet->getTCPHeader();
+    header.setSequenceNumber(sequence);
+    packet->setTCPHeader(header);
 }
 
 void
@@ -100,7 +247,7 @@ PC::processDataPacket(const PacketPtr_t &packet)
 {
     if(!packet) return;
 
-    static size_t packet_counter = 0;
+    QMutexLocker locker(&m_receiveMutex);
 
     if(packet->sourceIP()->getIp() == m_ipAddress->getIp())
     {
@@ -108,22 +255,23 @@ PC::processDataPacket(const PacketPtr_t &packet)
         return;
     }
 
+    // ACKs are told apart by the header, not the payload, which is just a label. They are transport
+    // feedback rather than delivered data and stay out of the received-packet and hop metrics.
+    TCPHeader header = packet->getTCPHeader();
+    if(header.hasFlag(TCPHeader::FLAG_ACK))
+    {
+        if(m_ipAddress->getIp() != packet->destinationIP()->getIp()) return;
+
+        QList<TCPHeader::SackBlock> sackBlocks;
+        for(int i = 0; i < header.sackBlockCount(); ++i) sackBlocks.append(header.sackBlock(i));
+
+        m_sender.onAck(header.getAcknowledgmentNumber(), header.hasFlag(TCPHeader::FLAG_ECE), m_now, sackBlocks);
+        return;
+    }
+
     if(m_id == 24)
     {
-        packet_counter++;
-        qDebug() << "PC" << m_id << "received" << packet_counter << "th packet.";
-
-        /**
-         * ======================================================
-         * ======================================================
-         * ======================================================
-         * ======================================================
-         * @attention Handle the received packet and remove this return.
-         * ======================================================
-         * ======================================================
-         * ======================================================
-         * ======================================================
-         **/
+        receiveSegment(packet);
         return;
     }
 
@@ -151,8 +299,7 @@ PC::processDataPacket(const PacketPtr_t &packet)
         if(m_metricsCollector)
         {
             m_metricsCollector->increamentHops();
-            m_metricsCollector->recordPacketReceived(packet->getPath());
-            m_metricsCollector->increamentHops();
+            m_metricsCollector->recordPacketReceived(packet->path());
             m_metricsCollector->recordWaitCycle(packet->getWaitingCycle());
         }
     }
@@ -173,21 +320,6 @@ PC::processDataPacket(const PacketPtr_t &packet)
 
         packet->addToPathTaken(destinationIP);
 
-        if(payload == "TCP_ACK")
-        {
-            /**
-                 * ======================================================
-                 * ======================================================
-                 * ======================================================
-                 * ======================================================
-                 * @attention Handle the received ACK packet.
-                 * ======================================================
-                 * ======================================================
-                 * ======================================================
-                 * ======================================================
-                 */
-        }
-
             /**
              * ======================================================
              * ======================================================
@@ -224,8 +356,9 @@ void
 PC::requestIPFromDHCP()
 {
     qDebug() << "PC" << m_id << "requesting IP via DHCP.";
-    auto packet = QSharedPointer<Packet>::create(PacketType::Control,
-                                                 QString("DHCP_REQUEST:%1").arg(m_id).toUtf8());
+    ControlMessageWriter request(UT::PacketControlType::DHCPRequest, 0, static_cast<quint32>(m_id));
+    auto packet = PacketPool::acquire(UT::PacketControlType::DHCPRequest, PacketType::Control,
+                                      request.finish());
     m_port->sendPacket(packet);
 
     emit packetSent(packet);
@@ -236,21 +369,21 @@ PC::processPacket(const PacketPtr_t &packet)
 {
     if(!packet) return;
 
+    // Runs on this PC's worker only; the lock is for the stats read from outside the phases.
+    QMutexLocker locker(&m_receiveMutex);
+
     if(m_workingWithDataPackets)
     {
         return processDataPacket(packet);
     }
 
-    QString payload = packet->getPayload();
-    // qDebug() << "PC" << m_id << "received packet with payload:" << payload;
-
-    if(payload.contains("DHCP_OFFER"))
+    if(packet->controlType() == UT::PacketControlType::DHCPOffer)
     {
-        QStringList parts = payload.split(":");
-        if(parts.size() == 3)
+        ControlMessageReader message(packet->getPayload());
+        if(message.recordCount() == 1)
         {
-            QString offeredIP = parts.at(1);
-            int     clientId  = parts.at(2).toInt();
+            QString offeredIP = message.recordAddress(0);
+            int     clientId  = static_cast<int>(message.sequence());
 
             if(clientId == m_id)
             {
@@ -261,7 +394,7 @@ PC::processPacket(const PacketPtr_t &packet)
         }
         else
         {
-            qWarning() << "Malformed DHCP_OFFER packet on PC" << m_id << "payload:" << payload;
+            qWarning() << "Malformed DHCP offer on PC" << m_id;
         }
     }
     else
@@ -272,6 +405,58 @@ PC::processPacket(const PacketPtr_t &packet)
     // emit thisIsTheEnd();
 }
 
+void
+PC::receiveSegment(const PacketPtr_t &packet)
+{
+    // Reassemble per sender and pass on whatever is now in order. Every arrival is ACKed, so data
+    // above a hole yields a duplicate ACK with SACK straight away. ECE reflects exactly whether the
+    // packet just received was marked.
+    TCPHeader data   = packet->getTCPHeader();
+    QString   source = packet->sourceIP()->getIp();
+
+    auto state = m_receivers.find(source);
+    if(state == m_receivers.end())
+        state = m_receivers.insert(source, ReceiveState{TCPReceiver(s_receiveBufferSize), QByteArray()});
+
+    TCPReceiver::Arrival arrival = state->receiver.onSegment(data.getSequenceNumber(), packet->getPayload());
+    state->data.append(state->receiver.read());
+
+    // Each segment counts as delivered once, when the receiver first accepts it. Routers count the
+    // hops they forward on; the one left is the sender's own access link.
+    if(m_metricsCollector
+       && (arrival == TCPReceiver::Arrival::InOrder || arrival == TCPReceiver::Arrival::OutOfOrder))
+    {
+        m_metricsCollector->increamentHops();
+        m_metricsCollector->recordPacketReceived(packet->path());
+        m_metricsCollector->recordWaitCycle(packet->getWaitingCycle());
+    }
+
+    TCPHeader header(data.getDestPort(), data.getSourcePort());
+    state->receiver.fillAck(header);
+    header.setFlag(TCPHeader::FLAG_ACK);
+    header.setFlag(TCPHeader::FLAG_ECE, packet->isCongestionExperienced());
+
+    auto ack = PacketPool::acquire(PacketType::Data, QByteArray("TCP_ACK"));
+    ack->addToPath(pathIndex());
+    ack->addToPathTaken(pathIndex());
+    ack->addToPath(PacketPath::indexOf(packet->sourceIP()->getIp()));
+    ack->setDestinationIP(packet->sourceIP());
+    ack->setSourceIP(m_ipAddress);
+    ack->setTrafficClass(packet->trafficClass());
+    ack->setSequenceNumber(static_cast<int>(header.getAcknowledgmentNumber()));
+    ack->setTCPHeader(header);
+
+    m_pendingAcks.append(ack);
+}
+
+void
+PC::sendPendingAcks()
+{
+    if(m_pendingAcks.isEmpty()) return;
+
+    m_pendingAcks.remove(0, m_port->sendPackets(m_pendingAcks));
+}
+
 void
 PC::fillStorage(const QList<PacketPtr_t> &packets)
 {
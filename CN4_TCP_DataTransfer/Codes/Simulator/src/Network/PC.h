@@ -3,8 +3,13 @@
 
 #include "../MetricsCollector/MetricsCollector.h"
 #include "../Port/Port.h"
+#include "../Transport/TCPReceiver.h"
+#include "../Transport/TCPSender.h"
 #include "Node.h"
 
+#include <QHash>
+#include <QMap>
+#include <QRecursiveMutex>
 #include <QSharedPointer>
 
 class PC : public Node
@@ -23,6 +28,51 @@ public:
 
     void      initDataGeneratorListener();
 
+    /** Packets handed to the port per data tick, at most Port::MAX_BURST_SIZE. */
+    void      setBurstSize(int size);
+
+    /** Traffic class stamped on the data packets this PC sends; see Packet::trafficClass(). */
+    void      setTrafficClass(int trafficClass);
+
+    /**
+     * ECN on the data path: data goes out ECN-capable, the receiver echoes marks as ECE and the
+     * sender's congestion control reacts to them (see TCPSender). Takes effect for PCs created
+     * afterwards.
+     */
+    static void setEcnEnabled(bool enabled);
+
+    /** Segments each receiving connection can hold out of order; for PCs created afterwards. */
+    static void setReceiveBufferSize(int segments);
+
+    /** Congestion control for PCs created afterwards; Reno unless set. */
+    static void setDefaultCongestionControl(CongestionAlgorithm algorithm);
+
+    /** Congestion control of this PC's sender; meant for before the data phase starts. */
+    void      setCongestionControl(CongestionAlgorithm algorithm);
+
+    TCPSenderStats senderStats() const;
+
+    /**
+     * True while this PC still has work in its transfer: data not yet sent, segments not yet
+     * acknowledged (a retransmission timer may still fire) or ACKs waiting for room on the link.
+     */
+    bool      hasPendingTransfer() const;
+
+    /**
+     * The next tick this PC has anything to do on, after @p now: the next one while it can send,
+     * its retransmission deadline while it only waits for ACKs, never once its transfer is done.
+     */
+    SimTime_t nextWakeup(SimTime_t now) const;
+
+    /** Receiving side, per sender IP. */
+    QMap<QString, TCPReceiverStats> receiverStats() const;
+    /** The in-order byte stream received so far from @p sourceIP. */
+    QByteArray                      receivedData(const QString &sourceIP) const;
+
+    quint64   receivePhase(const TickContext &context) override;
+    quint64   routePhase(const TickContext &context) override;
+    quint64   transmitPhase(const TickContext &context) override;
+
 signals:
     void packetSent(const PacketPtr_t &data);
     void thisIsTheEnd();
@@ -32,16 +82,43 @@ public Q_SLOTS:
     void generatePacket();
     void requestIPFromDHCP();
     void processPacket(const PacketPtr_t &packet);
-    void processDataPacket(const PacketPtr_t &packet);
 
 private:
-    void fillStorage(const QList<PacketPtr_t> &packets);
+    void        processDataPacket(const PacketPtr_t &packet);
+    void        fillStorage(const QList<PacketPtr_t> &packets);
+    void        receiveSegment(const PacketPtr_t &packet);
+    void        sendPendingAcks();
+    PacketPtr_t makeSegment(quint32 sequence, const QByteArray &payload);
+    void        addressSegment(const PacketPtr_t &packet, quint32 sequence);
 
 private:
     PortPtr_t                        m_port;
     QSharedPointer<MetricsCollector> m_metricsCollector;
     QList<PacketPtr_t>               m_packetStorage;
     bool                             m_workingWithDataPackets = false;
+    int                              m_burstSize              = 1;
+    int                              m_trafficClass           = 0;
+    mutable QRecursiveMutex          m_receiveMutex;
+    // Tick time of the sender and receiver. Packets only arrive over the link, in the receive phase.
+    SimTime_t                        m_now = 0;
+
+    // Receiver: one connection per sender, and the application data it has delivered in order.
+    struct ReceiveState
+    {
+        TCPReceiver receiver;
+        QByteArray  data;
+    };
+    QHash<QString, ReceiveState>     m_receivers;
+    // ACKs queued while receiving, sent ahead of data on the next tick.
+    QList<PacketPtr_t>               m_pendingAcks;
+
+    // Sender: the one connection this PC sends its data on.
+    TCPSender                        m_sender;
+    QSharedPointer<IP>               m_destinationIP;
+
+    inline static bool                s_ecnEnabled               = false;
+    inline static int                 s_receiveBufferSize        = TCPReceiver::DEFAULT_CAPACITY;
+    inline static CongestionAlgorithm s_defaultCongestionControl = CongestionAlgorithm::Reno;
 };
 
 #endif    // PC_H
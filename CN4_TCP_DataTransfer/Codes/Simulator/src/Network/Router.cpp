@@ -4,6 +4,8 @@
 #include "../MACAddress/MACADdressGenerator.h"
 #include "../MetricsCollector/MetricsCollector.h"
 #include "../Network/PC.h"
+#include "../Packet/ControlMessage.h"
+#include "../Packet/PacketPool.h"
 #include "../Topology/TopologyBuilder.h"
 #include "EventsCoordinator/EventsCoordinator.h"
 
@@ -12,16 +14,34 @@
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
+#include <QHash>
 #include <QTextStream>
 #include <QThread>
 
+#include <array>
+
+namespace
+{
+
+/** Appends @p entry to a route advertisement, carrying its wildcard and IPv6-mapped markers. */
+void
+addRouteRecord(ControlMessageWriter &update, const RouteEntry &entry, int metric)
+{
+    quint16 flags = 0;
+    if(entry.flags & RouteEntry::FLAG_WILDCARD_HOST) flags |= ControlRecord::FLAG_WILDCARD_HOST;
+    if(entry.flags & RouteEntry::FLAG_MAPPED_PREFIX) flags |= ControlRecord::FLAG_IPV4_MAPPED_IPV6;
+
+    update.addRecord(entry.prefix, entry.length, static_cast<quint8>(qBound(0, metric, 255)), flags);
+}
+
+}    // namespace
+
 Router::Router(int id, const QString &ipAddress, int portCount, QObject *parent, bool isBroken) :
     Node(id, ipAddress, NodeType::Router, parent),
     m_portCount(portCount),
     m_hasValidIP(false),
-    m_lsdb(),
     m_lsaSequenceNumber(0),
-    m_bufferSize(60),
+    m_buffer(std::make_unique<MpscRing<BufferedPacket>>(s_defaultBufferSize)),
     m_bufferRetentionTime(1'000),
     m_lastRIPUpdateTime(0),
     m_currentTime(0),
@@ -36,38 +56,20 @@ Router::Router(int id, const QString &ipAddress, int portCount, QObject *parent,
 
     initializePorts();
 
-    m_helloTimer = new QTimer(this);
-    connect(m_helloTimer, &QTimer::timeout, this, &Router::sendOSPFHello);
-
-    m_lsaTimer = new QTimer(this);
-    connect(m_lsaTimer, &QTimer::timeout, this, &Router::sendLSA);
-
-    for(auto &port : m_ports)
-    {
-        connect(port.data(), &Port::packetReceived, this, [this, port](const PacketPtr_t &packet) {
-            if(m_workingWithDataPackets)
-                return receiveDataPacket(packet);
-            else
-                return processPacket(packet, port);
-        });
-    }
-
-    m_bufferTimer = new QTimer(this);
-    connect(m_bufferTimer, &QTimer::timeout, this, &Router::processBuffer);
-    m_bufferTimer->start(1'000);
-
     QSharedPointer<MACAddressGenerator> generator = QSharedPointer<MACAddressGenerator>::create();
     m_macAddress                                  = generator->generate();
 
     qDebug() << "Router initialized: ID =" << m_id << ", IP =" << m_ipAddress->getIp()
              << ", Ports =" << m_portCount;
-
-    auto eventsCoordinator = EventsCoordinator::instance();
-    connect(eventsCoordinator, &EventsCoordinator::nextTickForPCs, this, &Router::onNextTickForPCs);
 }
 
 Router::~Router()
 {
+    for(int origin = 0; origin < static_cast<int>(m_lsaSequences.size()); ++origin)
+    {
+        if(hasLSA(origin)) LinkStateDatabase::instance().release(origin, m_lsaSequences[origin]);
+    }
+
     qDebug() << "Router destroyed: ID =" << m_id;
 }
 
@@ -79,6 +81,7 @@ Router::initializePorts()
         auto port = PortPtr_t::create(this);
         port->setPortNumber(static_cast<uint8_t>(i + 1));
         port->setRouterIP(m_ipAddress->getIp());
+        port->seedAqm(m_id);
         m_ports.push_back(port);
 
         QSharedPointer<PC> connectedPC = port->getConnectedPC();
@@ -98,6 +101,75 @@ Router::setTopologyBuilder(TopologyBuilder *builder)
 
 TopologyBuilder *Router::s_topologyBuilder = nullptr;
 
+void
+Router::setRipRefreshInterval(int ticks)
+{
+    s_ripRefreshInterval = qBound(1, ticks, 1'000);
+}
+
+void
+Router::setDefaultBufferSize(int packets)
+{
+    s_defaultBufferSize = qMax(1, packets);
+}
+
+void
+Router::setBufferDropPolicy(BufferDropPolicy policy)
+{
+    s_bufferDropPolicy = policy;
+}
+
+void
+Router::setBufferSize(int packets)
+{
+    // Called while the topology is built, before any traffic reaches the router.
+    if(static_cast<size_t>(qMax(1, packets)) == m_buffer->capacity()) return;
+
+    auto           resized = std::make_unique<MpscRing<BufferedPacket>>(qMax(1, packets));
+    BufferedPacket bp;
+    while(m_buffer->tryPop(bp)) resized->tryPush(bp);
+
+    m_buffer = std::move(resized);
+}
+
+ControlLaneStats
+Router::controlStats() const
+{
+    ControlLaneStats stats;
+    stats.received      = m_controlProcessed + m_controlDrops + m_controlQueue.size() + m_controlQueue.drops();
+    stats.processed     = m_controlProcessed;
+    stats.drops         = m_controlDrops + m_controlQueue.drops();
+    stats.highWatermark = m_controlQueue.highWatermark();
+    return stats;
+}
+
+OutputQueueStats
+Router::outputQueueStats() const
+{
+    OutputQueueStats stats;
+    for(const auto &port : m_ports)
+    {
+        const OutputQueue &queue = port->outputQueue();
+        stats.tailDrops += queue.tailDrops();
+        stats.aqmDrops += queue.aqmDrops();
+        stats.ecnMarks += queue.ecnMarks();
+        stats.highWatermark = qMax(stats.highWatermark, queue.highWatermark());
+    }
+
+    return stats;
+}
+
+BufferStats
+Router::bufferStats() const
+{
+    BufferStats stats;
+    stats.capacity      = m_buffer->capacity();
+    stats.occupancy     = m_buffer->size();
+    stats.highWatermark = m_buffer->highWatermark();
+    stats.drops         = m_buffer->drops();
+    return stats;
+}
+
 PortPtr_t
 Router::getAvailablePort()
 {
@@ -132,7 +204,7 @@ Router::initialize()
     startTimers();
 }
 
-int Router::IBGPCounter = 0;
+std::atomic<int> Router::IBGPCounter {0};
 
 void
 Router::sendHelloPackets()
@@ -153,18 +225,37 @@ Router::startTimers()
     // QTimer *timer = new QTimer(this);
     // connect(timer, &QTimer::timeout, this, &Router::sendHelloPackets);
     // timer->start(HELLO_INTERVAL);
+
+    if(m_bufferTimer != TimerService::NO_TIMER) return;
+
+    auto *coordinator = EventsCoordinator::instance();
+    m_bufferTimer     = coordinator->timers()->scheduleEvery(
+      coordinator->toTicks(std::chrono::milliseconds(1'000)), this, [this]() { processBuffer(); });
 }
 
 bool
 Router::enqueuePacketToBuffer(const PacketPtr_t &packet)
 {
-    QMutexLocker locker(&m_bufferMutex);
+    BufferedPacket bp;
+    bp.packet      = packet;
+    bp.enqueueTime = m_now;
+
+    if(s_bufferDropPolicy == BufferDropPolicy::DropHead)
+    {
+        size_t evicted = m_buffer->pushEvicting(bp, [](const BufferedPacket &) {});
+        if(evicted > 0 && m_metricsCollector)
+        {
+            m_metricsCollector->recordPacketDropped(static_cast<int>(evicted));
+        }
+
+        return true;
+    }
 
-    if(m_buffer.size() >= m_bufferSize)
+    if(!m_buffer->tryPush(bp))
     {
 
         qWarning() << "Router" << m_id << ": Buffer full. Dropping packet with dest IP"
-                   << packet->getPath()[1];
+                   << (packet->destinationIP() ? packet->destinationIP()->getIp() : QString());
 
         if(m_metricsCollector)
         {
@@ -174,50 +265,100 @@ Router::enqueuePacketToBuffer(const PacketPtr_t &packet)
         return false;
     }
 
-    BufferedPacket bp;
-    bp.packet      = packet;
-    bp.enqueueTime = QDateTime::currentMSecsSinceEpoch();
-    m_buffer.enqueue(bp);
-    // qDebug() << "Router" << m_id << ": Packet enqueued. Current buffer size:" << m_buffer.size();
+    // qDebug() << "Router" << m_id << ": Packet enqueued. Current buffer size:" << m_buffer->size();
     return true;
 }
 
+int
+Router::enqueuePacketsToBuffer(const QList<PacketPtr_t> &packets)
+{
+    BufferedPacket bp;
+    bp.enqueueTime = m_now;
+
+    int accepted = 0;
+    int dropped  = 0;
+
+    for(const PacketPtr_t &packet : packets)
+    {
+        bp.packet = packet;
+
+        if(s_bufferDropPolicy == BufferDropPolicy::DropHead)
+        {
+            dropped += static_cast<int>(m_buffer->pushEvicting(bp, [](const BufferedPacket &) {}));
+            ++accepted;
+        }
+        else if(m_buffer->tryPush(bp))
+        {
+            ++accepted;
+        }
+        else
+        {
+            ++dropped;
+        }
+    }
+
+    if(dropped > 0)
+    {
+        qWarning() << "Router" << m_id << ": Buffer full. Dropping" << dropped << "packets.";
+
+        if(m_metricsCollector)
+        {
+            m_metricsCollector->recordPacketDropped(dropped);
+        }
+    }
+
+    return accepted;
+}
+
 PacketPtr_t
 Router::dequeuePacketFromBuffer()
 {
-    QMutexLocker locker(&m_bufferMutex);
-
-    if(m_buffer.isEmpty())
+    BufferedPacket bp;
+    if(!m_buffer->tryPop(bp))
     {
         return nullptr;
     }
 
-    BufferedPacket bp = m_buffer.dequeue();
-    // qDebug() << "Router" << m_id << ": Packet dequeued. Current buffer size:" << m_buffer.size();
+    // qDebug() << "Router" << m_id << ": Packet dequeued. Current buffer size:" << m_buffer->size();
     return bp.packet;
 }
 
+QList<PacketPtr_t>
+Router::dequeuePacketsFromBuffer(int count)
+{
+    QList<PacketPtr_t> packets;
+    packets.reserve(qMin(count, static_cast<int>(m_buffer->size())));
+
+    BufferedPacket bp;
+    while(packets.size() < count && m_buffer->tryPop(bp))
+    {
+        packets.append(bp.packet);
+    }
+
+    return packets;
+}
+
 void
 Router::processBuffer()
 {
-    QMutexLocker locker(&m_bufferMutex);
-    qint64       currentTime = QDateTime::currentMSecsSinceEpoch();
-    while(!m_buffer.isEmpty())
+    const SimTime_t retention =
+      EventsCoordinator::instance()->toTicks(std::chrono::milliseconds(m_bufferRetentionTime));
+
+    int expired = 0;
+
+    // Runs between ticks, so no producer can move the head while it is inspected.
+    BufferedPacket        bp;
+    const BufferedPacket *head = m_buffer->peek();
+    while(head && m_now > head->enqueueTime + retention && m_buffer->tryPop(bp))
     {
-        BufferedPacket bp = m_buffer.head();
-        if((currentTime - bp.enqueueTime) > m_bufferRetentionTime)
-        {
-            m_buffer.dequeue();
-            // qWarning() << "Router" << m_id << ": Packet expired and removed from buffer with payload:" << bp.packet->getPayload();
-            if(m_metricsCollector)
-            {
-                m_metricsCollector->recordPacketDropped();
-            }
-        }
-        else
-        {
-            break;
-        }
+        // qWarning() << "Router" << m_id << ": Packet expired and removed from buffer with payload:" << bp.packet->getPayload();
+        ++expired;
+        head = m_buffer->peek();
+    }
+
+    if(expired > 0 && m_metricsCollector)
+    {
+        m_metricsCollector->recordPacketDropped(expired);
     }
 }
 
@@ -231,8 +372,8 @@ Router::forwardPacket(const PacketPtr_t &packet)
         return;
     }
 
-    PacketPtr_t fwdPacket(
-      new Packet(packet->getType(), packet->getPayload(), packet->getTTL() - 1));
+    PacketPtr_t fwdPacket = PacketPool::acquire(packet->controlType(), packet->getType(),
+                                                packet->getPayload(), packet->getTTL() - 1);
 
     for(auto &port : m_ports)
     {
@@ -273,27 +414,30 @@ Router::requestIPFromDHCP()
         return;
     }
 
-    auto packet = QSharedPointer<Packet>::create(PacketType::Control,
-                                                 QString("DHCP_REQUEST:%1").arg(m_id).toUtf8());
-    qDebug() << "Router" << m_id << "created DHCP request with payload:" << packet->getPayload();
+    ControlMessageWriter request(UT::PacketControlType::DHCPRequest, 0, m_id);
+    auto packet = PacketPool::acquire(UT::PacketControlType::DHCPRequest, PacketType::Control,
+                                      request.finish());
+    qDebug() << "Router" << m_id << "created DHCP request.";
 
+    // Handled outside the tick, so nothing else publishes the routes it may install.
     processPacket(packet, nullptr);
+    publishRoutes();
 }
 
 void
-Router::processDHCPResponse(const PacketPtr_t &packet)
+Router::processDHCPResponse(const PacketPtr_t &packet, const PortPtr_t &incomingPort)
 {
+    Q_UNUSED(incomingPort);
+
     if(!packet || packet->getPayload().isEmpty()) return;
 
-    if(packet->getPayload().contains("DHCP_OFFER"))
+    if(packet->controlType() == UT::PacketControlType::DHCPOffer)
     {
-        QString     payload = packet->getPayload();
-        QStringList parts   = payload.split(":");
-
-        if(parts.size() == 3)
+        ControlMessageReader message(packet->getPayload());
+        if(message.recordCount() == 1)
         {
-            QString offeredIP = parts[1];
-            int     clientId  = parts[2].toInt();
+            QString offeredIP = message.recordAddress(0);
+            int     clientId  = static_cast<int>(message.sequence());
 
             if(clientId == m_id)
             {
@@ -328,8 +472,7 @@ Router::processDHCPResponse(const PacketPtr_t &packet)
         }
         else
         {
-            qWarning() << "Malformed DHCP_OFFER packet on Router" << m_id
-                       << "payload:" << packet->getPayload();
+            qWarning() << "Malformed DHCP offer on Router" << m_id;
         }
     }
 }
@@ -376,372 +519,328 @@ Router::processPacket(const PacketPtr_t &packet, const PortPtr_t &incomingPort)
 {
     if(!packet) return;
 
+    const bool isData = packet->getType() == PacketType::Data;
+
+    // Only data losses reach the metrics; control drops are counted on the control lane.
     if(m_isBroken)
     {
-        m_metricsCollector->recordPacketDropped();
+        if(!isData) ++m_controlDrops;
+        else if(m_metricsCollector) m_metricsCollector->recordPacketDropped();
         return;
     }
 
     packet->increamentTotalCycle();
-
-    bool enqueued = enqueuePacketToBuffer(packet);
-
-    // -----> Handle Congestion Using The Boolean Of Enqueue <-----
-
     packet->increamentWaitCycle();
 
-    QString payload = packet->getPayload();
-    // qDebug() << "Router" << m_id << "processing packet with payload:" << payload;
+    const ControlDispatch &dispatch = controlDispatch(packet->controlType());
 
     // Check and handle TTL
     if(packet->getTTL() <= 0)
     {
         qDebug() << "Router" << m_id << "dropping packet due to TTL = 0.";
-        if(m_metricsCollector && !payload.contains("DHCP_REQUEST") &&
-           !payload.contains("DHCP_OFFER") && !payload.startsWith("RIP_UPDATE") &&
-           packet->getType() != PacketType::OSPFHello && packet->getType() != PacketType::OSPFLSA)
+        if(!isData)
         {
-            m_metricsCollector->recordPacketDropped();
+            ++m_controlDrops;
+            return;
         }
-        dequeuePacketFromBuffer();
-        if(m_metricsCollector) m_metricsCollector->recordWaitCycle(packet->getWaitingCycle());
-        return;
-    }
 
-    // Handle DHCP Requests
-    if(payload.contains("DHCP_REQUEST"))
-    {
-        if(isDHCPServer())
-        {
-            if(m_dhcpServer)
-            {
-                m_dhcpServer->receivePacket(packet);
-            }
-        }
-        else
+        if(m_metricsCollector)
         {
-            if(!hasSeenPacket(packet))
-            {
-                markPacketAsSeen(packet);
-                forwardPacket(packet);
-            }
-            else
-            {
-                qDebug() << "Router" << m_id
-                         << "already seen this DHCP request, dropping to prevent loops.";
-            }
+            m_metricsCollector->recordPacketDropped();
+            m_metricsCollector->recordWaitCycle(packet->getWaitingCycle());
         }
+        return;
     }
-    // Handle DHCP Offers
-    else if(payload.contains("DHCP_OFFER"))
-    {
-        QStringList parts = payload.split(":");
-        if(parts.size() == 3)
-        {
-            QString offeredIP = parts[1];
-            int     clientId  = parts[2].toInt();
-
-            if(clientId == m_id)
-            {
-                if(m_hasValidIP)
-                {
-                    qDebug() << "Router" << m_id << "already has a valid IP:" << m_assignedIP;
-                    dequeuePacketFromBuffer();
-                    if(m_metricsCollector)
-                        m_metricsCollector->recordWaitCycle(packet->getWaitingCycle());
-                    return;
-                }
-                qDebug() << "Router" << m_id << "received DHCP offer:" << offeredIP
-                         << "for itself. Assigning IP.";
-                m_assignedIP = offeredIP;
-                m_ipAddress->setIp(m_assignedIP);
-                m_hasValidIP = true;
-                qDebug() << "Router" << m_id << "received and assigned IP:" << m_assignedIP;
 
-                addDirectRoute(m_assignedIP, "255.255.255.255");
-                qDebug() << "Router" << m_id << "added direct route for its own IP.";
-            }
-            else
-            {
-                if(!hasSeenPacket(packet))
-                {
-                    markPacketAsSeen(packet);
-                    forwardPacket(packet);
-                }
-                else
-                {
-                    qDebug() << "Router" << m_id
-                             << "already seen this DHCP offer, dropping to prevent loops.";
-                }
-            }
-        }
-        else
-        {
-            qWarning() << "Malformed DHCP_OFFER packet on Router" << m_id << "payload:" << payload;
-        }
+    if(isData)
+    {
+        handleDataPacket(packet, incomingPort);
     }
-    // Handle RIP Updates
-    else if(payload.startsWith("RIP_UPDATE"))
+    else if(dispatch.handler)
     {
-        processRIPUpdate(packet);
+        (this->*dispatch.handler)(packet, incomingPort);
     }
-    // Handle EBGP Updates
-    else if(payload.startsWith("EBGP_UPDATE"))
+    else
     {
-        processEBGPUpdate(packet);
+        // An opcode nobody handles is a control drop; the metrics collector only counts data loss.
+        qDebug() << "Router" << m_id << "received unknown/unsupported packet of type"
+                 << static_cast<int>(packet->getType()) << "Dropping it.";
+        ++m_controlDrops;
+        return;
     }
-    // Handle IBGP Updates
-    else if(payload.startsWith("IBGP_UPDATE"))
+
+    if(!isData)
     {
-        processIBGPUpdate(packet);
+        ++m_controlProcessed;
+        return;
     }
-    // Handle OSPF Updates
-    else if(packet->getType() == PacketType::OSPFHello)
+
+    if(m_metricsCollector) m_metricsCollector->recordWaitCycle(packet->getWaitingCycle());
+}
+
+const Router::ControlDispatch &
+Router::controlDispatch(UT::PacketControlType controlType)
+{
+    // Indexed by opcode.
+    static const std::array<ControlDispatch, static_cast<size_t>(UT::PacketControlType::Count)>
+      table = []() {
+          std::array<ControlDispatch, static_cast<size_t>(UT::PacketControlType::Count)> t {};
+          auto set = [&t](UT::PacketControlType type, ControlHandler handler) {
+              t[static_cast<size_t>(type)] = {handler};
+          };
+
+          set(UT::PacketControlType::DHCPRequest, &Router::handleDHCPRequest);
+          set(UT::PacketControlType::DHCPOffer, &Router::processDHCPResponse);
+          set(UT::PacketControlType::RIP, &Router::processRIPUpdate);
+          set(UT::PacketControlType::OSPF, &Router::processOSPFHello);
+          set(UT::PacketControlType::OSPFLSA, &Router::processLSA);
+          set(UT::PacketControlType::EBGP, &Router::processEBGPUpdate);
+          set(UT::PacketControlType::IBGP, &Router::processIBGPUpdate);
+          return t;
+      }();
+
+    size_t index = static_cast<size_t>(controlType);
+    return table[index < table.size() ? index : 0];
+}
+
+void
+Router::handleDHCPRequest(const PacketPtr_t &packet, const PortPtr_t &incomingPort)
+{
+    Q_UNUSED(incomingPort);
+
+    if(isDHCPServer())
     {
-        processOSPFHello(packet);
+        if(m_dhcpServer)
+        {
+            m_dhcpServer->receivePacket(packet);
+        }
     }
-    // Handle OSPF LSA Packets
-    else if(packet->getType() == PacketType::OSPFLSA)
+    else
     {
-        processLSA(packet, incomingPort);
+        if(!hasSeenPacket(packet))
+        {
+            markPacketAsSeen(packet);
+            forwardPacket(packet);
+        }
+        else
+        {
+            qDebug() << "Router" << m_id
+                     << "already seen this DHCP request, dropping to prevent loops.";
+        }
     }
-    // Handle Data Packets
-    else if(packet->getType() == PacketType::Data)
+}
+
+void
+Router::handleDataPacket(const PacketPtr_t &packet, const PortPtr_t &incomingPort)
+{
+    Q_UNUSED(incomingPort);
+
+    QString     payload = packet->getPayload();
+    QStringList parts   = payload.split(":");
+    if(parts.size() >= 3 && parts.at(0) == "Data")
     {
-        QStringList parts = payload.split(":");
-        if(parts.size() >= 3 && parts.at(0) == "Data")
+        QString destinationIP = parts.at(1);
+        QString actualPayload = parts.at(2);
+
+        if(destinationIP == m_ipAddress->getIp())
         {
-            QString destinationIP = parts.at(1);
-            QString actualPayload = parts.at(2);
+            qDebug() << "Router" << m_id << "received packet intended for itself.";
 
-            if(destinationIP == m_ipAddress->getIp())
+            if(m_metricsCollector)
             {
-                qDebug() << "Router" << m_id << "received packet intended for itself.";
+                m_metricsCollector->recordPacketReceived(packet->path());
+            }
 
+            // qDebug() << "Router" << m_id << "processing payload:" << actualPayload;
+        }
+        else
+        {
+            RouteEntry bestRoute = findBestRoutePath(destinationIP);
+            if(bestRoute.isNull())
+            {
+                qDebug() << "Router" << m_id
+                         << "has no route to destination IP:" << destinationIP
+                         << ". Dropping packet.";
                 if(m_metricsCollector)
                 {
-                    m_metricsCollector->recordPacketReceived(packet->getPath());
+                    m_metricsCollector->recordPacketDropped();
                 }
-
-                // qDebug() << "Router" << m_id << "processing payload:" << actualPayload;
+                return;
             }
-            else
-            {
-                RouteEntry bestRoute = findBestRoutePath(destinationIP);
-                if(bestRoute.destination.isEmpty())
-                {
-                    qDebug() << "Router" << m_id
-                             << "has no route to destination IP:" << destinationIP
-                             << ". Dropping packet.";
-                    if(m_metricsCollector)
-                    {
-                        m_metricsCollector->recordPacketDropped();
-                    }
-                    dequeuePacketFromBuffer();
-                    if(m_metricsCollector)
-                        m_metricsCollector->recordWaitCycle(packet->getWaitingCycle());
-                    return;
-                }
-
-                if(bestRoute.destination == bestRoute.nextHop)
-                {
-                    qDebug() << "Router" << m_id << "received packet intended for its PC.";
-
-                    if(m_metricsCollector)
-                    {
-                        m_metricsCollector->increamentHops();
-                        m_metricsCollector->recordPacketReceived(packet->getPath());
-                        m_metricsCollector->increamentHops();
-                    }
 
-                    packet->addToPathTaken(bestRoute.destination);
-                    // qDebug() << "PC" << destinationIP << "processing payload:" << actualPayload;
-                    // qDebug() << "Packet with source" << packet->getPath()[0] << "with destination" << packet->getPath()[1]
-                    //          << "with total wait cycle" << packet->getWaitingCycle() << "and it's total cycle is"
-                    //          << packet->getTotalCycle() << "and it's path taken is" << packet->getPathTaken();
-                    dequeuePacketFromBuffer();
-                    if(m_metricsCollector)
-                        m_metricsCollector->recordWaitCycle(packet->getWaitingCycle());
-                    return;
-                }
+            if(bestRoute.prefix == bestRoute.nextHop)
+            {
+                qDebug() << "Router" << m_id << "received packet intended for its PC.";
 
-                packet->decrementTTL();
-                if(packet->getTTL() <= 0)
+                if(m_metricsCollector)
                 {
-                    qDebug() << "Router" << m_id
-                             << "dropping packet due to TTL = 0 after decrement.";
-                    if(m_metricsCollector)
-                    {
-                        m_metricsCollector->recordPacketDropped();
-                    }
-                    dequeuePacketFromBuffer();
-                    if(m_metricsCollector)
-                        m_metricsCollector->recordWaitCycle(packet->getWaitingCycle());
-                    return;
+                    m_metricsCollector->increamentHops();
+                    m_metricsCollector->recordPacketReceived(packet->path());
+                    m_metricsCollector->increamentHops();
                 }
 
-                packet->addToPath(m_ipAddress->getIp());
+                if(packet->isRecordingPath()) packet->addToPathTaken(bestRoute.destination());
+                // qDebug() << "PC" << destinationIP << "processing payload:" << actualPayload;
+                // qDebug() << "Packet with source" << packet->getPath()[0] << "with destination" << packet->getPath()[1]
+                //          << "with total wait cycle" << packet->getWaitingCycle() << "and it's total cycle is"
+                //          << packet->getTotalCycle() << "and it's path taken is" << packet->getPathTaken();
+                return;
+            }
 
+            packet->decrementTTL();
+            if(packet->getTTL() <= 0)
+            {
+                qDebug() << "Router" << m_id
+                         << "dropping packet due to TTL = 0 after decrement.";
                 if(m_metricsCollector)
                 {
-                    m_metricsCollector->recordRouterUsage(m_ipAddress->getIp());
+                    m_metricsCollector->recordPacketDropped();
                 }
+                return;
+            }
 
-                PortPtr_t outPort = bestRoute.learnedFromPort;
-                if(outPort && outPort->isConnected())
-                {
-                    if(m_metricsCollector)
-                    {
-                        m_metricsCollector->increamentHops();
-                    }
-                    packet->addToPathTaken(bestRoute.nextHop);
-                    outPort->sendPacket(packet);
-                    // qDebug() << "Router" << m_id << "forwarded packet to next hop via Port" << outPort->getPortNumber();
-                }
-                else
+            packet->addToPath(pathIndex());
+
+            if(m_metricsCollector)
+            {
+                m_metricsCollector->recordRouterUsage(m_ipAddress->getIp());
+            }
+
+            PortPtr_t outPort = portAt(bestRoute.portIndex);
+            if(outPort && outPort->isConnected())
+            {
+                if(m_metricsCollector)
                 {
-                    qDebug()
-                      << "Router" << m_id
-                      << "has no valid outgoing port to forward the packet. Dropping packet.";
-                    if(m_metricsCollector)
-                    {
-                        m_metricsCollector->recordPacketDropped();
-                    }
+                    m_metricsCollector->increamentHops();
                 }
+                if(packet->isRecordingPath()) packet->addToPathTaken(bestRoute.nextHopAddress());
+                outPort->sendPacket(packet);
+                // qDebug() << "Router" << m_id << "forwarded packet to next hop via Port" << outPort->getPortNumber();
             }
-        }
-        else
-        {
-            qWarning() << "Malformed Data packet on Router" << m_id << "payload:" << payload;
-            if(m_metricsCollector)
+            else
             {
-                m_metricsCollector->recordPacketDropped();
+                qDebug()
+                  << "Router" << m_id
+                  << "has no valid outgoing port to forward the packet. Dropping packet.";
+                if(m_metricsCollector)
+                {
+                    m_metricsCollector->recordPacketDropped();
+                }
             }
         }
     }
     else
     {
-        qDebug() << "Router" << m_id << "received unknown/unsupported packet:" << payload
-                 << "Dropping it.";
+        qWarning() << "Malformed Data packet on Router" << m_id << "payload:" << payload;
         if(m_metricsCollector)
         {
             m_metricsCollector->recordPacketDropped();
         }
     }
-
-    if(enqueued) PacketPtr_t nextPacket = dequeuePacketFromBuffer();
-
-    if(m_metricsCollector) m_metricsCollector->recordWaitCycle(packet->getWaitingCycle());
 }
 
 void
 Router::addRoute(const QString &destination, const QString &mask, const QString &nextHop,
                  int metric, RoutingProtocol protocol, PortPtr_t learnedFromPort, bool vip)
 {
-    // qDebug() << "Router" << m_id << "addRoute called with:" << destination << mask << nextHop << metric;
+    addRoute(RouteEntry::fromStrings(destination, mask, nextHop), metric, protocol,
+             portIndexOf(learnedFromPort), vip);
+}
+
+void
+Router::addRoute(RouteEntry route, int metric, RoutingProtocol protocol, int portIndex, bool vip)
+{
+    // qDebug() << "Router" << m_id << "addRoute called with:" << route.destination() << route.mask() << metric;
 
-    for(auto &entry : m_routingTable)
+    if(!vip && m_routingTable.find(route.prefix, route.length, true))
     {
-        if(!vip)
-        {
-            if(entry.isDirect && entry.destination == destination && entry.mask == mask)
-            {
-                qDebug() << "Router" << m_id << ": Ignoring learned route to" << destination
-                         << "due to direct route.";
-                IBGPCounter += 1;
-                return;
-            }
-        }
+        qDebug() << "Router" << m_id << ": Ignoring learned route to" << route.destination()
+                 << "due to direct route.";
+        IBGPCounter += 1;
+        return;
     }
 
-    int  newInvalidTimer = RIP_INVALID_TIMER;
-    bool found           = false;
+    const int invalidAfter = ripTimer(RIP_INVALID_REFRESHES);
 
-    for(auto &entry : m_routingTable)
+    if(RouteEntry *entry = m_routingTable.find(route.prefix, route.length, false))
     {
-        if(entry.destination == destination && entry.mask == mask && !entry.isDirect)
+        if(entry->timer == RouteTimer::HoldDown && metric >= entry->metric)
         {
-
-            if(entry.holdDownTimer > 0 && metric >= entry.metric)
-            {
-                // qDebug() << "Router" << m_id << ": hold-down active for" << destination << ", ignoring equal or worse route.";
-                IBGPCounter += 1;
-                return;
-            }
-
-            if(metric < entry.metric)
-            {
-                // qDebug() << "Router" << m_id << "updated route to" << destination << "with better metric" << metric;
-                entry.nextHop         = nextHop;
-                entry.metric          = metric;
-                entry.protocol        = protocol;
-                entry.lastUpdateTime  = m_currentTime;
-                entry.learnedFromPort = learnedFromPort;
-                entry.invalidTimer    = newInvalidTimer;
-                entry.holdDownTimer   = 0;
-                entry.flushTimer      = 0;
-            }
-            else
-            {
-                // qDebug() << "Router" << m_id << ": got equal or worse metric (" << metric << ") for" << destination << ", ignoring update.";
-            }
+            // qDebug() << "Router" << m_id << ": hold-down active for" << route.destination() << ", ignoring equal or worse route.";
             IBGPCounter += 1;
             return;
         }
-    }
 
-    if(!found)
-    {
-        RouteEntry newEntry(destination, mask, nextHop, metric, protocol, m_currentTime,
-                            learnedFromPort, false);
-        newEntry.invalidTimer = newInvalidTimer;
-        // qDebug() << "Router" << m_id << "added new learned route to" << destination << "metric" << metric;
-        m_routingTable.append(newEntry);
-        emit routingTableUpdated(m_id);
-        IBGPCounter = 0;
+        if(entry->nextHop == route.nextHop && metric == entry->metric)
+        {
+            // The route we already use, confirmed: only its timers move.
+            entry->lastUpdateTime = static_cast<qint32>(m_currentTime);
+            setRouteTimer(*entry, RouteTimer::Invalid, invalidAfter);
+        }
+        else if(metric < entry->metric || entry->nextHop == route.nextHop)
+        {
+            // qDebug() << "Router" << m_id << "updated route to" << route.destination() << "with better metric" << metric;
+            entry->nextHop        = route.nextHop;
+            entry->flags          = (entry->flags & ~RouteEntry::FLAG_MAPPED_NEXT_HOP) |
+                                    (route.flags & RouteEntry::FLAG_MAPPED_NEXT_HOP);
+            entry->metric         = static_cast<qint16>(metric);
+            entry->protocol       = protocol;
+            entry->lastUpdateTime = static_cast<qint32>(m_currentTime);
+            entry->portIndex      = static_cast<qint16>(portIndex);
+            setRouteTimer(*entry, RouteTimer::Invalid, invalidAfter);
+            markRoutesChanged();
+        }
+        else
+        {
+            // qDebug() << "Router" << m_id << ": got equal or worse metric (" << metric << ") for" << route.destination() << ", ignoring update.";
+        }
+        IBGPCounter += 1;
+        return;
     }
+
+    route.metric          = static_cast<qint16>(metric);
+    route.protocol        = protocol;
+    route.lastUpdateTime  = static_cast<qint32>(m_currentTime);
+    route.portIndex       = static_cast<qint16>(portIndex);
+    route.flags          &= ~(RouteEntry::FLAG_DIRECT | RouteEntry::FLAG_VIP);
+    route.timerId         = TimingWheel::NO_TIMER;
+    route.timer           = RouteTimer::None;
+    // qDebug() << "Router" << m_id << "added new learned route to" << route.destination() << "metric" << metric;
+    setRouteTimer(m_routingTable.insert(route), RouteTimer::Invalid, invalidAfter);
+    markRoutesChanged();
+    emit routingTableUpdated(m_id);
+    IBGPCounter = 0;
 }
 
 RouteEntry
 Router::findBestRoutePath(const QString &destinationIP) const
 {
-    RouteEntry bestRoute;
-    int        minMetric = RIP_INFINITY;
-    QString    bgpDest   = " III ";
+    return findBestRoutePath(ControlAddress::fromString(destinationIP));
+}
 
-    if(m_ASnum != -1) bgpDest = (m_ASnum == 1) ? "192.168.200.xx" : "192.168.100.xx";
+RouteEntry
+Router::findBestRoutePath(quint32 destination) const
+{
+    EpochReclaimer::ReadGuard guard;
 
-    QString bgpPrefix;
-    if(bgpDest.endsWith(".xx"))
-    {
-        bgpPrefix = bgpDest.left(bgpDest.length() - 3);
-    }
-    else
-    {
-        bgpPrefix = bgpDest;
-    }
+    const ForwardingSnapshot *fib = m_fib.load();
+    return fib ? fib->lookup(destination) : RouteEntry();
+}
 
-    for(const auto &route : m_routingTable)
-    {
-        if(destinationIP == route.destination)
-        {
-            if(route.metric < minMetric)
-            {
-                minMetric = route.metric;
-                bestRoute = route;
-            }
-        }
-        else if(route.destination == bgpDest)
-        {
-            if(destinationIP.startsWith(bgpPrefix + "."))
-            {
-                minMetric = route.metric;
-                bestRoute = route;
-            }
-        }
-    }
+void
+Router::markRoutesChanged()
+{
+    m_fibDirty = true;
+    ++m_routesVersion;
+}
+
+void
+Router::publishRoutes()
+{
+    if(!m_fibDirty) return;
 
-    return bestRoute;
+    m_fib.publish(m_routingTable.compile(RIP_INFINITY));
+    m_fibDirty = false;
 }
 
 void
@@ -806,8 +905,8 @@ Router::printRoutingTable() const
         }
 
         QString logEntry;
-        QTextStream(&logEntry) << "Dest: " << entry.destination << " Mask: " << entry.mask
-                               << " NextHop: " << entry.nextHop << " Metric: " << entry.metric
+        QTextStream(&logEntry) << "Dest: " << entry.destination() << " Mask: " << entry.mask()
+                               << " NextHop: " << entry.nextHopAddress() << " Metric: " << entry.metric
                                << " Protocol: " << protoStr;
 
         qDebug() << logEntry;
@@ -822,24 +921,102 @@ Router::printRoutingTable() const
 void
 Router::enableRIP()
 {
-    connect(EventsCoordinator::instance(), &EventsCoordinator::tick, this, &Router::onTick);
+    m_ripEnabled = true;
     qDebug() << "RIP enabled on Router" << m_id;
 }
 
+quint64
+Router::receivePhase(const TickContext &context)
+{
+    m_now = context.now;
+
+    quint64 received = 0;
+    for(const auto &port : m_ports)
+    {
+        received += port->drainIngress([this, &port](const QList<PacketPtr_t> &burst) {
+            if(!m_workingWithDataPackets)
+            {
+                for(const auto &packet : burst)
+                {
+                    if(packet->getType() != PacketType::Data) enqueueControlPacket(packet, port);
+                    else processPacket(packet, port);
+                }
+                return;
+            }
+
+            m_dataBurst.clear();
+            for(const auto &packet : burst)
+            {
+                if(packet->getType() != PacketType::Data) enqueueControlPacket(packet, port);
+                else m_dataBurst.append(packet);
+            }
+
+            if(!m_dataBurst.isEmpty()) receiveDataPacket(m_dataBurst);
+        });
+    }
+
+    return received;
+}
+
+quint64
+Router::routePhase(const TickContext &context)
+{
+    m_now = context.now;
+
+    // Control traffic first, so routing reconverges whatever the data load.
+    processControlQueue();
+
+    if(context.routingTick)
+    {
+        if(m_ripEnabled) onTick();
+        if(m_ospfEnabled) handleLSAExpiration();
+        if(m_spfThrottle.isDue(m_now)) runDijkstra();
+    }
+
+    // Routes installed since the last publish, including those set up before the simulation
+    // started, become visible to the data path here at the latest.
+    publishRoutes();
+
+    if(context.dataTick)
+    {
+        onNextTickForPCs();
+    }
+
+    return 0;
+}
+
+quint64
+Router::transmitPhase(const TickContext &context)
+{
+    Q_UNUSED(context)
+
+    quint64 sent = 0;
+    for(const auto &port : m_ports)
+    {
+        sent += port->flush();
+    }
+
+    return sent;
+}
+
 void
 Router::onTick()
 {
     m_currentTime++;
     // qDebug() << "Router" << m_id << "tick:" << m_currentTime;
 
-    if(m_currentTime - m_lastRIPUpdateTime >= RIP_UPDATE_INTERVAL)
+    handleRouteTimeouts();
+
+    if(m_currentTime - m_lastRIPUpdateTime >= s_ripRefreshInterval)
     {
         // qDebug() << "Router" << m_id << "sending RIP update at time:" << m_currentTime;
-        sendRIPUpdate();
+        sendRIPUpdate(true);
         m_lastRIPUpdateTime = m_currentTime;
     }
-
-    handleRouteTimeouts();
+    else if(m_routesVersion != m_ripAdvertisedVersion)
+    {
+        sendRIPUpdate(false);
+    }
 }
 
 void
@@ -848,7 +1025,7 @@ Router::onNextTickForPCs()
     // start process packets at thread pool
     // qInfo() << "Router" << m_id << "processing packets at onNextTickForPCs";
 
-    static bool   benchmarkTaken = false;
+    static std::atomic<bool> benchmarkTaken {false};
 
     QElapsedTimer timer;
 
@@ -859,30 +1036,60 @@ Router::onNextTickForPCs()
         timer.start();
     }
 
-    for(size_t i = 0; i < 6; i++)
-    {
-        auto packet = dequeuePacketFromBuffer();
+    // Everything buffered is forwarded into the output queues; how fast each link drains is up to
+    // its port's service rate, so a congested port no longer holds back the others.
+    QList<PacketPtr_t> packets = dequeuePacketsFromBuffer(static_cast<int>(m_buffer->capacity()));
+    processDataPackets(packets);
 
-        processDataPacket(packet);
+    // Packets CoDel drops on their way out are data losses too.
+    int aqmDrops = 0;
+    for(const auto &port : m_ports)
+    {
+        quint64 dropped = port->outputQueue().drops();
+        port->serviceOutput(m_now);
+        aqmDrops += static_cast<int>(port->outputQueue().drops() - dropped);
     }
 
+    if(aqmDrops > 0 && m_metricsCollector) m_metricsCollector->recordPacketDropped(aqmDrops);
+
     if(!benchmarkTaken)
     {
-        qDebug() << "Router" << m_id << "6 Packet Processing Time:" << timer.elapsed() << "ms";
+        qDebug() << "Router" << m_id << packets.size() << "Packet Processing Time:" << timer.elapsed() << "ms";
         benchmarkTaken = true;
     }
 }
 
 void
-Router::receiveDataPacket(const QList<PacketPtr_t> &packets)
+Router::enqueueControlPacket(const PacketPtr_t &packet, const PortPtr_t &port)
 {
-    // add packets to buffer
-    for(const auto &packet : packets)
+    if(!m_controlQueue.tryPush({packet, port}))
     {
-        enqueuePacketToBuffer(packet);
+        qWarning() << "Router" << m_id << ": Control queue full. Dropping"
+                   << static_cast<int>(packet->controlType()) << "packet.";
     }
 }
 
+quint64
+Router::processControlQueue()
+{
+    quint64             processed = 0;
+    QueuedControlPacket queued;
+
+    while(m_controlQueue.tryPop(queued))
+    {
+        processPacket(queued.packet, queued.port);
+        ++processed;
+    }
+
+    return processed;
+}
+
+void
+Router::receiveDataPacket(const QList<PacketPtr_t> &packets)
+{
+    enqueuePacketsToBuffer(packets);
+}
+
 void
 Router::receiveDataPacket(const PacketPtr_t &packet)
 {
@@ -890,20 +1097,57 @@ Router::receiveDataPacket(const PacketPtr_t &packet)
 }
 
 void
-Router::sendToPC(const PacketPtr_t &packet, const QSharedPointer<PC> &pc)
+Router::processDataPacket(const PacketPtr_t &packet)
 {
-    pc->processDataPacket(packet);
+    processDataPackets({packet});
 }
 
 void
-Router::processDataPacket(const PacketPtr_t &packet)
+Router::processDataPackets(const QList<PacketPtr_t> &packets)
+{
+    for(const PacketPtr_t &packet : packets)
+    {
+        routeDataPacket(packet);
+    }
+
+    if(m_metricsCollector)
+    {
+        if(m_burstRouterUsage > 0) m_metricsCollector->recordRouterUsage(m_ipAddress->getIp(), m_burstRouterUsage);
+        if(m_burstHops > 0) m_metricsCollector->increamentHops(m_burstHops);
+        if(m_burstQueueDrops > 0) m_metricsCollector->recordPacketDropped(m_burstQueueDrops);
+    }
+
+    m_burstRouterUsage = 0;
+    m_burstHops        = 0;
+    m_burstQueueDrops  = 0;
+}
+
+int
+Router::portIndexOf(const PortPtr_t &port) const
+{
+    for(size_t i = 0; i < m_ports.size(); ++i)
+    {
+        if(m_ports[i] == port) return static_cast<int>(i);
+    }
+
+    return -1;
+}
+
+PortPtr_t
+Router::portAt(int index) const
+{
+    return index >= 0 && index < static_cast<int>(m_ports.size()) ? m_ports[index] : nullptr;
+}
+
+void
+Router::routeDataPacket(const PacketPtr_t &packet)
 {
     // process packet and find out going port
     if(!packet) return;
 
     if(m_isBroken)
     {
-        m_metricsCollector->recordPacketDropped();
+        if(m_metricsCollector) m_metricsCollector->recordPacketDropped();
         return;
     }
 
@@ -919,11 +1163,11 @@ Router::processDataPacket(const PacketPtr_t &packet)
     {
         qDebug() << "Router" << m_id << "dropping packet due to TTL = 0.";
 
-        m_metricsCollector->recordPacketDropped();
-
-        dequeuePacketFromBuffer();
-
-        if(m_metricsCollector) m_metricsCollector->recordWaitCycle(packet->getWaitingCycle());
+        if(m_metricsCollector)
+        {
+            m_metricsCollector->recordPacketDropped();
+            m_metricsCollector->recordWaitCycle(packet->getWaitingCycle());
+        }
 
         return;
     }
@@ -950,7 +1194,7 @@ Router::processDataPacket(const PacketPtr_t &packet)
         {
             RouteEntry bestRoute = findBestRoutePath(destinationIP);
 
-            if(bestRoute.destination.isEmpty())
+            if(bestRoute.isNull())
             {
 
                 qDebug() << "Router" << m_id << "has no route to destination IP:" << destinationIP
@@ -959,12 +1203,8 @@ Router::processDataPacket(const PacketPtr_t &packet)
                 if(m_metricsCollector)
                 {
                     m_metricsCollector->recordPacketDropped();
-                }
-
-                dequeuePacketFromBuffer();
-
-                if(m_metricsCollector)
                     m_metricsCollector->recordWaitCycle(packet->getWaitingCycle());
+                }
 
                 return;
             }
@@ -983,10 +1223,10 @@ Router::processDataPacket(const PacketPtr_t &packet)
              * ==========================================================
              * ==========================================================
              **/
-            if(bestRoute.destination == bestRoute.nextHop)
+            if(bestRoute.prefix == bestRoute.nextHop)
             {
-                // qDebug() << "Router:" << m_id << "bestRoute.destination:" << bestRoute.destination
-                //          << "bestRoute.nextHop:" << bestRoute.nextHop;
+                // qDebug() << "Router:" << m_id << "bestRoute.destination:" << bestRoute.destination()
+                //          << "bestRoute.nextHop:" << bestRoute.nextHopAddress();
 
                 for(auto &port : m_ports)
                 {
@@ -1001,9 +1241,17 @@ Router::processDataPacket(const PacketPtr_t &packet)
                                 // qInfo() << Q_FUNC_INFO
                                 //         << "Sending Packet to PC. PC_IP:" << pc->getIpAddress()
                                 //         << "Destination_IP:" << destinationIP
-                                //         << "Route Destination:" << bestRoute.destination;
+                                //         << "Route Destination:" << bestRoute.destination();
 
-                                return sendToPC(packet, pc);
+                                // The access link queues like any other: flows converging on one
+                                // PC back up, get marked and get dropped here. The PC takes the
+                                // packet off the link in its own receive phase.
+                                packet->addToPath(pathIndex());
+                                ++m_burstRouterUsage;
+                                ++m_burstHops;
+
+                                if(!port->enqueueOutput(packet, m_now)) ++m_burstQueueDrops;
+                                return;
                             }
                         }
                     }
@@ -1021,33 +1269,32 @@ Router::processDataPacket(const PacketPtr_t &packet)
                 return;
             }
 
-            packet->addToPath(m_ipAddress->getIp());
+            int       portIndex = bestRoute.portIndex;
+            PortPtr_t outPort   = portAt(portIndex);
 
-            if(m_metricsCollector)
-            {
-                m_metricsCollector->recordRouterUsage(m_ipAddress->getIp());
-            }
+            packet->addToPath(pathIndex());
+
+            ++m_burstRouterUsage;
 
-            PortPtr_t outPort = bestRoute.learnedFromPort;
+            // portAt() is null for an index out of range, e.g. a stale FIB entry after the ports
+            // changed; that is a drop like any other missing port.
             if(outPort && outPort->isConnected())
             {
-                if(m_metricsCollector)
-                {
-                    m_metricsCollector->increamentHops();
-                }
+                ++m_burstHops;
 
-                packet->addToPathTaken(bestRoute.nextHop);
+                if(packet->isRecordingPath()) packet->addToPathTaken(bestRoute.nextHopAddress());
 
                 // qInfo() << "Router" << m_id << "forwarded packet to next hop via Port"
                 //         << outPort->getPortNumber() << "while destination is:" << destinationIP;
 
                 // qDebug() << "Router:" << m_id
-                //          << "Leared from port:" << bestRoute.learnedFromPort->getPortNumber();
+                //          << "Leared from port:" << outPort->getPortNumber();
 
-                outPort->sendPacket(packet);
+                // A full output queue drops the packet (drop-tail), counted once per burst.
+                if(!outPort->enqueueOutput(packet, m_now)) ++m_burstQueueDrops;
                 // qDebug() << "Router" << m_id << "forwarded packet to next hop via Port"
                 //          << outPort->getPortNumber() << "while destination is:" << destinationIP
-                //          << "And bestRoute.nextHop is:" << bestRoute.nextHop;
+                //          << "And bestRoute.nextHop is:" << bestRoute.nextHopAddress();
             }
             else
             {
@@ -1084,8 +1331,15 @@ Router::processDataPacket(const PacketPtr_t &packet)
 }
 
 void
-Router::sendRIPUpdate()
+Router::sendRIPUpdate(bool fullRefresh)
 {
+    const quint32 originAddress = ControlAddress::fromString(m_ipAddress->getIp());
+
+    m_ripAdvertisedVersion = m_routesVersion;
+    const int routeCount   = fullRefresh ? m_ripAdvertiser.encodeTable(m_routingTable, originAddress)
+                                         : m_ripAdvertiser.encodeChanges(m_routingTable, originAddress);
+    if(routeCount == 0) return;
+
     for(auto &port : m_ports)
     {
         if(m_ASnum != -1)
@@ -1102,163 +1356,147 @@ Router::sendRIPUpdate()
 
         if(!port->isConnected()) continue;
 
-        QString payload    = "RIP_UPDATE:";
-        int     routeCount = 0;
-        for(const auto &entry : m_routingTable)
-        {
-            int advertisedMetric = entry.metric;
-            if(entry.learnedFromPort == port && !entry.isDirect)
-            {
-                advertisedMetric = RIP_INFINITY;
-            }
-            payload +=
-              entry.destination + "," + entry.mask + "," + QString::number(advertisedMetric) + "#";
-            routeCount++;
-        }
-
-        payload += m_ipAddress->getIp();
-        if(routeCount == 0)
-        {
-            payload = "RIP_UPDATE:" + m_ipAddress->getIp();
-        }
-
-        auto updatePacket = QSharedPointer<Packet>::create(PacketType::Control, payload.toUtf8());
+        auto updatePacket = PacketPool::acquire(UT::PacketControlType::RIP, PacketType::Control,
+                                                m_ripAdvertiser.payloadFor(portIndexOf(port)));
         updatePacket->setTTL(10);
         port->sendPacket(updatePacket);
-        qDebug() << "Router" << m_id << "sent RIP update via Port" << port->getPortNumber()
-                 << "with" << routeCount << "routes";
+        qDebug() << "Router" << m_id << "sent RIP" << (fullRefresh ? "refresh" : "triggered update")
+                 << "via Port" << port->getPortNumber() << "with" << routeCount << "routes";
     }
 }
 
 void
-Router::processRIPUpdate(const PacketPtr_t &packet)
+Router::processRIPUpdate(const PacketPtr_t &packet, const PortPtr_t &incomingPort)
 {
     if(!packet) return;
 
-    QString payload = packet->getPayload();
-    // qDebug() << "Router" << m_id << "processing RIP update packet.";
-
-    auto    parts   = payload.split(":");
-    if(parts.size() < 2)
-    {
-        qWarning() << "Router" << m_id << "received malformed RIP update:" << payload;
-        return;
-    }
-
-    QString data            = parts[1];
-    auto    routesAndSender = data.split("#");
-    if(routesAndSender.isEmpty()) return;
-
-    QString senderIP = routesAndSender.last();
-    routesAndSender.removeLast();
-
-    // Determine incoming port
-    Port     *incomingPort = qobject_cast<Port *>(sender());
-    PortPtr_t incomingPortPtr;
-    if(incomingPort)
-    {
-        for(auto &p : m_ports)
-        {
-            if(p.data() == incomingPort)
-            {
-                incomingPortPtr = p;
-                break;
-            }
-        }
-    }
+    applyRouteUpdate(packet, incomingPort, RoutingProtocol::RIP);
+}
 
-    // qDebug() << "Router" << m_id << "RIP update from" << senderIP << "with" << routesAndSender.size() << "routes.";
-    for(const auto &routeStr : routesAndSender)
-    {
-        if(routeStr.isEmpty()) continue;
-        auto fields = routeStr.split(",");
-        if(fields.size() < 3)
-        {
-            qWarning() << "Router" << m_id << "RIP route entry malformed:" << routeStr;
-            continue;
-        }
+void
+Router::applyRouteUpdate(const PacketPtr_t &packet, const PortPtr_t &incomingPort,
+                         RoutingProtocol protocol)
+{
+    ControlMessageReader message(packet->getPayload());
+    if(!message.isValid())
+    {
+        qWarning() << "Router" << m_id << "received malformed route update.";
+        return;
+    }
 
-        QString dest       = fields[0];
-        QString mask       = fields[1];
-        int     recvMetric = fields[2].toInt();
-        int     newMetric  = recvMetric + 1;
+    const quint32 senderAddress = message.origin();
+    const int     portIndex     = portIndexOf(incomingPort);
 
-        // qDebug() << "Router" << m_id << "processing route" << dest << "/" << mask << "from" << senderIP << "metric" << newMetric;
+    for(int i = 0; i < message.recordCount(); ++i)
+    {
+        ControlRecord record    = message.record(i);
+        int           newMetric = record.metric + 1;
 
         if(newMetric >= RIP_INFINITY)
         {
-            qDebug() << "Router" << m_id << "received unreachable route for" << dest << "skipping.";
+            withdrawRoute(record.prefix, record.prefixLength, senderAddress);
+            qDebug() << "Router" << m_id << "received unreachable route for"
+                     << ControlAddress::toString(record.prefix, record.flags) << "skipping.";
             continue;
         }
 
-        addRoute(dest, mask, senderIP, newMetric, RoutingProtocol::RIP, incomingPortPtr);
+        RouteEntry route;
+        route.prefix  = record.prefix;
+        route.length  = record.prefixLength;
+        route.nextHop = senderAddress;
+        if(record.flags & ControlRecord::FLAG_WILDCARD_HOST) route.flags |= RouteEntry::FLAG_WILDCARD_HOST;
+        if(record.flags & ControlRecord::FLAG_IPV4_MAPPED_IPV6) route.flags |= RouteEntry::FLAG_MAPPED_PREFIX;
+
+        addRoute(route, newMetric, protocol, portIndex);
     }
 }
 
 void
-Router::handleRouteTimeouts()
+Router::withdrawRoute(quint32 prefix, quint8 length, quint32 nextHop)
 {
-    for(auto &entry : m_routingTable)
-    {
-        if(entry.isDirect) continue;
+    // Only the neighbour we route through can take a route away; an unreachable advertisement
+    // from anyone else (poison reverse, for one) says nothing about our path.
+    RouteEntry *entry = m_routingTable.find(prefix, length, false);
+    if(!entry || entry->nextHop != nextHop || entry->metric >= RIP_INFINITY) return;
+
+    entry->metric = static_cast<qint16>(RIP_INFINITY);
+    setRouteTimer(*entry, RouteTimer::HoldDown, ripTimer(RIP_HOLDOWN_REFRESHES));
+    markRoutesChanged();
+    qDebug() << "Router" << m_id << ": Route to" << entry->destination()
+             << "withdrawn by its next hop, starting hold-down.";
+}
 
-        if(entry.invalidTimer > 0)
-        {
-            entry.invalidTimer--;
-            if(entry.invalidTimer == 0 && entry.metric < RIP_INFINITY)
-            {
-                entry.metric        = RIP_INFINITY;
-                entry.holdDownTimer = RIP_HOLDOWN_TIMER;
-                qDebug() << "Router" << m_id << ": Route to" << entry.destination
-                         << "invalidated, starting hold-down.";
-            }
-        }
+void
+Router::setRouteTimer(RouteEntry &entry, RouteTimer timer, int ticks)
+{
+    if(entry.timerId != TimingWheel::NO_TIMER) m_routeTimers.cancel(entry.timerId);
 
-        if(entry.holdDownTimer > 0)
-        {
-            entry.holdDownTimer--;
-            if(entry.holdDownTimer == 0 && entry.metric == RIP_INFINITY)
-            {
-                entry.flushTimer = RIP_FLUSH_TIMER;
-                qDebug() << "Router" << m_id << ": Hold-down ended for" << entry.destination
-                         << ", starting flush timer.";
-            }
-        }
+    entry.timer   = timer;
+    entry.timerId = TimingWheel::NO_TIMER;
+    if(timer == RouteTimer::None) return;
 
-        if(entry.flushTimer > 0)
-        {
-            entry.flushTimer--;
-        }
-    }
+    entry.timerId = m_routeTimers.schedule(
+      static_cast<SimTime_t>(m_currentTime + ticks),
+      RoutingTable::keyOf(entry.prefix, entry.length, entry.isDirect()));
+}
+
+void
+Router::onRouteTimer(TimingWheel::TimerId_t id, quint64 routeKey)
+{
+    RouteEntry *entry = m_routingTable.find(routeKey);
+    if(!entry || entry->timerId != id) return;
 
-    for(int i = m_routingTable.size() - 1; i >= 0; i--)
+    entry->timerId = TimingWheel::NO_TIMER;
+
+    switch(entry->timer)
     {
-        if(!m_routingTable[i].isDirect && m_routingTable[i].metric == RIP_INFINITY &&
-           m_routingTable[i].flushTimer == 0 && m_routingTable[i].holdDownTimer == 0 &&
-           m_routingTable[i].invalidTimer == 0)
-        {
+        case RouteTimer::Invalid :
+            entry->metric = static_cast<qint16>(RIP_INFINITY);
+            setRouteTimer(*entry, RouteTimer::HoldDown, ripTimer(RIP_HOLDOWN_REFRESHES));
+            markRoutesChanged();
+            qDebug() << "Router" << m_id << ": Route to" << entry->destination()
+                     << "invalidated, starting hold-down.";
+            break;
+
+        case RouteTimer::HoldDown :
+            setRouteTimer(*entry, RouteTimer::Flush, ripTimer(RIP_FLUSH_REFRESHES));
+            qDebug() << "Router" << m_id << ": Hold-down ended for" << entry->destination()
+                     << ", starting flush timer.";
+            break;
+
+        case RouteTimer::Flush :
             qDebug() << "Router" << m_id << ": Removing fully expired route to"
-                     << m_routingTable[i].destination;
-            m_routingTable.removeAt(i);
-        }
+                     << entry->destination();
+            m_routingTable.remove(entry->prefix, entry->length, false);
+            markRoutesChanged();
+            break;
+
+        case RouteTimer::None :
+            break;
     }
 }
 
+void
+Router::handleRouteTimeouts()
+{
+    m_routeTimers.advance(static_cast<SimTime_t>(m_currentTime),
+                          [this](TimingWheel::TimerId_t id, quint64 routeKey) {
+                              onRouteTimer(id, routeKey);
+                          });
+}
+
 void
 Router::addDirectRoute(const QString &destination, const QString &mask)
 {
     qDebug() << "Router" << m_id << "adding stable direct route:" << destination << "/" << mask;
-    RouteEntry directRoute(destination, mask, destination, 0, RoutingProtocol::ITSELF,
-                           m_currentTime, nullptr, true);
-    for(int i = m_routingTable.size() - 1; i >= 0; i--)
-    {
-        if(m_routingTable[i].destination == destination && m_routingTable[i].mask == mask &&
-           m_routingTable[i].isDirect)
-        {
-            m_routingTable.removeAt(i);
-        }
-    }
-    m_routingTable.append(directRoute);
+    RouteEntry directRoute     = RouteEntry::fromStrings(destination, mask, destination);
+    directRoute.metric         = 0;
+    directRoute.protocol       = RoutingProtocol::ITSELF;
+    directRoute.lastUpdateTime = static_cast<qint32>(m_currentTime);
+    directRoute.flags         |= RouteEntry::FLAG_DIRECT;
+
+    m_routingTable.insert(directRoute);
+    markRoutesChanged();
 }
 
 void
@@ -1276,31 +1514,19 @@ Router::setupDirectNeighborRoutes(RoutingProtocol protocol, int ASId, bool bgp)
         }
 
         qDebug() << "Router" << m_id << "adding direct neighbor route to" << nbrIP;
-        RouteEntry directNeighborRoute(nbrIP, "255.255.255.255", nbrIP, 1, protocol, m_currentTime,
-                                       nullptr, true);
-
-        for(int i = m_routingTable.size() - 1; i >= 0; i--)
-        {
-            if(m_routingTable[i].destination == nbrIP && !m_routingTable[i].isDirect)
-            {
-                m_routingTable.removeAt(i);
-            }
-        }
+        RouteEntry directNeighborRoute = RouteEntry::fromStrings(nbrIP, "255.255.255.255", nbrIP);
+        directNeighborRoute.metric         = 1;
+        directNeighborRoute.protocol       = protocol;
+        directNeighborRoute.lastUpdateTime = static_cast<qint32>(m_currentTime);
+        directNeighborRoute.flags         |= RouteEntry::FLAG_DIRECT;
 
-        bool alreadyExists = false;
-        for(auto &entry : m_routingTable)
-        {
-            if(entry.isDirect && entry.destination == nbrIP)
-            {
-                alreadyExists = true;
-                break;
-            }
-        }
+        m_routingTable.remove(directNeighborRoute.prefix, directNeighborRoute.length, false);
 
-        if(!alreadyExists)
+        if(!m_routingTable.find(directNeighborRoute.prefix, directNeighborRoute.length, true))
         {
-            m_routingTable.append(directNeighborRoute);
+            m_routingTable.insert(directNeighborRoute);
         }
+        markRoutesChanged();
     }
     if(protocol == RoutingProtocol::OSPF)
     {
@@ -1320,17 +1546,14 @@ Router::setupDirectNeighborRoutes(RoutingProtocol protocol, int ASId, bool bgp)
                 }
                 addRoute(pcIP, "255.255.255.255", pcIP, 1, RoutingProtocol::OSPF, learnedFromPort,
                          true);
-                RouteEntry directRoute(pcIP, "255.255.255.255", pcIP, 1, RoutingProtocol::OSPF,
-                                       m_currentTime, nullptr, true, true);
-                for(int i = m_routingTable.size() - 1; i >= 0; i--)
-                {
-                    if(m_routingTable[i].destination == pcIP &&
-                       m_routingTable[i].mask == "255.255.255.255" && m_routingTable[i].isDirect)
-                    {
-                        m_routingTable.removeAt(i);
-                    }
-                }
-                m_routingTable.append(directRoute);
+                RouteEntry directRoute = RouteEntry::fromStrings(pcIP, "255.255.255.255", pcIP);
+                directRoute.metric         = 1;
+                directRoute.protocol       = RoutingProtocol::OSPF;
+                directRoute.lastUpdateTime = static_cast<qint32>(m_currentTime);
+                directRoute.flags         |= RouteEntry::FLAG_DIRECT | RouteEntry::FLAG_VIP;
+
+                m_routingTable.insert(directRoute);
+                markRoutesChanged();
             }
         }
     }
@@ -1387,6 +1610,23 @@ Router::getDirectlyConnectedRouters(int ASId, bool bgp)
     return neighbors;
 }
 
+void
+Router::attachHost(const QSharedPointer<PC> &pc)
+{
+    m_attachedHosts.push_back(pc.toWeakRef());
+}
+
+std::vector<QString>
+Router::attachedHostIPs() const
+{
+    std::vector<QString> hosts;
+    for(const auto &host : m_attachedHosts)
+    {
+        if(QSharedPointer<PC> pc = host.toStrongRef()) hosts.push_back(pc->getIpAddress());
+    }
+    return hosts;
+}
+
 void
 Router::enableOSPF()
 {
@@ -1399,11 +1639,17 @@ Router::initializeOSPF()
 {
     sendOSPFHello();
 
-    m_helloTimer->start(OSPF_HELLO_INTERVAL * 1'000);
-    m_lsaTimer->start(OSPF_LSA_INTERVAL * 1'000);
+    auto           *coordinator   = EventsCoordinator::instance();
+    TimerService   *timers        = coordinator->timers();
+    const SimTime_t helloInterval = coordinator->toTicks(std::chrono::seconds(OSPF_HELLO_INTERVAL));
+    const SimTime_t lsaInterval   = coordinator->toTicks(std::chrono::seconds(OSPF_LSA_INTERVAL));
 
-    connect(EventsCoordinator::instance(), &EventsCoordinator::tick, this,
-            &Router::handleLSAExpiration);
+    if(m_helloTimer == TimerService::NO_TIMER)
+        m_helloTimer = timers->scheduleEvery(helloInterval, this, [this]() { sendOSPFHello(); });
+    if(m_lsaTimer == TimerService::NO_TIMER)
+        m_lsaTimer = timers->scheduleEvery(lsaInterval, this, [this]() { sendLSA(); });
+
+    m_ospfEnabled = true;
 }
 
 void
@@ -1429,9 +1675,10 @@ Router::sendOSPFHello()
 
         if(port->getConnectedRouterIP().isEmpty()) continue;
 
-        QString helloPayload = "OSPF_HELLO:" + m_ipAddress->getIp();
-        auto    helloPacket =
-          QSharedPointer<Packet>::create(PacketType::OSPFHello, helloPayload.toUtf8(), 10);
+        ControlMessageWriter hello(UT::PacketControlType::OSPF,
+                                   ControlAddress::fromString(m_ipAddress->getIp()));
+        auto helloPacket = PacketPool::acquire(UT::PacketControlType::OSPF, PacketType::OSPFHello,
+                                               hello.finish(), 10);
 
         port->sendPacket(helloPacket);
         qDebug() << "Router" << m_id << "sent OSPF Hello via Port" << port->getPortNumber();
@@ -1439,19 +1686,20 @@ Router::sendOSPFHello()
 }
 
 void
-Router::processOSPFHello(const PacketPtr_t &packet)
+Router::processOSPFHello(const PacketPtr_t &packet, const PortPtr_t &incomingPort)
 {
+    Q_UNUSED(incomingPort);
+
     if(!packet) return;
 
-    QString     payload = packet->getPayload();
-    QStringList parts   = payload.split(":");
-    if(parts.size() != 2 || parts[0] != "OSPF_HELLO")
+    ControlMessageReader message(packet->getPayload());
+    if(message.type() != UT::PacketControlType::OSPF)
     {
         qWarning() << "Router" << m_id << "received malformed OSPF Hello packet.";
         return;
     }
 
-    QString neighborIP = parts[1];
+    QString neighborIP = message.originAddress();
     qDebug() << "Router" << m_id << "received OSPF Hello from" << neighborIP;
 
     if(!m_neighbors.contains(neighborIP))
@@ -1459,7 +1707,7 @@ Router::processOSPFHello(const PacketPtr_t &packet)
         OSPFNeighbor neighbor;
         neighbor.ipAddress         = neighborIP;
         neighbor.cost              = 1;
-        neighbor.lastHelloReceived = QDateTime::currentSecsSinceEpoch();
+        neighbor.lastHelloReceived = m_now;
 
         m_neighbors.insert(neighborIP, neighbor);
 
@@ -1469,7 +1717,7 @@ Router::processOSPFHello(const PacketPtr_t &packet)
     }
     else
     {
-        m_neighbors[neighborIP].lastHelloReceived = QDateTime::currentSecsSinceEpoch();
+        m_neighbors[neighborIP].lastHelloReceived = m_now;
         qDebug() << "Router" << m_id << "updated lastHelloReceived for neighbor:" << neighborIP;
     }
 }
@@ -1479,27 +1727,26 @@ Router::sendLSA()
 {
     qDebug() << "Router" << m_id << "sending LSA.";
 
-    QString lsaPayload = "LSA:" + m_ipAddress->getIp() + ":";
+    m_lsaSequenceNumber++;
+
+    const quint32        originAddress = ControlAddress::fromString(m_ipAddress->getIp());
+    std::vector<quint32> links;
+    links.reserve(m_neighbors.size());
 
+    ControlMessageWriter lsaMessage(UT::PacketControlType::OSPFLSA, originAddress,
+                                    static_cast<quint32>(m_lsaSequenceNumber),
+                                    static_cast<int>(m_neighbors.size()));
     for(auto &neighbor : m_neighbors)
     {
-        lsaPayload += neighbor.ipAddress + ",";
+        lsaMessage.addAddress(neighbor.ipAddress);
+        links.push_back(ControlAddress::fromString(neighbor.ipAddress));
     }
 
-    if(lsaPayload.endsWith(",")) lsaPayload.chop(1);
-
-    m_lsaSequenceNumber++;
-
-    auto lsaPacket = QSharedPointer<Packet>::create(PacketType::OSPFLSA, lsaPayload.toUtf8(), 10);
+    auto lsaPacket = PacketPool::acquire(UT::PacketControlType::OSPFLSA, PacketType::OSPFLSA,
+                                         lsaMessage.finish(), 10);
     lsaPacket->setSequenceNumber(m_lsaSequenceNumber);
 
-    OSPFLSA lsa;
-    lsa.originRouterIP = m_ipAddress->getIp();
-    lsa.links          = QVector<QString>::fromList(m_neighbors.keys());
-    lsa.sequenceNumber = m_lsaSequenceNumber;
-    lsa.age            = 0;
-
-    m_lsdb.insert(m_ipAddress->getIp(), lsa);
+    installLSA(originAddress, static_cast<quint32>(m_lsaSequenceNumber), links);
 
     for(const auto &port : m_ports)
     {
@@ -1517,32 +1764,33 @@ Router::processLSA(const PacketPtr_t &packet, const PortPtr_t &incomingPort)
 {
     if(!packet) return;
 
-    QString     payload = packet->getPayload();
-    QStringList parts   = payload.split(":");
-    if(parts.size() < 3 || parts[0] != "LSA")
+    ControlMessageReader message(packet->getPayload());
+    if(message.type() != UT::PacketControlType::OSPFLSA)
     {
         qWarning() << "Router" << m_id << "received malformed LSA packet.";
         return;
     }
 
-    QString          originIP       = parts[1];
-    QStringList      linksList      = parts[2].split(",");
-    QVector<QString> links          = QVector<QString>::fromList(linksList);
+    QString       originIP       = message.originAddress();
+    const quint32 sequenceNumber = message.sequence();
+    const int     origin         = LinkStateDatabase::instance().findRouterId(message.origin());
+    const quint32 heldSequence   = hasLSA(origin) ? m_lsaSequences[origin] : 0;
 
-    int              sequenceNumber = packet->getSequenceNumber();
-
-    if(!m_lsdb.contains(originIP) || m_lsdb[originIP].sequenceNumber < sequenceNumber)
+    if(sequenceNumber > heldSequence)
     {
-        OSPFLSA newLSA;
-        newLSA.originRouterIP = originIP;
-        newLSA.links          = links;
-        newLSA.sequenceNumber = sequenceNumber;
-        newLSA.age            = 0;
+        std::vector<quint32> links;
+        links.reserve(message.recordCount());
+        for(int i = 0; i < message.recordCount(); ++i)
+        {
+            links.push_back(message.record(i).prefix);
+        }
 
-        m_lsdb.insert(originIP, newLSA);
+        installLSA(message.origin(), sequenceNumber, links);
         qDebug() << "Router" << m_id << "updated LSDB with LSA from" << originIP;
 
-        auto lsaPacket = QSharedPointer<Packet>::create(PacketType::OSPFLSA, payload.toUtf8(), 10);
+        // Re-flood the received bytes as they are; the payload is shared, not copied.
+        auto lsaPacket = PacketPool::acquire(UT::PacketControlType::OSPFLSA, PacketType::OSPFLSA,
+                                             packet->getPayload(), 10);
         lsaPacket->setSequenceNumber(sequenceNumber);
 
         for(const auto &port : m_ports)
@@ -1554,8 +1802,6 @@ Router::processLSA(const PacketPtr_t &packet, const PortPtr_t &incomingPort)
             port->sendPacket(lsaPacket);
             qDebug() << "Router" << m_id << "flooded LSA via Port" << port->getPortNumber();
         }
-
-        runDijkstra();
     }
     else
     {
@@ -1563,57 +1809,121 @@ Router::processLSA(const PacketPtr_t &packet, const PortPtr_t &incomingPort)
     }
 }
 
+bool
+Router::hasLSA(int origin) const
+{
+    return origin >= 0 && origin < static_cast<int>(m_lsaSequences.size()) &&
+           m_lsaSequences[origin] != 0;
+}
+
 void
-Router::runDijkstra()
+Router::installLSA(quint32 originAddress, quint32 sequence, const std::vector<quint32> &links)
 {
-    qDebug() << "Router" << m_id << "running Dijkstra algorithm.";
+    LinkStateDatabase &lsdb   = LinkStateDatabase::instance();
+    const int          origin = lsdb.acquire(originAddress, sequence, links);
 
-    m_distance.clear();
-    m_previous.clear();
-    QSet<QString> unvisited;
+    if(hasLSA(origin)) lsdb.release(origin, m_lsaSequences[origin]);
 
-    for(auto &lsa : m_lsdb)
+    if(origin >= static_cast<int>(m_lsaSequences.size()))
     {
-        m_distance[lsa.originRouterIP] = INT32_MAX;
-        unvisited.insert(lsa.originRouterIP);
+        m_lsaSequences.resize(origin + 1, 0);
+        m_lsaInstalledAt.resize(origin + 1, 0);
     }
+    m_lsaSequences[origin]   = sequence;
+    m_lsaInstalledAt[origin] = m_lsaClock;
+
+    m_spfChanged.push_back(origin);
+    m_spfThrottle.request(m_now);
+}
+
+void
+Router::removeLSA(int origin)
+{
+    if(!hasLSA(origin)) return;
+
+    LinkStateDatabase::instance().release(origin, m_lsaSequences[origin]);
+    m_lsaSequences[origin] = 0;
 
-    m_distance[m_ipAddress->getIp()] = 0;
+    m_spfChanged.push_back(origin);
+    m_spfThrottle.request(m_now);
+}
+
+void
+Router::runDijkstra()
+{
+    qDebug() << "Router" << m_id << "running Dijkstra algorithm.";
 
-    while(!unvisited.isEmpty())
+    LinkStateDatabase &lsdb  = LinkStateDatabase::instance();
+    const int          nodes = lsdb.routerCount();
+
+    // Only links between routers that both have an LSA take part. Routers that hold the same LSAs
+    // get the same graph.
+    m_lsaSequences.resize(nodes, 0);
+    m_lsaInstalledAt.resize(nodes, 0);
+    std::shared_ptr<const CsrGraph> graph = lsdb.graph(m_lsaSequences);
+
+    // The arcs that changed leave the routers whose LSA changed or, for a router that joined or
+    // left the LSDB, the routers linking to it.
+    std::vector<int>  changed;
+    std::vector<char> marked(nodes, 0);
+    auto              mark = [&](int node) {
+        if(!marked[node])
+        {
+            marked[node] = 1;
+            changed.push_back(node);
+        }
+    };
+    for(int node : m_spfChanged)
     {
-        QString current;
-        int     minDistance = INT32_MAX;
-        for(const auto &node : unvisited)
+        mark(node);
+
+        for(const CsrGraph *view : {m_spfGraph.get(), graph.get()})
         {
-            if(m_distance[node] < minDistance)
+            if(!view) continue;
+            if(node >= view->nodeCount()) continue;
+
+            for(int arc = view->reverseOffsets[node]; arc < view->reverseOffsets[node + 1]; ++arc)
             {
-                minDistance = m_distance[node];
-                current     = node;
+                mark(view->sources[arc]);
             }
         }
+    }
+    m_spfChanged.clear();
 
-        if(current.isEmpty() || minDistance == INT32_MAX) break;
+    int source = lsdb.findRouterId(ControlAddress::fromString(m_ipAddress->getIp()));
+    if(!hasLSA(source)) source = ShortestPathTree::NO_NODE;
 
-        unvisited.remove(current);
+    // Repair the tree while the change is local; start over when the source moved or a large part
+    // of the graph changed.
+    const bool fullRun = source == ShortestPathTree::NO_NODE || source != m_spf.source() ||
+                         changed.size() * 4 > static_cast<size_t>(nodes);
+    if(fullRun)
+    {
+        m_spf.compute(*graph, source);
+        m_spfGraph = std::move(graph);
+        updateRoutingTable();
+    }
+    else
+    {
+        std::vector<int> touched = m_spf.repair(*graph, changed);
+        m_spfGraph               = std::move(graph);
 
-        if(!m_lsdb.contains(current)) continue;
+        qDebug() << "Router" << m_id << "repaired SPF for" << touched.size() << "of" << nodes
+                 << "routers.";
 
-        const auto &currentLSA = m_lsdb[current];
-        for(const auto &neighborIP : currentLSA.links)
+        markRoutesChanged();
+        for(int node : touched)
         {
-            if(!m_distance.contains(neighborIP)) continue;
-
-            int altDistance = m_distance[current] + 1;
-            if(altDistance < m_distance[neighborIP])
-            {
-                m_distance[neighborIP] = altDistance;
-                m_previous[neighborIP] = current;
-            }
+            removeOspfRoutes(node);
+        }
+        for(int node : touched)
+        {
+            addOspfRoutes(node);
         }
+        emit routingTableUpdated(m_id);
     }
 
-    updateRoutingTable();
+    m_spfThrottle.completed(m_now);
 }
 
 void
@@ -1621,124 +1931,128 @@ Router::updateRoutingTable()
 {
     qDebug() << "Router" << m_id << "updating routing table based on Dijkstra results.";
 
-    for(int i = m_routingTable.size() - 1; i >= 0; i--)
-    {
-        if(m_routingTable[i].protocol == RoutingProtocol::OSPF && !m_routingTable[i].vip)
-        {
-            m_routingTable.removeAt(i);
-        }
-    }
+    markRoutesChanged();
+
+    m_routingTable.removeIf([](const RouteEntry &entry) {
+        return entry.protocol == RoutingProtocol::OSPF && !entry.isVip();
+    });
 
     // Add new OSPF routes
-    for(auto it = m_distance.constBegin(); it != m_distance.constEnd(); ++it)
+    for(int node = 0; node < m_spf.nodeCount(); ++node)
     {
-        const QString &dest = it.key();
+        addOspfRoutes(node);
+    }
 
-        if(dest == m_ipAddress->getIp()) continue;
+    emit routingTableUpdated(m_id);
+}
 
-        QString nextHop = "";
-        QString current = dest;
+void
+Router::addOspfRoutes(int node)
+{
+    if(node == m_spf.source() || !hasLSA(node)) return;
 
-        while(m_previous.contains(current))
-        {
-            if(m_previous[current] == m_ipAddress->getIp())
-            {
-                nextHop = current;
-                break;
-            }
-            current = m_previous[current];
-        }
+    const LinkStateDatabase &lsdb = LinkStateDatabase::instance();
+    const QString            dest = ControlAddress::toString(lsdb.routerAddress(node));
+
+    if(m_spf.firstHop(node) == ShortestPathTree::NO_NODE)
+    {
+        qDebug() << "Router" << m_id << "could not determine nextHop for destination" << dest;
+        return;
+    }
 
-        if(nextHop.isEmpty())
+    const QString nextHop  = ControlAddress::toString(lsdb.routerAddress(m_spf.firstHop(node)));
+    const int     distance = static_cast<int>(m_spf.distance(node));
+
+    // Find the port connected to nextHop
+    PortPtr_t outPort = nullptr;
+    for(const auto &port : m_ports)
+    {
+        if(port->getConnectedRouterIP() == nextHop)
         {
-            qDebug() << "Router" << m_id << "could not determine nextHop for destination" << dest;
-            continue;
+            outPort = port;
+            break;
         }
-
-        // Find the port connected to nextHop
-        PortPtr_t outPort = nullptr;
-        for(const auto &port : m_ports)
+        else
         {
-            if(port->getConnectedRouterIP() == nextHop)
+            QSharedPointer<PC> connectedPC = port->getConnectedPC();
+            if(connectedPC && connectedPC->getIpAddress() == nextHop)
             {
                 outPort = port;
                 break;
             }
-            else
-            {
-                QSharedPointer<PC> connectedPC = port->getConnectedPC();
-                if(connectedPC && connectedPC->getIpAddress() == nextHop)
-                {
-                    outPort = port;
-                    break;
-                }
-            }
         }
+    }
+
+    if(outPort)
+    {
+        addRoute(dest, "255.255.255.255", nextHop, distance, RoutingProtocol::OSPF, outPort);
+        qDebug() << "Router" << m_id << "added OSPF route to" << dest << "via" << nextHop;
 
-        if(outPort)
+        for(const auto &pcIP : hostsBehindRouter(dest))
         {
-            addRoute(dest, "255.255.255.255", nextHop, m_distance[dest], RoutingProtocol::OSPF,
-                     outPort);
-            qDebug() << "Router" << m_id << "added OSPF route to" << dest << "via" << nextHop;
+            addRoute(pcIP, "255.255.255.255", nextHop, distance + 1, RoutingProtocol::OSPF, outPort);
+        }
+    }
+    else
+    {
+        qDebug() << "Router" << m_id << "could not find outPort for destination" << dest
+                 << "via" << nextHop;
+    }
+}
 
-            static const QRegularExpression regex(R"(\.([a-zA-Z0-9_]+)$)");
-            QString                         id = "";
-            bool                            ok;
+void
+Router::removeOspfRoutes(int node)
+{
+    auto removeHostRoute = [this](const QString &ip) {
+        const RouteEntry  key   = RouteEntry::fromStrings(ip, "255.255.255.255", ip);
+        const RouteEntry *route = m_routingTable.find(key.prefix, key.length, false);
+        if(route && route->protocol == RoutingProtocol::OSPF && !route->isVip())
+            m_routingTable.remove(key.prefix, key.length, false);
+    };
 
-            QRegularExpressionMatch         match1 = regex.match(dest);
-            if(match1.hasMatch())
-            {
-                id = match1.captured(1);
-                qDebug() << "Extracted ID from Dest: " << id;
-            }
-            else
-            {}
+    if(node == m_spf.source()) return;
 
-            QSharedPointer<Router> destRouter = s_topologyBuilder->findRouterById(id.toInt(&ok));
-            std::vector<QSharedPointer<Router>> connectedPCs =
-              destRouter->getDirectlyConnectedRouters(0, false);
-            for(auto &pc : connectedPCs)
-            {
-                if(pc->getId() > 23)
-                {
-                    QString pcIP = pc->getIPAddress();
-                    addRoute(pcIP, "255.255.255.255", nextHop, m_distance[dest] + 1,
-                             RoutingProtocol::OSPF, outPort);
-                }
-            }
-        }
-        else
-        {
-            qDebug() << "Router" << m_id << "could not find outPort for destination" << dest
-                     << "via" << nextHop;
-        }
+    const QString routerIP =
+      ControlAddress::toString(LinkStateDatabase::instance().routerAddress(node));
+    removeHostRoute(routerIP);
+    for(const auto &pcIP : hostsBehindRouter(routerIP))
+    {
+        removeHostRoute(pcIP);
     }
+}
 
-    emit routingTableUpdated(m_id);
+std::vector<QString>
+Router::hostsBehindRouter(const QString &routerIP) const
+{
+    std::vector<QString> hosts;
+
+    static const QRegularExpression regex(R"(\.([a-zA-Z0-9_]+)$)");
+    QRegularExpressionMatch         match = regex.match(routerIP);
+    if(!match.hasMatch() || !s_topologyBuilder) return hosts;
+
+    bool                   ok;
+    QSharedPointer<Router> router = s_topologyBuilder->findRouterById(match.captured(1).toInt(&ok));
+    if(!ok || !router) return hosts;
+
+    // Runs on route-phase workers: read the host list fixed at topology time rather than walking
+    // the other router's ports.
+    return router->attachedHostIPs();
 }
 
 void
 Router::handleLSAExpiration()
 {
-    for(auto &lsa : m_lsdb)
-    {
-        lsa.age += 1;
-    }
+    m_lsaClock += 1;
 
-    QStringList expiredLSAs;
-    for(auto it = m_lsdb.constBegin(); it != m_lsdb.constEnd(); ++it)
+    // One SPF run covers all of them; see m_spfThrottle.
+    for(int origin = 0; origin < static_cast<int>(m_lsaSequences.size()); ++origin)
     {
-        if(it.value().age >= OSPF_LSA_AGE_LIMIT)
-        {
-            expiredLSAs.append(it.key());
-        }
-    }
+        if(!hasLSA(origin) || m_lsaClock - m_lsaInstalledAt[origin] < quint32(OSPF_LSA_AGE_LIMIT))
+            continue;
 
-    for(const auto &originIP : expiredLSAs)
-    {
-        m_lsdb.remove(originIP);
-        qDebug() << "Router" << m_id << "removed expired LSA from" << originIP;
-        runDijkstra();
+        removeLSA(origin);
+        qDebug() << "Router" << m_id << "removed expired LSA from"
+                 << ControlAddress::toString(LinkStateDatabase::instance().routerAddress(origin));
     }
 }
 
@@ -1769,6 +2083,8 @@ Router::isRouterBorder()
 void
 Router::startEBGP()
 {
+    const quint32 originAddress = ControlAddress::fromString(m_ipAddress->getIp());
+
     for(auto &port : m_ports)
     {
         if(m_ASnum != -1)
@@ -1783,28 +2099,23 @@ Router::startEBGP()
                 {
                     if(!port->isConnected()) continue;
 
-                    QString payload    = "EBGP_UPDATE:";
-                    int     routeCount = 0;
+                    const int            portIndex = portIndexOf(port);
+                    ControlMessageWriter update(UT::PacketControlType::EBGP, originAddress, 0,
+                                                m_routingTable.size());
                     for(const auto &entry : m_routingTable)
                     {
                         int advertisedMetric = entry.metric;
-                        if(entry.learnedFromPort == port && !entry.isDirect)
+                        if(entry.portIndex == portIndex && !entry.isDirect())
                         {
                             advertisedMetric = RIP_INFINITY;
                         }
-                        payload += entry.destination + "," + entry.mask + "," +
-                                   QString::number(advertisedMetric) + "#";
-                        routeCount++;
-                    }
-
-                    payload += m_ipAddress->getIp();
-                    if(routeCount == 0)
-                    {
-                        payload = "EBGP_UPDATE:" + m_ipAddress->getIp();
+                        addRouteRecord(update, entry, advertisedMetric);
                     }
 
+                    int  routeCount = update.recordCount();
                     auto updatePacket =
-                      QSharedPointer<Packet>::create(PacketType::Control, payload.toUtf8());
+                      PacketPool::acquire(UT::PacketControlType::EBGP, PacketType::Control,
+                                          update.finish());
                     updatePacket->setTTL(10);
                     port->sendPacket(updatePacket);
                     qDebug() << "Router" << m_id << "sent EBGP update via Port"
@@ -1819,6 +2130,9 @@ void
 Router::startIBGP()
 {
     IBGPCounter = 0;
+
+    const quint32 originAddress = ControlAddress::fromString(m_ipAddress->getIp());
+
     for(auto &port : m_ports)
     {
         if(m_ASnum != -1)
@@ -1836,21 +2150,14 @@ Router::startIBGP()
                 {
                     if(!port->isConnected()) continue;
 
-                    QString payload     = "IBGP_UPDATE:";
-                    int     routeCount  = 0;
                     QString destination = (m_ASnum == 1) ? "192.168.200.xx" : "192.168.100.xx";
-                    payload +=
-                      destination + "," + "255.255.255.255" + "," + QString::number(1) + "#";
-                    routeCount++;
-
-                    payload += m_ipAddress->getIp();
-                    if(routeCount == 0)
-                    {
-                        payload = "IBGP_UPDATE:" + m_ipAddress->getIp();
-                    }
+                    ControlMessageWriter update(UT::PacketControlType::IBGP, originAddress, 0, 1);
+                    update.addRoute(destination, "255.255.255.255", 1);
 
+                    int  routeCount = update.recordCount();
                     auto updatePacket =
-                      QSharedPointer<Packet>::create(PacketType::Control, payload.toUtf8());
+                      PacketPool::acquire(UT::PacketControlType::IBGP, PacketType::Control,
+                                          update.finish());
                     updatePacket->setTTL(10);
                     port->sendPacket(updatePacket);
                     qDebug() << "Router" << m_id << "sent IBGP update via Port"
@@ -1862,128 +2169,21 @@ Router::startIBGP()
 }
 
 void
-Router::processEBGPUpdate(const PacketPtr_t &packet)
+Router::processEBGPUpdate(const PacketPtr_t &packet, const PortPtr_t &incomingPort)
 {
     if(!packet) return;
 
-    QString payload = packet->getPayload();
-
-    auto    parts   = payload.split(":");
-    if(parts.size() < 2)
-    {
-        qWarning() << "Router" << m_id << "received malformed EBGP update:" << payload;
-        return;
-    }
-
-    QString data            = parts[1];
-    auto    routesAndSender = data.split("#");
-    if(routesAndSender.isEmpty()) return;
-
-    QString senderIP = routesAndSender.last();
-    routesAndSender.removeLast();
-
-    // Determine incoming port
-    Port     *incomingPort = qobject_cast<Port *>(sender());
-    PortPtr_t incomingPortPtr;
-    if(incomingPort)
-    {
-        for(auto &p : m_ports)
-        {
-            if(p.data() == incomingPort)
-            {
-                incomingPortPtr = p;
-                break;
-            }
-        }
-    }
-
-    for(const auto &routeStr : routesAndSender)
-    {
-        if(routeStr.isEmpty()) continue;
-        auto fields = routeStr.split(",");
-        if(fields.size() < 3)
-        {
-            qWarning() << "Router" << m_id << "EBGP route entry malformed:" << routeStr;
-            continue;
-        }
-
-        QString dest       = fields[0];
-        QString mask       = fields[1];
-        int     recvMetric = fields[2].toInt();
-        int     newMetric  = recvMetric + 1;
-
-        if(newMetric >= RIP_INFINITY)
-        {
-            qDebug() << "Router" << m_id << "received unreachable route for" << dest << "skipping.";
-            continue;
-        }
-
-        addRoute(dest, mask, senderIP, newMetric, RoutingProtocol::EBGP, incomingPortPtr);
-    }
+    applyRouteUpdate(packet, incomingPort, RoutingProtocol::EBGP);
 }
 
 void
-Router::processIBGPUpdate(const PacketPtr_t &packet)
+Router::processIBGPUpdate(const PacketPtr_t &packet, const PortPtr_t &incomingPort)
 {
     m_gotIBGP = true;
 
     if(!packet) return;
 
-    QString payload = packet->getPayload();
-
-    auto    parts   = payload.split(":");
-    if(parts.size() < 2)
-    {
-        qWarning() << "Router" << m_id << "received malformed IBGP update:" << payload;
-        return;
-    }
-
-    QString data            = parts[1];
-    auto    routesAndSender = data.split("#");
-    if(routesAndSender.isEmpty()) return;
-
-    QString senderIP = routesAndSender.last();
-    routesAndSender.removeLast();
-
-    // Determine incoming port
-    Port     *incomingPort = qobject_cast<Port *>(sender());
-    PortPtr_t incomingPortPtr;
-    if(incomingPort)
-    {
-        for(auto &p : m_ports)
-        {
-            if(p.data() == incomingPort)
-            {
-                incomingPortPtr = p;
-                break;
-            }
-        }
-    }
-
-    for(const auto &routeStr : routesAndSender)
-    {
-        if(routeStr.isEmpty()) continue;
-        auto fields = routeStr.split(",");
-        if(fields.size() < 3)
-        {
-            qWarning() << "Router" << m_id << "IBGP route entry malformed:" << routeStr;
-            continue;
-        }
-
-        QString dest       = fields[0];
-        QString mask       = fields[1];
-
-        int     recvMetric = fields[2].toInt();
-        int     newMetric  = recvMetric + 1;
-
-        if(newMetric >= RIP_INFINITY)
-        {
-            qDebug() << "Router" << m_id << "received unreachable route for" << dest << "skipping.";
-            continue;
-        }
-
-        addRoute(dest, mask, senderIP, newMetric, RoutingProtocol::IBGP, incomingPortPtr);
-    }
+    applyRouteUpdate(packet, incomingPort, RoutingProtocol::IBGP);
 
     if(IBGPCounter < 10)
     {
@@ -1994,6 +2194,8 @@ Router::processIBGPUpdate(const PacketPtr_t &packet)
 void
 Router::forwardIBGP()
 {
+    const quint32 originAddress = ControlAddress::fromString(m_ipAddress->getIp());
+
     for(auto &port : m_ports)
     {
         if(m_ASnum != -1)
@@ -2012,31 +2214,27 @@ Router::forwardIBGP()
                     if(!port->isConnected()) continue;
                     QString destination = (m_ASnum == 1) ? "192.168.200.xx" : "192.168.100.xx";
 
-                    QString payload     = "IBGP_UPDATE:";
-                    int     routeCount  = 0;
+                    const RouteEntry     aggregate = RouteEntry::fromStrings(destination, "255.255.255.0", "");
+                    const int            portIndex = portIndexOf(port);
+                    ControlMessageWriter update(UT::PacketControlType::IBGP, originAddress);
                     for(const auto &entry : m_routingTable)
                     {
-                        if(entry.destination == destination)
+                        if(entry.prefix == aggregate.prefix && entry.length == aggregate.length &&
+                           (entry.flags & RouteEntry::FLAG_WILDCARD_HOST))
                         {
                             int advertisedMetric = entry.metric;
-                            if(entry.learnedFromPort == port && !entry.isDirect)
+                            if(entry.portIndex == portIndex && !entry.isDirect())
                             {
                                 advertisedMetric = RIP_INFINITY;
                             }
-                            payload += entry.destination + "," + entry.mask + "," +
-                                       QString::number(advertisedMetric) + "#";
-                            routeCount++;
+                            addRouteRecord(update, entry, advertisedMetric);
                         }
                     }
 
-                    payload += m_ipAddress->getIp();
-                    if(routeCount == 0)
-                    {
-                        payload = "IBGP_UPDATE:" + m_ipAddress->getIp();
-                    }
-
+                    int  routeCount = update.recordCount();
                     auto updatePacket =
-                      QSharedPointer<Packet>::create(PacketType::Control, payload.toUtf8());
+                      PacketPool::acquire(UT::PacketControlType::IBGP, PacketType::Control,
+                                          update.finish());
                     updatePacket->setTTL(10);
                     port->sendPacket(updatePacket);
                     qDebug() << "Router" << m_id << "sent IBGP update via Port"
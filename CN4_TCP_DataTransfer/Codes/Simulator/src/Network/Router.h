@@ -2,11 +2,11 @@
 #define ROUTER_H
 
 #include <QSet>
-#include <QTimer>
+#include <atomic>
 #include <QQueue>
 #include <QMutex>
+#include <memory>
 #include <vector>
-#include <QDateTime>
 #include <QMutexLocker>
 #include <QSharedPointer>
 #include <QEnableSharedFromThis>
@@ -14,6 +14,14 @@
 #include "Node.h"
 #include "../Port/Port.h"
 #include "../DHCPServer/DHCPServer.h"
+#include "../EventsCoordinator/TimerService.h"
+#include "../Queue/MpscRing.h"
+#include "../Routing/RcuPointer.h"
+#include "../Routing/RipAdvertiser.h"
+#include "../Routing/LinkStateDatabase.h"
+#include "../Routing/RoutingTable.h"
+#include "../Routing/ShortestPath.h"
+#include "../Routing/SpfThrottle.h"
 
 class UDP;
 class TopologyBuilder;
@@ -22,57 +30,39 @@ class PC;
 
 struct BufferedPacket {
     PacketPtr_t packet;
-    qint64 enqueueTime;
+    SimTime_t enqueueTime = 0;    // tick
 };
 
-enum class RoutingProtocol {
-    RIP,
-    OSPF,
-    EBGP,
-    IBGP,
-    ITSELF
+enum class BufferDropPolicy {
+    DropTail,    // a full buffer refuses the arriving packet
+    DropHead     // a full buffer drops its oldest packet to admit the arriving one
 };
 
-struct RouteEntry {
-    QString destination;
-    QString mask;
-    QString nextHop;
-    int metric;
-    RoutingProtocol protocol;
-    qint64 lastUpdateTime;
-    PortPtr_t learnedFromPort;
-
-    bool isDirect;
-    bool vip;
-    int invalidTimer;
-    int holdDownTimer;
-    int flushTimer;
-
-    RouteEntry(const QString &dest = "",
-               const QString &m = "",
-               const QString &nh = "",
-               int met = -1,
-               RoutingProtocol proto = RoutingProtocol::RIP,
-               qint64 time = 0,
-               PortPtr_t fromPort = nullptr,
-               bool direct = false,
-               bool vip = false)
-        : destination(dest), mask(m), nextHop(nh), metric(met),
-        protocol(proto), lastUpdateTime(time), learnedFromPort(fromPort),
-        isDirect(direct), vip(vip), invalidTimer(0), holdDownTimer(0), flushTimer(0) {}
+struct BufferStats {
+    size_t capacity      = 0;
+    size_t occupancy     = 0;
+    size_t highWatermark = 0;
+    quint64 drops        = 0;
+};
+
+struct OutputQueueStats {
+    quint64 tailDrops     = 0;    // all ports together
+    quint64 aqmDrops      = 0;
+    quint64 ecnMarks      = 0;    // packets marked congestion-experienced instead of dropped
+    int     highWatermark = 0;    // deepest any single port's queue got
+};
+
+struct ControlLaneStats {
+    quint64 received      = 0;
+    quint64 processed     = 0;
+    quint64 drops         = 0;    // lane full, TTL expired or router broken
+    size_t  highWatermark = 0;
 };
 
 struct OSPFNeighbor {
     QString ipAddress;
     int cost;
-    qint64 lastHelloReceived;
-};
-
-struct OSPFLSA {
-    QString originRouterIP;
-    QVector<QString> links;
-    qint64 sequenceNumber;
-    qint64 age;
+    SimTime_t lastHelloReceived;    // tick
 };
 
 struct Range {
@@ -106,14 +96,32 @@ public:
     void setDHCPServer(QSharedPointer<DHCPServer> dhcpServer);
     QSharedPointer<DHCPServer> getDHCPServer();
     bool isDHCPServer() const;
-    QString findBestRoute(const QString &destinationIP) const;
     void addDirectRoute(const QString &destination, const QString &mask);
 
     void setupDirectNeighborRoutes(RoutingProtocol protocol, int ASId, bool bgp);
     std::vector<QSharedPointer<Router>> getDirectlyConnectedRouters(int ASId, bool bgp);
+    /** Records a PC bound to one of this router's ports. Topology time only. */
+    void attachHost(const QSharedPointer<PC> &pc);
+    /**
+     * IPs of the PCs bound to this router. The list is fixed once the topology is built, so other
+     * routers' workers may read it during the route phase.
+     */
+    std::vector<QString> attachedHostIPs() const;
     static void setTopologyBuilder(TopologyBuilder *builder);
+    static void setRipRefreshInterval(int ticks);
+    static constexpr int DEFAULT_RIP_REFRESH_INTERVAL = 30;
+    static void setDefaultBufferSize(int packets);
+    static void setBufferDropPolicy(BufferDropPolicy policy);
+    static constexpr int DEFAULT_BUFFER_SIZE = 60;
+    void setBufferSize(int packets);
+    BufferStats bufferStats() const;
+    ControlLaneStats controlStats() const;
+    OutputQueueStats outputQueueStats() const;
     void setMetricsCollector(QSharedPointer<MetricsCollector> collector);
     RouteEntry findBestRoutePath(const QString &destinationIP) const;
+    RouteEntry findBestRoutePath(quint32 destination) const;
+    void addRoute(RouteEntry route, int metric, RoutingProtocol protocol, int portIndex = -1,
+                  bool vip = false);
 
     bool isBroken() { return m_isBroken; }
     void addConnectedPC(QSharedPointer<PC> pc, PortPtr_t port);
@@ -127,6 +135,10 @@ public:
     bool gottenIBGP() { return m_gotIBGP; }
     void setGotIBGP(bool gotten) { m_gotIBGP = gotten; }
 
+    quint64 receivePhase(const TickContext &context) override;
+    quint64 routePhase(const TickContext &context) override;
+    quint64 transmitPhase(const TickContext &context) override;
+
 signals:
     void routingTableUpdated(int routerId);
     void finished();
@@ -137,7 +149,7 @@ public slots:
 
 public Q_SLOTS:
     void initialize();
-    void processDHCPResponse(const PacketPtr_t  &packet);
+    void processDHCPResponse(const PacketPtr_t &packet, const PortPtr_t &incomingPort = nullptr);
 
     void addRoute(const QString &destination, const QString &mask, const QString &nextHop, int metric,
                   RoutingProtocol protocol, PortPtr_t learnedFromPort = nullptr, bool vip = false);
@@ -153,23 +165,23 @@ public Q_SLOTS:
     void onNextTickForPCs();
     void receiveDataPacket(const QList<PacketPtr_t> &packets);
     void receiveDataPacket(const PacketPtr_t &packet);
-    void sendToPC(const PacketPtr_t &packet, const QSharedPointer<PC> &pc);
-    void processDataPacket(const PacketPtr_t &packet);    // thread pool and mutext and lambda
+    void processDataPacket(const PacketPtr_t &packet);
+    void processDataPackets(const QList<PacketPtr_t> &packets);
 
 
 
-    void sendRIPUpdate();
-    void processRIPUpdate(const PacketPtr_t  &packet);
+    void sendRIPUpdate(bool fullRefresh = true);
+    void processRIPUpdate(const PacketPtr_t &packet, const PortPtr_t &incomingPort = nullptr);
     void handleRouteTimeouts();
 
     // BGP specific methods
-    void processEBGPUpdate(const PacketPtr_t  &packet);
-    void processIBGPUpdate(const PacketPtr_t  &packet);
+    void processEBGPUpdate(const PacketPtr_t &packet, const PortPtr_t &incomingPort = nullptr);
+    void processIBGPUpdate(const PacketPtr_t &packet, const PortPtr_t &incomingPort = nullptr);
 
     // OSPF-specific methods
     void enableOSPF();
     void sendOSPFHello();
-    void processOSPFHello(const PacketPtr_t &packet);
+    void processOSPFHello(const PacketPtr_t &packet, const PortPtr_t &incomingPort = nullptr);
     void sendLSA();
     void processLSA(const PacketPtr_t &packet, const PortPtr_t &incomingPort);
     void runDijkstra();
@@ -177,6 +189,7 @@ public Q_SLOTS:
 
 private:
     std::vector<PortPtr_t> m_ports;
+    std::vector<QWeakPointer<PC>> m_attachedHosts;
     int m_portCount;
     int m_ASnum;
     bool m_hasValidIP;
@@ -185,41 +198,99 @@ private:
     QSharedPointer<MetricsCollector> m_metricsCollector;
     QString m_assignedIP;
 
-    QSet<QString> m_seenPackets;
+    QSet<QByteArray> m_seenPackets;
     static TopologyBuilder *s_topologyBuilder;
-    QVector<RouteEntry> m_routingTable;
+    RoutingTable m_routingTable;
 
-    // RIP-related fields
-    const int RIP_UPDATE_INTERVAL = 5;
+    // RIP-related fields. Route changes go out as triggered updates on the next RIP tick and the
+    // whole table only every s_ripRefreshInterval ticks; the route timers are counted in refresh
+    // periods so a route outlives the gap between two refreshes.
+    inline static int s_ripRefreshInterval = DEFAULT_RIP_REFRESH_INTERVAL;
     const int RIP_ROUTE_TIMEOUT   = 180;
     const int RIP_INFINITY        = 16;
-    const int RIP_INVALID_TIMER = 20;
-    const int RIP_HOLDOWN_TIMER = 20;
-    const int RIP_FLUSH_TIMER = 30;
+    const int RIP_INVALID_REFRESHES = 4;
+    const int RIP_HOLDOWN_REFRESHES = 4;
+    const int RIP_FLUSH_REFRESHES = 6;
+    RipAdvertiser m_ripAdvertiser {RIP_INFINITY};
+    quint64 m_routesVersion = 0;           // bumped by markRoutesChanged()
+    quint64 m_ripAdvertisedVersion = 0;    // m_routesVersion as of the last RIP update
+
+    // The invalid, hold-down and flush timers of the learned routes, in RIP ticks. Only the routes
+    // whose timer fires are touched; a timer whose route was replaced or removed is ignored.
+    TimingWheel m_routeTimers;
+
+    int ripTimer(int refreshes) const { return refreshes * s_ripRefreshInterval; }
+    void setRouteTimer(RouteEntry &entry, RouteTimer timer, int ticks = 0);
+    void onRouteTimer(TimingWheel::TimerId_t id, quint64 routeKey);
+    void withdrawRoute(quint32 prefix, quint8 length, quint32 nextHop);
 
     // OSPF data structures
     QMap<QString, OSPFNeighbor> m_neighbors;
-    QMap<QString, OSPFLSA> m_lsdb;
-    QTimer *m_helloTimer;
-    QTimer *m_lsaTimer;
+    TimerService::TimerId_t m_helloTimer = TimerService::NO_TIMER;
+    TimerService::TimerId_t m_lsaTimer = TimerService::NO_TIMER;
     qint64 m_lsaSequenceNumber;
 
-    // Dijkstra algorithm helpers
-    QMap<QString, int> m_distance;
-    QMap<QString, QString> m_previous;
-
-    // Buffer-related members
-    QQueue<BufferedPacket> m_buffer;          // Shared buffer queue
-    int m_bufferSize;                         // Maximum buffer size
-    QMutex m_bufferMutex;                     // Mutex for thread safety
-    QTimer *m_bufferTimer;                    // Timer for data retention management
+    // This router's view of the shared LinkStateDatabase, indexed by router id: the sequence number
+    // of the LSA it holds from each origin (0 for none) and the LSA clock tick it was installed at.
+    // m_spfChanged lists the origins whose LSA changed since the last SPF run, which m_spfThrottle
+    // schedules.
+    std::vector<quint32> m_lsaSequences;
+    std::vector<quint32> m_lsaInstalledAt;
+    quint32 m_lsaClock = 0;
+    std::vector<int> m_spfChanged;
+    std::shared_ptr<const CsrGraph> m_spfGraph;
+    ShortestPathTree m_spf;
+    SpfThrottle m_spfThrottle;
+    SimTime_t m_now = 0;
+
+    bool hasLSA(int origin) const;
+    void installLSA(quint32 originAddress, quint32 sequence, const std::vector<quint32> &links);
+    void removeLSA(int origin);
+    void removeOspfRoutes(int node);
+    void addOspfRoutes(int node);
+    std::vector<QString> hostsBehindRouter(const QString &routerIP) const;
+
+    // Buffer-related members. Any thread may enqueue into the ring; only the router's own phases
+    // (and the retention sweep between ticks) take packets out.
+    inline static int s_defaultBufferSize = DEFAULT_BUFFER_SIZE;
+    inline static BufferDropPolicy s_bufferDropPolicy = BufferDropPolicy::DropTail;
+    std::unique_ptr<MpscRing<BufferedPacket>> m_buffer;
+    TimerService::TimerId_t m_bufferTimer = TimerService::NO_TIMER;    // data retention sweep
     int m_bufferRetentionTime;                // Retention time in milliseconds
 
     // Buffer management methods
     bool enqueuePacketToBuffer(const PacketPtr_t &packet);
+    int enqueuePacketsToBuffer(const QList<PacketPtr_t> &packets);
     PacketPtr_t dequeuePacketFromBuffer();
+    QList<PacketPtr_t> dequeuePacketsFromBuffer(int count);
     void processBuffer();
 
+    // Control-plane lane. RIP, OSPF, BGP and DHCP packets never share the data buffer: they wait
+    // here and are handled at the start of the route phase, before any data is forwarded. Their
+    // drops are counted here instead of being reported to the metrics as data loss.
+    struct QueuedControlPacket
+    {
+        PacketPtr_t packet;
+        PortPtr_t   port;
+    };
+    static constexpr int CONTROL_QUEUE_SIZE = 256;
+    MpscRing<QueuedControlPacket> m_controlQueue {CONTROL_QUEUE_SIZE};
+    quint64 m_controlProcessed = 0;
+    quint64 m_controlDrops = 0;
+    QList<PacketPtr_t> m_dataBurst;
+
+    void enqueueControlPacket(const PacketPtr_t &packet, const PortPtr_t &port);
+    quint64 processControlQueue();
+
+    // Data-plane bursts: routeDataPacket() puts forwarded packets in the output queue of their
+    // port and processDataPackets() hands the metrics the burst's totals once.
+    void routeDataPacket(const PacketPtr_t &packet);
+    int portIndexOf(const PortPtr_t &port) const;
+    PortPtr_t portAt(int index) const;
+    int m_burstRouterUsage = 0;
+    int m_burstHops = 0;
+    int m_burstQueueDrops = 0;
+
     const int OSPF_HELLO_INTERVAL = 10;
     const int OSPF_LSA_INTERVAL = 30;
     const int OSPF_LSA_AGE_LIMIT = 120;
@@ -235,11 +306,35 @@ private:
     bool m_isBroken;
     bool m_gotIBGP;
     void markPacketAsSeen(const PacketPtr_t  &packet);
+    void applyRouteUpdate(const PacketPtr_t &packet, const PortPtr_t &incomingPort,
+                          RoutingProtocol protocol);
+
+    // processPacket() dispatches control packets on their opcode through a table of these.
+    using ControlHandler = void (Router::*)(const PacketPtr_t &, const PortPtr_t &);
+    struct ControlDispatch
+    {
+        ControlHandler handler = nullptr;
+    };
+    static const ControlDispatch &controlDispatch(UT::PacketControlType controlType);
+
+    void handleDHCPRequest(const PacketPtr_t &packet, const PortPtr_t &incomingPort);
+    void handleDataPacket(const PacketPtr_t &packet, const PortPtr_t &incomingPort);
     std::vector<QSharedPointer<PC>> m_connectedPCs;
 
     bool                             m_workingWithDataPackets = false;
+    bool                             m_ripEnabled             = false;
+    bool                             m_ospfEnabled            = false;
+
+    static std::atomic<int> IBGPCounter;
+
+    // m_routingTable is the control plane's RIB and is only touched by the routing code. The data
+    // path reads m_fib, an immutable snapshot compiled from it and republished by publishRoutes()
+    // once a batch of route changes is complete.
+    RcuPointer<ForwardingSnapshot> m_fib;
+    bool                           m_fibDirty = true;
 
-    static int IBGPCounter;
+    void markRoutesChanged();
+    void publishRoutes();
 
     Range getRange(int ASnum) const {
         Range range = {0, 0, 0, 0};
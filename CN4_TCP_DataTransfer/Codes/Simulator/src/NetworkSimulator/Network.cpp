@@ -46,6 +46,15 @@ std::vector<QSharedPointer<Router>> Network::getAllRouters() const {
     return allRouters;
 }
 
+std::vector<QSharedPointer<PC>> Network::getAllPCs() const {
+    std::vector<QSharedPointer<PC>> allPCs;
+    for (const auto &asInstance : m_autonomousSystems) {
+        auto pcs = asInstance->getPCs();
+        allPCs.insert(allPCs.end(), pcs.begin(), pcs.end());
+    }
+    return allPCs;
+}
+
 void Network::initiateDHCPPhase()
 {
     for (const auto &asInstance : m_autonomousSystems)
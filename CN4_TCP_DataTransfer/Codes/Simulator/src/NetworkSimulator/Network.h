@@ -35,6 +35,7 @@ public:
 
     void finalizeRoutesAfterDHCP(RoutingProtocol protocol, bool bgp, RoutingProtocol protocolAS1, RoutingProtocol protocolAS2);
     std::vector<QSharedPointer<Router>> getAllRouters() const;
+    std::vector<QSharedPointer<PC>> getAllPCs() const;
     std::vector<QSharedPointer<AutonomousSystem>> getAutonomousSystems() const;
 
 private:
@@ -1,6 +1,5 @@
 #include <QFile>
 #include <QDebug>
-#include <QThread>
 #include <iostream>
 #include <QJsonArray>
 #include <QJsonObject>
@@ -13,6 +12,11 @@
 
 #include "Simulator.h"
 #include "EventsCoordinator/EventsCoordinator.h"
+#include "PortBindingManager/PortBindingManager.h"
+#include "Packet/PacketPath.h"
+#include "Packet/PacketPool.h"
+#include "Network/Router.h"
+#include "Network/PC.h"
 
 Simulator::Simulator(QObject *parent)
     : QObject(parent)
@@ -44,6 +48,81 @@ bool Simulator::loadConfig(const QString &configFilePath)
 
     QString cycleDurationStr = m_config.value("cycle_duration").toString("100ms");
     m_cycleDuration = parseDuration(cycleDurationStr);
+    EventsCoordinator::instance()->setCycleDuration(m_cycleDuration);
+
+    // 0 (the default) runs one worker per core.
+    EventsCoordinator::instance()->setWorkerCount(m_config.value("worker_threads").toInt(0));
+    PortBindingManager::setLinkCapacity(
+      m_config.value("link_capacity").toInt(PortBindingManager::DEFAULT_LINK_CAPACITY));
+    PacketPool::setCapacityPerThread(
+      m_config.value("packet_pool_size").toInt(static_cast<int>(PacketPool::DEFAULT_CAPACITY_PER_THREAD)));
+
+    // "full" (default), "sampled" (one packet in path_sample_interval) or "off".
+    QString pathRecording = m_config.value("path_recording").toString("full");
+    PacketPath::setRecording(pathRecording == "off"       ? PathRecording::Off
+                             : pathRecording == "sampled" ? PathRecording::Sampled
+                                                          : PathRecording::Full,
+                             m_config.value("path_sample_interval").toInt(64));
+
+    // Ticks between full RIP table refreshes; changes in between go out as triggered updates.
+    Router::setRipRefreshInterval(
+      m_config.value("rip_refresh_interval").toInt(Router::DEFAULT_RIP_REFRESH_INTERVAL));
+
+    // Packets a router buffers; an AS may override it with its own "router_buffer_size".
+    // "drop_tail" (default) refuses arrivals at a full buffer, "drop_head" drops the oldest packet.
+    Router::setDefaultBufferSize(m_config.value("router_buffer_size").toInt(Router::DEFAULT_BUFFER_SIZE));
+    Router::setBufferDropPolicy(m_config.value("router_buffer_policy").toString("drop_tail") == "drop_head"
+                                  ? BufferDropPolicy::DropHead
+                                  : BufferDropPolicy::DropTail);
+
+    // Output queue of every router port: "fifo" (default), "drr", "priority" or "wfq" between the
+    // eight traffic classes, port_queue_size packets shared by the classes, and port_service_rate
+    // packets put on the link per tick. port_class_weights gives the DRR/WFQ share of each class.
+    QString scheduler = m_config.value("port_scheduler").toString("fifo");
+    std::array<int, OutputQueue::CLASS_COUNT> weights;
+    weights.fill(1);
+    QJsonArray weightArray = m_config.value("port_class_weights").toArray();
+    for (int c = 0; c < OutputQueue::CLASS_COUNT && c < weightArray.size(); ++c) {
+        weights[c] = weightArray[c].toInt(1);
+    }
+    Port::setOutputDefaults(scheduler == "drr"        ? QueueScheduler::DeficitRoundRobin
+                            : scheduler == "priority" ? QueueScheduler::StrictPriority
+                            : scheduler == "wfq"      ? QueueScheduler::WeightedFair
+                                                      : QueueScheduler::Fifo,
+                            m_config.value("port_queue_size").toInt(OutputQueue::DEFAULT_CAPACITY),
+                            m_config.value("port_service_rate").toInt(Port::DEFAULT_SERVICE_RATE), weights);
+
+    // Active queue management on the output queues: "none" (default), "red" or "codel". CoDel's
+    // target and interval are durations, measured in ticks against each packet's enqueue tick.
+    AqmParameters aqm;
+    QString aqmType = m_config.value("port_aqm").toString("none");
+    aqm.type = aqmType == "red" ? AqmType::Red : aqmType == "codel" ? AqmType::CoDel : AqmType::None;
+    aqm.redMinThreshold   = m_config.value("red_min_threshold").toDouble(aqm.redMinThreshold);
+    aqm.redMaxThreshold   = m_config.value("red_max_threshold").toDouble(aqm.redMaxThreshold);
+    aqm.redMaxProbability = m_config.value("red_max_probability").toDouble(aqm.redMaxProbability);
+    aqm.redWeight         = m_config.value("red_weight").toDouble(aqm.redWeight);
+    aqm.redSeed           = static_cast<quint32>(m_config.value("red_seed").toInt(static_cast<int>(aqm.redSeed)));
+    aqm.codelTarget       = EventsCoordinator::instance()->toTicks(
+      parseDuration(m_config.value("codel_target").toString("100ms")));
+    aqm.codelInterval     = EventsCoordinator::instance()->toTicks(
+      parseDuration(m_config.value("codel_interval").toString("1s")));
+
+    // ECN: PCs send ECN-capable data and their congestion control reacts to echoed marks (DCTCP's
+    // proportional cut with "dctcp", one halving per window otherwise); output queues mark
+    // instead of dropping early, and mark every arrival once ecn_mark_threshold packets are queued.
+    bool ecn = m_config.value("ecn").toBool(false);
+    aqm.ecn              = ecn;
+    aqm.ecnMarkThreshold = m_config.value("ecn_mark_threshold").toInt(0);
+    PC::setEcnEnabled(ecn);
+    Port::setAqmDefaults(aqm);
+
+    // Congestion control of the sending PCs: "reno" (default), "dctcp", "cubic" or "bbr". A gateway
+    // can override it for its users; see TopologyBuilder::createPCs(). tcp_receive_buffer is how
+    // many segments a receiver holds out of order.
+    CongestionControl::setTickDuration(m_cycleDuration);
+    PC::setReceiveBufferSize(m_config.value("tcp_receive_buffer").toInt(TCPReceiver::DEFAULT_CAPACITY));
+    PC::setDefaultCongestionControl(
+      CongestionControl::fromString(m_config.value("congestion_control").toString("reno")));
 
     preAssignIDs();
 
@@ -169,8 +248,14 @@ void Simulator::initializeNetwork()
     QString filePath = ":/configs/mainConfig/config.json";
     m_dataGenerator->loadConfig(filePath);
 
+    int burstSize = m_config.value("pc_burst_size").toInt(1);
     for (const auto &pc : allPCs) {
         pc->setMetricsCollector(m_metricsCollector);
+        pc->setBurstSize(burstSize);
+    }
+
+    for (const auto &pc : m_network->getAllPCs()) {
+        eventsCoordinator->addPC(pc);
     }
 
     connect(m_dataGenerator.data(),
@@ -228,13 +313,76 @@ Simulator::endSimulation()
 
     eventsCoordinator->stopClock();
     eventsCoordinator->stopPacketSending();
-    eventsCoordinator->quit();
-    eventsCoordinator->wait();
+    eventsCoordinator->stopEventLoop();
+
+    qInfo() << "Simulation finished at tick" << eventsCoordinator->currentTime();
 
     if(m_metricsCollector)
     {
         m_metricsCollector->printStatistics();
     }
+
+    if(m_network)
+    {
+        quint64 totalAcked          = 0;
+        quint64 totalDelivered      = 0;
+        quint64 totalDeliveredBytes = 0;
+
+        for(const auto &asInstance : m_network->getAutonomousSystems())
+        {
+            for(const auto &router : asInstance->getRouters())
+            {
+                BufferStats stats = router->bufferStats();
+                qInfo() << "Router" << router->getId() << "buffer: capacity" << stats.capacity << "occupancy"
+                        << stats.occupancy << "high-watermark" << stats.highWatermark << "drops" << stats.drops;
+
+                OutputQueueStats queues = router->outputQueueStats();
+                qInfo() << "Router" << router->getId() << "output queues: tail drops" << queues.tailDrops
+                        << "AQM drops" << queues.aqmDrops << "ECN marks" << queues.ecnMarks
+                        << "high-watermark" << queues.highWatermark;
+
+                ControlLaneStats control = router->controlStats();
+                qInfo() << "Router" << router->getId() << "control lane: received" << control.received
+                        << "processed" << control.processed << "high-watermark" << control.highWatermark
+                        << "drops" << control.drops;
+            }
+
+            for(const auto &pc : asInstance->getPCs())
+            {
+                QMap<QString, TCPReceiverStats> receivers = pc->receiverStats();
+                for(auto it = receivers.cbegin(); it != receivers.cend(); ++it)
+                {
+                    totalDelivered += it->delivered;
+                    totalDeliveredBytes += it->deliveredBytes;
+                    qInfo() << "PC" << pc->getId() << "receiver from" << it.key() << ": received" << it->received
+                            << "delivered" << it->delivered << "bytes" << it->deliveredBytes << "out of order"
+                            << it->outOfOrder << "duplicates" << it->duplicates << "out of window"
+                            << it->outOfWindow << "reassembly high-watermark" << it->highWatermark;
+                }
+
+                TCPSenderStats sender = pc->senderStats();
+                if(sender.sent == 0) continue;
+
+                totalAcked += sender.acked;
+                qInfo() << "PC" << pc->getId() << CongestionControl::toString(sender.algorithm)
+                        << "sender: sent" << sender.sent << "retransmitted" << sender.retransmitted << "acked"
+                        << sender.acked << "fast retransmits" << sender.fastRetransmits << "timeouts"
+                        << sender.timeouts << "ECN echoes" << sender.ecnEchoes << "window cuts" << sender.windowCuts
+                        << "window" << sender.window << "ssthresh" << sender.ssthresh << "pacing rate"
+                        << sender.pacingRate << "srtt" << sender.srtt;
+            }
+        }
+
+        // Goodput: segments acknowledged end to end, and what the receivers delivered in order to the
+        // application, per tick of simulated time.
+        SimTime_t elapsed = qMax<SimTime_t>(1, eventsCoordinator->currentTime());
+        qInfo() << "TCP goodput:" << totalAcked << "segments acknowledged in" << elapsed << "ticks,"
+                << static_cast<double>(totalAcked) / elapsed << "per tick";
+        qInfo() << "Delivered in order:" << totalDelivered << "segments," << totalDeliveredBytes << "bytes,"
+                << static_cast<double>(totalDeliveredBytes) / elapsed << "bytes per tick";
+    }
+
+    QCoreApplication::quit();
 }
 
 void Simulator::startSimulation()
@@ -245,15 +393,17 @@ void Simulator::startSimulation()
     RoutingProtocol protocol = (mainAlgo == 1) ? RoutingProtocol::RIP : RoutingProtocol::OSPF;
     qDebug() << "Simulation initialized. Network topology is set up.";
 
-    // Initiate DHCP Phase for routers
+    auto eventsCoordinator = EventsCoordinator::instance();
+
+    // Initiate DHCP Phase for routers; the phase is over once no DHCP message is left in flight.
     initiateDHCPPhase();
-    QThread::sleep(5);
+    eventsCoordinator->runUntilIdle();
 
     // Initiate DHCP Phase for PCs
     if (m_network) {
         m_network->initiateDHCPPhaseForPC();
     }
-    QThread::sleep(5);
+    eventsCoordinator->runUntilIdle();
 
     // Check the assigned IP's
     checkAssignedIP();
@@ -270,7 +420,7 @@ void Simulator::startSimulation()
     }
 
     // Start the event coordinator clock so RIP ticks can begin
-    EventsCoordinator::instance()->startClock(m_cycleDuration);
+    eventsCoordinator->startClock(m_cycleDuration);
 
     // Enable RIP on all routers
     if (m_network) {
@@ -282,6 +432,9 @@ void Simulator::startSimulation()
             m_network->enableOSPFOnAllRouters();
         }
     }
+
+    // Drive the simulation from the application's event loop once it is up.
+    QMetaObject::invokeMethod(eventsCoordinator, &EventsCoordinator::runEventLoop, Qt::QueuedConnection);
 }
 
 void Simulator::onConvergenceDetected()
@@ -309,7 +462,8 @@ void Simulator::onConvergenceDetected()
                 this,
                 &Simulator::endSimulation);
 
-        QTimer::singleShot(5'000, this, [this]() { initiatePacketSending(); });
+        eventsCoordinator->scheduleIn(eventsCoordinator->toTicks(std::chrono::milliseconds(5'000)),
+                                      [this]() { initiatePacketSending(); });
 
         // initiatePacketSending();
 
@@ -325,11 +479,13 @@ void Simulator::onConvergenceDetected()
 
     if (useBGP) {
         qDebug() << "BGP is enabled. Delaying execution of convergence actions.";
+        auto eventsCoordinator = EventsCoordinator::instance();
         m_network->startEBGP();
-        QTimer::singleShot(3000, this, [this]() {
+        eventsCoordinator->scheduleIn(eventsCoordinator->toTicks(std::chrono::milliseconds(3000)), [this]() {
             m_network->startIBGP();
         });
-        QTimer::singleShot(5000, this, executeConvergenceActions);
+        eventsCoordinator->scheduleIn(eventsCoordinator->toTicks(std::chrono::milliseconds(5000)),
+                                      executeConvergenceActions);
     }
     else {
         qDebug() << "BGP is not enabled. Executing convergence actions immediately.";
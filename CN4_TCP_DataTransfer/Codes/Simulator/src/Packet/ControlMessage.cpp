@@ -0,0 +1,282 @@
+#include "ControlMessage.h"
+
+namespace
+{
+constexpr quint8 WIRE_VERSION = 0xC1;
+constexpr int    HEADER_SIZE  = 12;
+constexpr int    RECORD_SIZE  = 8;
+
+void
+putU16(char *out, quint16 value)
+{
+    out[0] = static_cast<char>(value >> 8);
+    out[1] = static_cast<char>(value);
+}
+
+void
+putU32(char *out, quint32 value)
+{
+    out[0] = static_cast<char>(value >> 24);
+    out[1] = static_cast<char>(value >> 16);
+    out[2] = static_cast<char>(value >> 8);
+    out[3] = static_cast<char>(value);
+}
+
+quint16
+getU16(const char *in)
+{
+    const auto *bytes = reinterpret_cast<const quint8 *>(in);
+    return static_cast<quint16>((bytes[0] << 8) | bytes[1]);
+}
+
+quint32
+getU32(const char *in)
+{
+    const auto *bytes = reinterpret_cast<const quint8 *>(in);
+    return (quint32(bytes[0]) << 24) | (quint32(bytes[1]) << 16) | (quint32(bytes[2]) << 8) |
+           quint32(bytes[3]);
+}
+}    // namespace
+
+ControlMessageWriter::ControlMessageWriter(UT::PacketControlType type, quint32 origin,
+                                           quint32 sequence, int expectedRecords) :
+    m_recordCount(0)
+{
+    m_bytes.reserve(HEADER_SIZE + expectedRecords * RECORD_SIZE);
+    m_bytes.resize(HEADER_SIZE);
+
+    char *header = m_bytes.data();
+    header[0]    = static_cast<char>(WIRE_VERSION);
+    header[1]    = static_cast<char>(type);
+    putU16(header + 2, 0);
+    putU32(header + 4, origin);
+    putU32(header + 8, sequence);
+}
+
+void
+ControlMessageWriter::addRecord(const ControlRecord &record)
+{
+    addRecord(record.prefix, record.prefixLength, record.metric, record.flags);
+}
+
+void
+ControlMessageWriter::addRecord(quint32 prefix, quint8 prefixLength, quint8 metric, quint16 flags)
+{
+    qsizetype offset = m_bytes.size();
+    m_bytes.resize(offset + RECORD_SIZE);
+
+    char *out = m_bytes.data() + offset;
+    putU32(out, prefix);
+    out[4] = static_cast<char>(prefixLength);
+    out[5] = static_cast<char>(metric);
+    putU16(out + 6, flags);
+
+    ++m_recordCount;
+}
+
+void
+ControlMessageWriter::addRoute(const QString &destination, const QString &mask, int metric)
+{
+    quint16 flags  = 0;
+    quint32 prefix = ControlAddress::fromString(destination, &flags);
+    addRecord(prefix, ControlAddress::maskToPrefixLength(mask),
+              static_cast<quint8>(qBound(0, metric, 255)), flags);
+}
+
+void
+ControlMessageWriter::addAddress(const QString &address)
+{
+    quint16 flags  = 0;
+    quint32 prefix = ControlAddress::fromString(address, &flags);
+    addRecord(prefix, 32, 0, flags);
+}
+
+int
+ControlMessageWriter::recordCount() const
+{
+    return m_recordCount;
+}
+
+QByteArray
+ControlMessageWriter::finish()
+{
+    putU16(m_bytes.data() + 2, static_cast<quint16>(m_recordCount));
+    m_recordCount = 0;
+    return std::move(m_bytes);
+}
+
+QByteArray
+ControlMessageWriter::withRecordMetric(const QByteArray &message, const QList<int> &records,
+                                       quint8 metric)
+{
+    QByteArray patched(message.constData(), message.size());
+    const int  count = patched.size() >= HEADER_SIZE ? getU16(patched.constData() + 2) : 0;
+
+    for(int index : records)
+    {
+        if(index < 0 || index >= count) continue;
+        patched.data()[HEADER_SIZE + index * RECORD_SIZE + 5] = static_cast<char>(metric);
+    }
+
+    return patched;
+}
+
+ControlMessageReader::ControlMessageReader(const QByteArray &bytes) :
+    m_bytes(bytes),
+    m_valid(false)
+{
+    if(m_bytes.size() < HEADER_SIZE) return;
+    if(static_cast<quint8>(m_bytes.constData()[0]) != WIRE_VERSION) return;
+    if(static_cast<quint8>(m_bytes.constData()[1]) >=
+       static_cast<quint8>(UT::PacketControlType::Count))
+        return;
+
+    m_valid = m_bytes.size() >= HEADER_SIZE + getU16(m_bytes.constData() + 2) * RECORD_SIZE;
+}
+
+bool
+ControlMessageReader::isValid() const
+{
+    return m_valid;
+}
+
+UT::PacketControlType
+ControlMessageReader::type() const
+{
+    return m_valid ? static_cast<UT::PacketControlType>(m_bytes.constData()[1])
+                   : UT::PacketControlType::None;
+}
+
+quint32
+ControlMessageReader::origin() const
+{
+    return m_valid ? getU32(m_bytes.constData() + 4) : 0;
+}
+
+quint32
+ControlMessageReader::sequence() const
+{
+    return m_valid ? getU32(m_bytes.constData() + 8) : 0;
+}
+
+int
+ControlMessageReader::recordCount() const
+{
+    return m_valid ? getU16(m_bytes.constData() + 2) : 0;
+}
+
+ControlRecord
+ControlMessageReader::record(int index) const
+{
+    ControlRecord record;
+    if(index < 0 || index >= recordCount()) return record;
+
+    const char *in      = m_bytes.constData() + HEADER_SIZE + index * RECORD_SIZE;
+    record.prefix       = getU32(in);
+    record.prefixLength = static_cast<quint8>(in[4]);
+    record.metric       = static_cast<quint8>(in[5]);
+    record.flags        = getU16(in + 6);
+    return record;
+}
+
+QString
+ControlMessageReader::originAddress() const
+{
+    return ControlAddress::toString(origin());
+}
+
+QString
+ControlMessageReader::recordAddress(int index) const
+{
+    ControlRecord entry = record(index);
+    return ControlAddress::toString(entry.prefix, entry.flags);
+}
+
+quint32
+ControlAddress::fromString(const QString &address, quint16 *flags)
+{
+    static const QString mappedPrefix = QStringLiteral("::ffff:");
+
+    qsizetype i      = 0;
+    quint16   parsed = 0;
+    if(address.startsWith(mappedPrefix))
+    {
+        i      = mappedPrefix.size();
+        parsed = ControlRecord::FLAG_IPV4_MAPPED_IPV6;
+    }
+
+    quint32 value  = 0;
+    quint32 octet  = 0;
+    int     octets = 0;
+
+    for(; i <= address.size(); ++i)
+    {
+        QChar c = i < address.size() ? address.at(i) : QChar('.');
+        if(c.isDigit())
+        {
+            octet = octet * 10 + static_cast<quint32>(c.digitValue());
+        }
+        else if(c == QChar('.'))
+        {
+            value = (value << 8) | (octet & 0xFF);
+            octet = 0;
+            ++octets;
+        }
+        else if(c == QChar('x'))
+        {
+            parsed |= ControlRecord::FLAG_WILDCARD_HOST;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    if(octets < 4) value <<= 8 * (4 - octets);
+
+    if(flags) *flags = parsed;
+    return value;
+}
+
+QString
+ControlAddress::toString(quint32 address, quint16 flags)
+{
+    QString text;
+    text.reserve(22);
+
+    if(flags & ControlRecord::FLAG_IPV4_MAPPED_IPV6) text.append(QStringLiteral("::ffff:"));
+
+    text.append(QString::number((address >> 24) & 0xFF));
+    text.append(QChar('.'));
+    text.append(QString::number((address >> 16) & 0xFF));
+    text.append(QChar('.'));
+    text.append(QString::number((address >> 8) & 0xFF));
+    text.append(QChar('.'));
+
+    if(flags & ControlRecord::FLAG_WILDCARD_HOST)
+        text.append(QStringLiteral("xx"));
+    else
+        text.append(QString::number(address & 0xFF));
+
+    return text;
+}
+
+quint8
+ControlAddress::maskToPrefixLength(const QString &mask)
+{
+    quint32 bits   = fromString(mask);
+    quint8  length = 0;
+    while(length < 32 && (bits & (0x80000000u >> length)))
+    {
+        ++length;
+    }
+
+    return length;
+}
+
+QString
+ControlAddress::prefixLengthToMask(quint8 prefixLength)
+{
+    quint32 bits = prefixLength >= 32 ? 0xFFFFFFFFu : ~(0xFFFFFFFFu >> prefixLength);
+    return toString(bits);
+}
@@ -0,0 +1,95 @@
+#ifndef CONTROLMESSAGE_H
+#define CONTROLMESSAGE_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+#include "../Globals/Globals.h"
+
+/**
+ * Binary wire format of the control-plane messages (RIP, EBGP, IBGP, OSPF and DHCP).
+ *
+ *   header (12 bytes): u8 version | u8 type (UT::PacketControlType) | u16 record count
+ *                      | u32 origin address | u32 sequence number
+ *   record  (8 bytes): u32 prefix | u8 prefix length | u8 metric | u16 flags
+ *
+ * All fields are big-endian. Route updates carry one record per route, LSAs one record per
+ * neighbour, a DHCP offer one record with the offered address; DHCP messages use the sequence
+ * number as the transaction id (the client id).
+ */
+struct ControlRecord
+{
+    static constexpr quint16 FLAG_IPV4_MAPPED_IPV6 = 0x0001;
+    static constexpr quint16 FLAG_WILDCARD_HOST    = 0x0002;
+
+    quint32 prefix       = 0;
+    quint8  prefixLength = 32;
+    quint8  metric       = 0;
+    quint16 flags        = 0;
+};
+
+class ControlMessageWriter
+{
+public:
+    ControlMessageWriter(UT::PacketControlType type, quint32 origin, quint32 sequence = 0,
+                         int expectedRecords = 0);
+
+    void       addRecord(const ControlRecord &record);
+    void       addRecord(quint32 prefix, quint8 prefixLength, quint8 metric, quint16 flags = 0);
+    void       addRoute(const QString &destination, const QString &mask, int metric);
+    void       addAddress(const QString &address);
+    int        recordCount() const;
+
+    /** Returns the encoded message; the writer is empty afterwards. */
+    QByteArray finish();
+
+    /**
+     * Returns a copy of an encoded message with the metric of the given records replaced. The
+     * original is left untouched, so other holders of it keep sharing its bytes.
+     */
+    static QByteArray withRecordMetric(const QByteArray &message, const QList<int> &records,
+                                       quint8 metric);
+
+private:
+    QByteArray m_bytes;
+    int        m_recordCount;
+};
+
+/**
+ * Reads a message in place: the payload is shared, not copied, and records are decoded on access.
+ */
+class ControlMessageReader
+{
+public:
+    explicit ControlMessageReader(const QByteArray &bytes);
+
+    bool                  isValid() const;
+    UT::PacketControlType type() const;
+    quint32               origin() const;
+    quint32               sequence() const;
+    int                   recordCount() const;
+    ControlRecord         record(int index) const;
+
+    QString               originAddress() const;
+    QString               recordAddress(int index) const;
+
+private:
+    QByteArray m_bytes;
+    bool       m_valid;
+};
+
+/**
+ * Conversions between the dotted addresses kept in the routing table and the wire form.
+ * The "xx" host part of "a.b.c.xx" and the "::ffff:" prefix of IPv4-mapped IPv6 addresses travel
+ * as record flags so the strings come back unchanged.
+ */
+namespace ControlAddress
+{
+quint32 fromString(const QString &address, quint16 *flags = nullptr);
+QString toString(quint32 address, quint16 flags = 0);
+quint8  maskToPrefixLength(const QString &mask);
+QString prefixLengthToMask(quint8 prefixLength);
+}    // namespace ControlAddress
+
+#endif    // CONTROLMESSAGE_H
@@ -1,9 +1,10 @@
 #include "Packet.h"
 
-qint64 Packet::s_nextId = 0;
+std::atomic<qint64> Packet::s_nextId {0};
 
 Packet::Packet(PacketType type, const QByteArray &payload) :
     m_type(type),
+    m_controlType(UT::PacketControlType::None),
     m_payload(payload),
     m_waitCycles(0),
     m_queueWaitCycles(0),
@@ -11,14 +12,18 @@ Packet::Packet(PacketType type, const QByteArray &payload) :
     m_isDropped(false),
     m_dataLinkHeader(),
     m_tcpHeader(),
-    m_ttl(10),    // Default TTL for all packets
-    m_id(++s_nextId)
+    m_ttl(DEFAULT_TTL),    // Default TTL for all packets
+    m_id(++s_nextId),
+    m_waitingCycle(0),
+    m_totalCycle(0),
+    m_isWantedIpV6(false),
+    m_recordPath(PacketPath::shouldRecord(m_id))
 {
-    m_isWantedIpV6 = false;
 }
 
 Packet::Packet(PacketType type, const QByteArray &payload, int ttl) :
     m_type(type),
+    m_controlType(UT::PacketControlType::None),
     m_payload(payload),
     m_waitCycles(0),
     m_queueWaitCycles(0),
@@ -27,9 +32,38 @@ Packet::Packet(PacketType type, const QByteArray &payload, int ttl) :
     m_dataLinkHeader(),
     m_tcpHeader(),
     m_ttl(ttl),
-    m_id(++s_nextId)
+    m_id(++s_nextId),
+    m_waitingCycle(0),
+    m_totalCycle(0),
+    m_isWantedIpV6(false),
+    m_recordPath(PacketPath::shouldRecord(m_id))
 {
-    m_isWantedIpV6 = false;
+}
+
+void
+Packet::reset(PacketType type, const QByteArray &payload, int ttl)
+{
+    m_type            = type;
+    m_controlType     = UT::PacketControlType::None;
+    m_payload         = payload;
+    m_path.clear();
+    m_waitCycles      = 0;
+    m_queueWaitCycles = 0;
+    m_sequenceNumber  = 0;
+    m_isDropped       = false;
+    m_dataLinkHeader  = DataLinkHeader();
+    m_tcpHeader       = TCPHeader();
+    m_ttl             = ttl;
+    m_id              = ++s_nextId;
+    m_waitingCycle    = 0;
+    m_totalCycle      = 0;
+    m_pathTaken.clear();
+    m_isWantedIpV6    = false;
+    m_recordPath      = PacketPath::shouldRecord(m_id);
+    m_trafficClass    = 0;
+    m_ecn             = EcnCodepoint::NotEct;
+    m_destinationIP.reset();
+    m_sourceIP.reset();
 }
 
 void
@@ -47,13 +81,19 @@ Packet::getPayload() const
 void
 Packet::addToPath(const QString &routerIP)
 {
-    m_path.append(routerIP);
+    if(m_recordPath) m_path.append(routerIP);
+}
+
+void
+Packet::addToPath(quint16 addressIndex)
+{
+    if(m_recordPath) m_path.append(addressIndex);
 }
 
 QVector<QString>
 Packet::getPath() const
 {
-    return m_path;
+    return m_path.toAddresses();
 }
 
 void
@@ -1,13 +1,16 @@
 #ifndef PACKET_H
 #define PACKET_H
 
+#include "../Globals/Globals.h"
 #include "../Header/DataLinkHeader.h"
 #include "../Header/TCPHeader.h"
 #include "IP/IP.h"
+#include "PacketPath.h"
 
 #include <QSharedPointer>
 #include <QString>
 #include <QVector>
+#include <atomic>
 
 enum class PacketType
 {
@@ -21,17 +24,36 @@ enum class PacketType
     Custom
 };
 
+// ECN codepoint of the IP header (RFC 3168): whether the sender is ECN-capable and whether a router
+// marked the packet instead of dropping it.
+enum class EcnCodepoint : quint8
+{
+    NotEct = 0,
+    Ect1   = 1,
+    Ect0   = 2,
+    Ce     = 3    // congestion experienced
+};
+
 class Packet
 {
 public:
+    static constexpr int DEFAULT_TTL = 10;
+
     explicit Packet(PacketType type = PacketType::Data, const QByteArray &payload = "");
     Packet(PacketType type, const QByteArray &payload, int ttl);    // New constructor
 
+    // Turns a recycled packet into a fresh one, keeping the capacity of its buffers (see PacketPool).
+    void             reset(PacketType type, const QByteArray &payload, int ttl);
+
     void             setPayload(const QByteArray &payload);
     QByteArray       getPayload() const;
 
-    void             addToPath(const QString &routerIP);
-    QVector<QString> getPath() const;
+    // Path recording is skipped for packets PacketPath::shouldRecord() leaves out.
+    void              addToPath(const QString &routerIP);
+    void              addToPath(quint16 addressIndex);
+    QVector<QString>  getPath() const;
+    const PacketPath &path() const { return m_path; }
+    bool              isRecordingPath() const { return m_recordPath; }
 
     void             incrementWaitCycles();
     size_t           getWaitCycles() const;
@@ -60,7 +82,7 @@ public:
     QString
     getPathTaken()
     {
-        return m_pathTaken;
+        return m_pathTaken.toString();
     }
 
     void
@@ -75,10 +97,24 @@ public:
         m_waitingCycle++;
     }
 
+    // Ticks spent in a router's output queue count as both waiting and total cycles.
     void
-    addToPathTaken(QString path)
+    addQueueingCycles(size_t cycles)
     {
-        m_pathTaken.append("-->" + path);
+        m_waitingCycle += cycles;
+        m_totalCycle += cycles;
+    }
+
+    void
+    addToPathTaken(const QString &path)
+    {
+        if(m_recordPath) m_pathTaken.append(path);
+    }
+
+    void
+    addToPathTaken(quint16 addressIndex)
+    {
+        if(m_recordPath) m_pathTaken.append(addressIndex);
     }
 
     bool
@@ -88,6 +124,29 @@ public:
     }
 
     PacketType     getType() const;
+
+    // Opcode of control packets, set by the sender; None for data packets.
+    UT::PacketControlType controlType() const { return m_controlType; }
+    void                  setControlType(UT::PacketControlType controlType) { m_controlType = controlType; }
+
+    // Traffic class 0 (best effort) to 7, picked by the sender; selects the output queue class.
+    int                   trafficClass() const { return m_trafficClass; }
+    void                  setTrafficClass(int trafficClass) { m_trafficClass = static_cast<quint8>(qBound(0, trafficClass, 7)); }
+
+    EcnCodepoint          ecn() const { return m_ecn; }
+    void                  setEcn(EcnCodepoint ecn) { m_ecn = ecn; }
+    bool                  isEcnCapable() const { return m_ecn != EcnCodepoint::NotEct; }
+    bool                  isCongestionExperienced() const { return m_ecn == EcnCodepoint::Ce; }
+
+    // Routers mark ECN-capable packets instead of dropping them; returns false for Not-ECT packets.
+    bool
+    markCongestionExperienced()
+    {
+        if(m_ecn == EcnCodepoint::NotEct) return false;
+        m_ecn = EcnCodepoint::Ce;
+        return true;
+    }
+
     size_t        *getWaitCyclesPtr();
 
     // TTL methods
@@ -112,10 +171,11 @@ public:
     void               setSourceIP(QSharedPointer<IP> newSourceIP);
 
 private:
-    static qint64    s_nextId;
+    static std::atomic<qint64> s_nextId;
     PacketType       m_type;
+    UT::PacketControlType m_controlType;
     QByteArray       m_payload;
-    QVector<QString> m_path;
+    PacketPath       m_path;
     size_t           m_waitCycles;
     size_t           m_queueWaitCycles;
     int              m_sequenceNumber;
@@ -126,8 +186,11 @@ private:
     qint64           m_id;
     size_t           m_waitingCycle;
     size_t           m_totalCycle;
-    QString          m_pathTaken;
+    PacketPath       m_pathTaken;
     bool             m_isWantedIpV6;
+    bool             m_recordPath;
+    quint8           m_trafficClass = 0;
+    EcnCodepoint     m_ecn          = EcnCodepoint::NotEct;
 
     QSharedPointer<IP> m_destinationIP;
     QSharedPointer<IP> m_sourceIP;
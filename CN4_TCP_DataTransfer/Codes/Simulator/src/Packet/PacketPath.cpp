@@ -0,0 +1,139 @@
+#include "PacketPath.h"
+
+#include <QHash>
+#include <QReadWriteLock>
+#include <atomic>
+
+namespace
+{
+struct AddressTable
+{
+    QReadWriteLock          lock;
+    QHash<QString, quint16> indices;
+    QVector<QString>        addresses;
+};
+
+AddressTable &
+addressTable()
+{
+    static AddressTable table;
+    return table;
+}
+
+std::atomic<PathRecording> s_recording {PathRecording::Full};
+std::atomic<int>           s_sampleInterval {64};
+}    // namespace
+
+quint16
+PacketPath::indexOf(const QString &address)
+{
+    AddressTable &table = addressTable();
+
+    {
+        QReadLocker locker(&table.lock);
+        auto        it = table.indices.constFind(address);
+        if(it != table.indices.constEnd()) return it.value();
+    }
+
+    QWriteLocker locker(&table.lock);
+    auto         it = table.indices.constFind(address);
+    if(it != table.indices.constEnd()) return it.value();
+
+    quint16 index = static_cast<quint16>(table.addresses.size());
+    table.addresses.append(address);
+    table.indices.insert(address, index);
+    return index;
+}
+
+QString
+PacketPath::addressAt(quint16 index)
+{
+    AddressTable &table = addressTable();
+    QReadLocker   locker(&table.lock);
+    return index < table.addresses.size() ? table.addresses.at(index) : QString();
+}
+
+void
+PacketPath::setRecording(PathRecording mode, int sampleInterval)
+{
+    s_recording.store(mode, std::memory_order_relaxed);
+    s_sampleInterval.store(qMax(1, sampleInterval), std::memory_order_relaxed);
+}
+
+PathRecording
+PacketPath::recording()
+{
+    return s_recording.load(std::memory_order_relaxed);
+}
+
+int
+PacketPath::sampleInterval()
+{
+    return s_sampleInterval.load(std::memory_order_relaxed);
+}
+
+bool
+PacketPath::shouldRecord(qint64 packetId)
+{
+    switch(recording())
+    {
+        case PathRecording::Full:
+            return true;
+        case PathRecording::Sampled:
+            return packetId % sampleInterval() == 0;
+        case PathRecording::Off:
+            break;
+    }
+
+    return false;
+}
+
+void
+PacketPath::append(quint16 index)
+{
+    if(m_size < MAX_HOPS)
+        m_hops[m_size++] = index;
+    else
+        m_truncated = true;
+}
+
+void
+PacketPath::append(const QString &address)
+{
+    append(indexOf(address));
+}
+
+void
+PacketPath::clear()
+{
+    m_size      = 0;
+    m_truncated = false;
+}
+
+QVector<QString>
+PacketPath::toAddresses() const
+{
+    QVector<QString> addresses;
+    addresses.reserve(m_size);
+
+    for(int i = 0; i < m_size; ++i)
+    {
+        addresses.append(addressAt(m_hops[i]));
+    }
+
+    return addresses;
+}
+
+QString
+PacketPath::toString(const QString &separator) const
+{
+    QString path;
+
+    for(int i = 0; i < m_size; ++i)
+    {
+        path.append(separator);
+        path.append(addressAt(m_hops[i]));
+    }
+
+    return path;
+}
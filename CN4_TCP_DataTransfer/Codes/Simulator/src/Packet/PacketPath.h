@@ -0,0 +1,57 @@
+#ifndef PACKETPATH_H
+#define PACKETPATH_H
+
+#include <QString>
+#include <QVector>
+#include <array>
+
+enum class PathRecording
+{
+    Off,
+    Sampled,
+    Full
+};
+
+/**
+ * The hops a packet went through, stored inline as 16-bit address indices.
+ *
+ * Addresses are interned once in a process-wide table; recording a hop is then a single store
+ * into the packet, and the string form is only built when someone asks for it. Paths longer than
+ * MAX_HOPS keep their first MAX_HOPS entries and are flagged as truncated.
+ *
+ * Whether packets record their path at all is a global setting: Full records every packet,
+ * Sampled one in sampleInterval() packets (by packet id) and Off none.
+ */
+class PacketPath
+{
+public:
+    static constexpr int MAX_HOPS = 32;
+
+    static quint16       indexOf(const QString &address);
+    static QString       addressAt(quint16 index);
+
+    static void          setRecording(PathRecording mode, int sampleInterval = 64);
+    static PathRecording recording();
+    static int           sampleInterval();
+    static bool          shouldRecord(qint64 packetId);
+
+    void                 append(quint16 index);
+    void                 append(const QString &address);
+    void                 clear();
+
+    int                  size() const { return m_size; }
+    bool                 isEmpty() const { return m_size == 0; }
+    bool                 isTruncated() const { return m_truncated; }
+    quint16              at(int i) const { return m_hops[i]; }
+
+    QVector<QString>     toAddresses() const;
+    /** Every hop preceded by @p separator, e.g. "-->192.168.100.1-->192.168.100.2". */
+    QString              toString(const QString &separator = "-->") const;
+
+private:
+    std::array<quint16, MAX_HOPS> m_hops {};
+    quint8                        m_size      = 0;
+    bool                          m_truncated = false;
+};
+
+#endif    // PACKETPATH_H
@@ -0,0 +1,124 @@
+#include "PacketPool.h"
+
+thread_local PacketPool::FreeList PacketPool::t_freeList;
+thread_local bool                 PacketPool::t_freeListAlive = true;
+
+PacketPool::FreeList::~FreeList()
+{
+    // Packets released after this point (e.g. during static destruction) are deleted directly.
+    t_freeListAlive = false;
+
+    for(Packet *packet : packets)
+    {
+        delete packet;
+    }
+}
+
+PacketPtr_t
+PacketPool::acquire(PacketType type, const QByteArray &payload)
+{
+    Packet *packet = take();
+    if(packet)
+        packet->reset(type, payload, Packet::DEFAULT_TTL);
+    else
+        packet = new Packet(type, payload);
+
+    return wrap(packet);
+}
+
+PacketPtr_t
+PacketPool::acquire(PacketType type, const QByteArray &payload, int ttl)
+{
+    Packet *packet = take();
+    if(packet)
+        packet->reset(type, payload, ttl);
+    else
+        packet = new Packet(type, payload, ttl);
+
+    return wrap(packet);
+}
+
+PacketPtr_t
+PacketPool::acquire(UT::PacketControlType controlType, PacketType type, const QByteArray &payload,
+                    int ttl)
+{
+    PacketPtr_t packet = acquire(type, payload, ttl);
+    packet->setControlType(controlType);
+    return packet;
+}
+
+PacketPtr_t
+PacketPool::acquire(const Packet &other)
+{
+    Packet *packet = take();
+    if(packet)
+        *packet = other;
+    else
+        packet = new Packet(other);
+
+    return wrap(packet);
+}
+
+void
+PacketPool::setCapacityPerThread(size_t capacity)
+{
+    s_capacityPerThread.store(capacity, std::memory_order_relaxed);
+}
+
+size_t
+PacketPool::capacityPerThread()
+{
+    return s_capacityPerThread.load(std::memory_order_relaxed);
+}
+
+quint64
+PacketPool::hits()
+{
+    return s_hits.load(std::memory_order_relaxed);
+}
+
+quint64
+PacketPool::misses()
+{
+    return s_misses.load(std::memory_order_relaxed);
+}
+
+void
+PacketPool::resetCounters()
+{
+    s_hits.store(0, std::memory_order_relaxed);
+    s_misses.store(0, std::memory_order_relaxed);
+}
+
+Packet *
+PacketPool::take()
+{
+    if(!t_freeListAlive || t_freeList.packets.empty())
+    {
+        s_misses.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    Packet *packet = t_freeList.packets.back();
+    t_freeList.packets.pop_back();
+    s_hits.fetch_add(1, std::memory_order_relaxed);
+    return packet;
+}
+
+PacketPtr_t
+PacketPool::wrap(Packet *packet)
+{
+    return PacketPtr_t(packet, &PacketPool::release);
+}
+
+void
+PacketPool::release(Packet *packet)
+{
+    if(!t_freeListAlive || t_freeList.packets.size() >= capacityPerThread())
+    {
+        delete packet;
+        return;
+    }
+
+    t_freeList.packets.push_back(packet);
+}
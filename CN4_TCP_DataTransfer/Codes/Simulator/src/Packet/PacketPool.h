@@ -0,0 +1,58 @@
+#ifndef PACKETPOOL_H
+#define PACKETPOOL_H
+
+#include "Packet.h"
+
+#include <atomic>
+#include <vector>
+
+/**
+ * Recycles Packet objects instead of returning them to the heap.
+ *
+ * Every thread keeps its own free list, so acquiring and releasing never take a lock. A packet
+ * goes back to the list of the thread that drops its last reference, which is usually the worker
+ * that consumed it. A recycled packet keeps the capacity of its payload, path and header buffers.
+ * The hit and miss counters show how many acquisitions were served from a free list and how many
+ * had to allocate; use them to size the pool with setCapacityPerThread().
+ */
+class PacketPool
+{
+public:
+    static constexpr size_t DEFAULT_CAPACITY_PER_THREAD = 4'096;
+
+    static PacketPtr_t acquire(PacketType type = PacketType::Data, const QByteArray &payload = "");
+    static PacketPtr_t acquire(PacketType type, const QByteArray &payload, int ttl);
+    static PacketPtr_t acquire(const Packet &other);
+
+    // Control packets: the opcode travels in the packet, so receivers never inspect the payload to
+    // classify them.
+    static PacketPtr_t acquire(UT::PacketControlType controlType, PacketType type,
+                               const QByteArray &payload, int ttl = Packet::DEFAULT_TTL);
+
+    static void        setCapacityPerThread(size_t capacity);
+    static size_t      capacityPerThread();
+
+    static quint64     hits();
+    static quint64     misses();
+    static void        resetCounters();
+
+private:
+    struct FreeList
+    {
+        ~FreeList();
+        std::vector<Packet *> packets;
+    };
+
+    static Packet     *take();
+    static PacketPtr_t wrap(Packet *packet);
+    static void        release(Packet *packet);
+
+    static thread_local FreeList t_freeList;
+    static thread_local bool     t_freeListAlive;
+
+    inline static std::atomic<size_t>  s_capacityPerThread {DEFAULT_CAPACITY_PER_THREAD};
+    inline static std::atomic<quint64> s_hits {0};
+    inline static std::atomic<quint64> s_misses {0};
+};
+
+#endif    // PACKETPOOL_H
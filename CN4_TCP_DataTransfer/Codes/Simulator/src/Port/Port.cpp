@@ -3,6 +3,7 @@
 #include "Port.h"
 #include "../Network/PC.h"
 #include "../Network/Router.h"
+#include "../Packet/PacketPool.h"
 #include "../NetworkSimulator/Simulator.h"
 #include "../NetworkSimulator/ApplicationContext.h"
 
@@ -11,11 +12,18 @@ Port::Port(QObject *parent) :
     m_number(0),
     m_numberOfPacketsSent(0),
     m_numberOfPacketsReceived(0),
+    m_numberOfPacketsBlocked(0),
     m_routerIP(""),
     m_isConnected(false),
     m_connectedPC(nullptr),
-    m_connectedRouterIP(" ")
-{}
+    m_connectedRouterIP(" "),
+    m_outputQueue(s_defaultScheduler, s_defaultQueueSize),
+    m_serviceRate(s_defaultServiceRate)
+{
+    m_rxBurst.reserve(MAX_BURST_SIZE);
+    m_outputQueue.setWeights(s_defaultWeights);
+    m_outputQueue.setAqm(s_defaultAqm);
+}
 
 Port::~Port() {}
 
@@ -57,43 +65,147 @@ void Port::setConnected(bool connected)
 
 uint64_t Port::getNumberOfPacketsSent() const
 {
-    QMutexLocker locker(&m_mutex);
-    return m_numberOfPacketsSent;
+    return m_numberOfPacketsSent.load(std::memory_order_relaxed);
 }
 
 uint64_t Port::getNumberOfPacketsReceived() const
 {
-    QMutexLocker locker(&m_mutex);
-    return m_numberOfPacketsReceived;
+    return m_numberOfPacketsReceived.load(std::memory_order_relaxed);
+}
+
+uint64_t Port::getNumberOfPacketsBlocked() const
+{
+    return m_numberOfPacketsBlocked.load(std::memory_order_relaxed);
 }
 
-void Port::sendPacket(const PacketPtr_t &data) {
-    {
-        QMutexLocker locker(&m_mutex);
-        ++m_numberOfPacketsSent;
+bool Port::sendPacket(const PacketPtr_t &data) {
+    if (m_txRing) {
+        // Control packets are flooded through several ports at once; give each link its own copy
+        // so neighbours handling them on different workers never share one object.
+        bool pushed = data->getType() == PacketType::Data ? m_txRing->push(data)
+                                                           : m_txRing->push(PacketPool::acquire(*data));
+        if (!pushed) {
+            m_numberOfPacketsBlocked.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
     }
+
+    m_numberOfPacketsSent.fetch_add(1, std::memory_order_relaxed);
     emit packetSent(data);
     // qDebug() << "Port::sendPacket() emitted packetSent.";
+    return true;
 }
 
-void
-Port::sendPackets(const QList<PacketPtr_t> &packets)
-{
-    for(const auto &packet : packets)
-    {
-        sendPacket(packet);
+int Port::sendPackets(const QList<PacketPtr_t> &packets) {
+    // One free-space check, one counter update and one signal for the whole burst; whatever does
+    // not fit is counted as blocked and left to the caller.
+    int accepted = static_cast<int>(packets.size());
+
+    if (m_txRing) {
+        accepted = static_cast<int>(qMin<size_t>(m_txRing->freeSlots(), packets.size()));
+
+        for (int i = 0; i < accepted; ++i) {
+            const PacketPtr_t &data = packets[i];
+            m_txRing->push(data->getType() == PacketType::Data ? data : PacketPool::acquire(*data));
+        }
+
+        if (accepted < packets.size()) {
+            m_numberOfPacketsBlocked.fetch_add(packets.size() - accepted, std::memory_order_relaxed);
+        }
     }
+
+    if (accepted == 0) return 0;
+
+    m_numberOfPacketsSent.fetch_add(accepted, std::memory_order_relaxed);
+    emit packetsSent(accepted == packets.size() ? packets : packets.first(accepted));
+    return accepted;
 }
 
 void Port::receivePacket(const PacketPtr_t &data) {
-    {
-        QMutexLocker locker(&m_mutex);
-        ++m_numberOfPacketsReceived;
-    }
+    m_numberOfPacketsReceived.fetch_add(1, std::memory_order_relaxed);
     emit packetReceived(data);
     // qDebug() << "Port::receivePacket() emitted packetReceived.";
 }
 
+void Port::attachLink(const PacketRingPtr_t &tx, const PacketRingPtr_t &rx)
+{
+    m_txRing = tx;
+    m_rxRing = rx;
+}
+
+void Port::detachLink()
+{
+    m_txRing.reset();
+    m_rxRing.reset();
+}
+
+bool Port::canSend(size_t count)
+{
+    return !m_txRing || m_txRing->freeSlots() >= count;
+}
+
+quint64 Port::flush()
+{
+    return m_txRing ? m_txRing->publish() : 0;
+}
+
+void Port::setOutputDefaults(QueueScheduler scheduler, int queueSize, int serviceRate,
+                             const std::array<int, OutputQueue::CLASS_COUNT> &weights)
+{
+    s_defaultScheduler   = scheduler;
+    s_defaultQueueSize   = qMax(1, queueSize);
+    s_defaultServiceRate = qMax(1, serviceRate);
+    s_defaultWeights     = weights;
+}
+
+void Port::setAqmDefaults(const AqmParameters &parameters)
+{
+    s_defaultAqm = parameters;
+}
+
+void Port::setServiceRate(int packetsPerTick)
+{
+    m_serviceRate = qMax(1, packetsPerTick);
+}
+
+void Port::seedAqm(int routerId)
+{
+    std::seed_seq sequence {s_defaultAqm.redSeed, static_cast<quint32>(routerId), static_cast<quint32>(getPortNumber())};
+    quint32       seed;
+    sequence.generate(&seed, &seed + 1);
+    m_outputQueue.aqm().seed(seed);
+}
+
+bool Port::enqueueOutput(const PacketPtr_t &packet, SimTime_t now)
+{
+    return m_outputQueue.enqueue(packet, packet->trafficClass(),
+                                 static_cast<int>(packet->getPayload().size()) + HEADER_BYTES, now);
+}
+
+quint64 Port::serviceOutput(SimTime_t now)
+{
+    if (m_outputQueue.isEmpty()) return 0;
+
+    // Control packets bypass the output queue and go straight onto the link; data leaves them a
+    // few slots (at most a quarter of the link) so routing updates are never blocked by data.
+    qsizetype budget = m_serviceRate;
+    if (m_txRing) {
+        size_t reserve = qMin<size_t>(CONTROL_RESERVE, m_txRing->capacity() / 4);
+        size_t free    = m_txRing->freeSlots();
+        budget = qMin<qsizetype>(budget, static_cast<qsizetype>(free > reserve ? free - reserve : 0));
+    }
+
+    OutputQueue::Entry entry;
+    while (m_txBurst.size() < budget && m_outputQueue.dequeue(entry, now)) {
+        if (now > entry.enqueueTime) entry.packet->addQueueingCycles(now - entry.enqueueTime);
+        m_txBurst.append(entry.packet);
+    }
+
+    int sent = m_txBurst.isEmpty() ? 0 : sendPackets(m_txBurst);
+    m_txBurst.clear();
+    return sent;
+}
+
 void Port::setConnectedRouterId(int routerId) {
     QMutexLocker locker(&m_mutex);
     m_connectedRouterId = routerId;
@@ -117,8 +229,7 @@ void Port::connectToPC(QSharedPointer<PC> pc)
 
     qDebug() << "Port" << m_number << "connected to PC with IP" << pc->getIpAddress();
 
-    connect(this, &Port::packetReceived, pc.data(), &PC::processPacket);
-    connect(pc.data(), &PC::packetSent, this, &Port::sendPacket);
+    connect(pc.data(), &PC::packetSent, this, &Port::sendPacket, Qt::DirectConnection);
 }
 
 QSharedPointer<PC> Port::getConnectedPC() const
@@ -1,18 +1,27 @@
 #ifndef PORT_H
 #define PORT_H
 
+#include <QList>
 #include <QMutex>
 #include <QObject>
+#include <atomic>
 
 #include "../Packet/Packet.h"
+#include "../Queue/OutputQueue.h"
+#include "../Queue/SpscRing.h"
 
 class PC;
 
+typedef SpscRing<PacketPtr_t>        PacketRing_t;
+typedef QSharedPointer<PacketRing_t> PacketRingPtr_t;
+
 class Port : public QObject
 {
     Q_OBJECT
 
 public:
+    static constexpr int MAX_BURST_SIZE = 64;
+
     explicit Port(QObject *parent = nullptr);
     ~Port() override;
 
@@ -27,6 +36,7 @@ public:
 
     uint64_t getNumberOfPacketsSent() const;
     uint64_t getNumberOfPacketsReceived() const;
+    uint64_t getNumberOfPacketsBlocked() const;
 
     void setConnectedRouterId(int routerId);
     int getConnectedRouterId() const;
@@ -37,19 +47,59 @@ public:
     QString getConnectedRouterIP() const;
     void setConnectedRouterIP(const QString &ip) { m_connectedRouterIP = ip; }
 
+    /**
+     * Wires the port to a link: packets sent go into @p tx, packets received come out of @p rx.
+     * The owning node is the only producer of @p tx and the only consumer of @p rx.
+     */
+    void attachLink(const PacketRingPtr_t &tx, const PacketRingPtr_t &rx);
+    void detachLink();
+    bool canSend(size_t count = 1);
+
+    /**
+     * Link transfer, driven by the TickExecutor: flush() publishes the packets sent this tick to
+     * the peer, drainIngress() hands what the peer published on an earlier tick to @p handler as
+     * bursts of up to MAX_BURST_SIZE packets. Both return the number of packets moved.
+     */
+    quint64 flush();
+    template <typename Handler>
+    quint64 drainIngress(Handler &&handler);
+
+    /**
+     * Egress queueing: the router forwards into the port's output queue with enqueueOutput() and
+     * serviceOutput() moves up to serviceRate() packets a tick onto the link, in the order the
+     * queue's scheduler picks and as far as the link has room. A congested link only backs up its
+     * own queue.
+     */
+    static void setOutputDefaults(QueueScheduler scheduler, int queueSize, int serviceRate,
+                                  const std::array<int, OutputQueue::CLASS_COUNT> &weights);
+    static void setAqmDefaults(const AqmParameters &parameters);
+    static constexpr int DEFAULT_SERVICE_RATE = 6;
+    static constexpr int HEADER_BYTES         = 40;    // IP + TCP, added to the payload for DRR/WFQ
+    static constexpr int CONTROL_RESERVE      = 4;     // link slots data may not take, kept for control
+
+    bool    enqueueOutput(const PacketPtr_t &packet, SimTime_t now);
+    quint64 serviceOutput(SimTime_t now);
+    void    setServiceRate(int packetsPerTick);
+    /** Seeds RED on this port from red_seed, @p routerId and the port number; see AqmParameters. */
+    void    seedAqm(int routerId);
+    int     serviceRate() const { return m_serviceRate; }
+    const OutputQueue &outputQueue() const { return m_outputQueue; }
+
 Q_SIGNALS:
     void packetSent(const PacketPtr_t &data);
     void packetReceived(const PacketPtr_t &data);
+    void packetsSent(const QList<PacketPtr_t> &packets);
 
 public Q_SLOTS:
-    void sendPacket(const PacketPtr_t &data);
-    void sendPackets(const QList<PacketPtr_t> &packets);
+    bool sendPacket(const PacketPtr_t &data);
+    int  sendPackets(const QList<PacketPtr_t> &packets);
     void receivePacket(const PacketPtr_t &data);
 
 private:
     uint8_t  m_number;
-    uint64_t m_numberOfPacketsSent;
-    uint64_t m_numberOfPacketsReceived;
+    std::atomic<uint64_t> m_numberOfPacketsSent;
+    std::atomic<uint64_t> m_numberOfPacketsReceived;
+    std::atomic<uint64_t> m_numberOfPacketsBlocked;
     QString  m_routerIP;
     bool     m_isConnected;
 
@@ -57,8 +107,41 @@ private:
     QString m_connectedRouterIP;
     mutable QMutex m_mutex;
     int m_connectedRouterId = -1;
+
+    PacketRingPtr_t m_txRing;
+    PacketRingPtr_t m_rxRing;
+    QList<PacketPtr_t> m_rxBurst;
+
+    inline static QueueScheduler s_defaultScheduler   = QueueScheduler::Fifo;
+    inline static int            s_defaultQueueSize   = OutputQueue::DEFAULT_CAPACITY;
+    inline static int            s_defaultServiceRate = DEFAULT_SERVICE_RATE;
+    inline static std::array<int, OutputQueue::CLASS_COUNT> s_defaultWeights {1, 1, 1, 1, 1, 1, 1, 1};
+    inline static AqmParameters  s_defaultAqm;
+
+    OutputQueue        m_outputQueue;
+    int                m_serviceRate;
+    QList<PacketPtr_t> m_txBurst;
 };
 
+template <typename Handler>
+quint64
+Port::drainIngress(Handler &&handler)
+{
+    if (!m_rxRing) return 0;
+
+    quint64 received = 0;
+    size_t  batch;
+    while ((batch = m_rxRing->drain([this](PacketPtr_t &packet) { m_rxBurst.append(std::move(packet)); },
+                                    MAX_BURST_SIZE)) > 0) {
+        received += batch;
+        handler(std::as_const(m_rxBurst));
+        m_rxBurst.clear();
+    }
+
+    m_numberOfPacketsReceived.fetch_add(received, std::memory_order_relaxed);
+    return received;
+}
+
 typedef QSharedPointer<Port> PortPtr_t;
 
 #endif    // PORT_H
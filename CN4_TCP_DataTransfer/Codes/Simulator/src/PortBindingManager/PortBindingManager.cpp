@@ -3,6 +3,11 @@
 
 PortBindingManager::PortBindingManager(QObject *parent) : QObject(parent) {}
 
+void PortBindingManager::setLinkCapacity(size_t capacity)
+{
+    m_linkCapacity = capacity;
+}
+
 void PortBindingManager::bind(const QSharedPointer<Port> &port1, const QSharedPointer<Port> &port2, int router1Id, int router2Id)
 {
     if (!port1 || !port2) {
@@ -17,8 +22,11 @@ void PortBindingManager::bind(const QSharedPointer<Port> &port1, const QSharedPo
         return;
     }
 
-    connect(port1.data(), &Port::packetSent, port2.data(), &Port::receivePacket, Qt::QueuedConnection);
-    connect(port2.data(), &Port::packetSent, port1.data(), &Port::receivePacket, Qt::QueuedConnection);
+    // One ring per direction; each port produces into one and consumes from the other.
+    auto forward  = PacketRingPtr_t::create(m_linkCapacity);
+    auto backward = PacketRingPtr_t::create(m_linkCapacity);
+    port1->attachLink(forward, backward);
+    port2->attachLink(backward, forward);
 
     port1->setConnected(true);
     port2->setConnected(true);
@@ -63,8 +71,8 @@ bool PortBindingManager::unbind(const QSharedPointer<Port> &port1, const QShared
         return false;
     }
 
-    disconnect(port1.data(), &Port::packetSent, port2.data(), &Port::receivePacket);
-    disconnect(port2.data(), &Port::packetSent, port1.data(), &Port::receivePacket);
+    port1->detachLink();
+    port2->detachLink();
 
     port1->setConnected(false);
     port2->setConnected(false);
@@ -20,12 +20,19 @@ public:
 
     bool isBound(const QSharedPointer<Port> &port) const;
 
+    // Packets each direction of a link can hold before the sender is pushed back.
+    static void setLinkCapacity(size_t capacity);
+
+    static constexpr size_t DEFAULT_LINK_CAPACITY = 256;
+
 Q_SIGNALS:
     void bindingChanged(int router1Id, uint8_t port1, int router2Id, uint8_t port2, bool bind);
 
 private:
     QMap<PortPtr_t, PortPtr_t> m_bindings;
     mutable QMutex m_mutex;
+
+    inline static size_t m_linkCapacity = DEFAULT_LINK_CAPACITY;
 };
 
 #endif // PORTBINDINGMANAGER_H
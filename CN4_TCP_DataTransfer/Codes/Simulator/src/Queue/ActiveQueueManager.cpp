@@ -0,0 +1,141 @@
+#include "ActiveQueueManager.h"
+
+#include <cmath>
+
+ActiveQueueManager::ActiveQueueManager(const AqmParameters &parameters) :
+    m_random(parameters.redSeed)
+{
+    setParameters(parameters);
+}
+
+void
+ActiveQueueManager::setParameters(const AqmParameters &parameters)
+{
+    m_parameters                   = parameters;
+    m_parameters.redMinThreshold   = qMax(0.0, m_parameters.redMinThreshold);
+    m_parameters.redMaxThreshold   = qMax(m_parameters.redMinThreshold + 1, m_parameters.redMaxThreshold);
+    m_parameters.redMaxProbability = qBound(0.0, m_parameters.redMaxProbability, 1.0);
+    m_parameters.redWeight         = qBound(0.0001, m_parameters.redWeight, 1.0);
+    m_parameters.codelTarget       = qMax<SimTime_t>(1, m_parameters.codelTarget);
+    m_parameters.codelInterval     = qMax(m_parameters.codelTarget, m_parameters.codelInterval);
+    m_parameters.ecnMarkThreshold  = qMax(0, m_parameters.ecnMarkThreshold);
+}
+
+void
+ActiveQueueManager::seed(quint32 seed)
+{
+    m_random.seed(seed);
+}
+
+bool
+ActiveQueueManager::shouldDropOnEnqueue(int queueLength, SimTime_t now)
+{
+    if(m_parameters.type != AqmType::Red) return false;
+
+    const double weight = m_parameters.redWeight;
+
+    // An empty queue lets the average decay as if a sample of zero had been taken every idle tick.
+    if(m_idle && queueLength == 0)
+    {
+        m_average *= std::pow(1.0 - weight, static_cast<double>(now > m_idleSince ? now - m_idleSince : 0));
+    }
+    m_idle = false;
+
+    m_average = (1.0 - weight) * m_average + weight * queueLength;
+
+    if(m_average < m_parameters.redMinThreshold)
+    {
+        m_sinceDrop = 0;
+        return false;
+    }
+
+    if(m_average >= m_parameters.redMaxThreshold)
+    {
+        m_sinceDrop = 0;
+        return true;
+    }
+
+    double base = m_parameters.redMaxProbability * (m_average - m_parameters.redMinThreshold)
+                  / (m_parameters.redMaxThreshold - m_parameters.redMinThreshold);
+    double spread = 1.0 - m_sinceDrop * base;
+    double probability = spread > 0 ? base / spread : 1.0;
+
+    ++m_sinceDrop;
+    if(std::uniform_real_distribution<double>(0.0, 1.0)(m_random) < probability)
+    {
+        m_sinceDrop = 0;
+        return true;
+    }
+
+    return false;
+}
+
+bool
+ActiveQueueManager::codelOkToDrop(SimTime_t sojourn, SimTime_t now, int backlog)
+{
+    // Below target, or too little queued to matter: the queue is fine.
+    if(sojourn < m_parameters.codelTarget || backlog < 1)
+    {
+        m_firstAboveTime = 0;
+        return false;
+    }
+
+    if(m_firstAboveTime == 0)
+    {
+        m_firstAboveTime = now + m_parameters.codelInterval;
+        return false;
+    }
+
+    return now >= m_firstAboveTime;
+}
+
+SimTime_t
+ActiveQueueManager::controlLaw(SimTime_t from, quint32 count) const
+{
+    double gap = static_cast<double>(m_parameters.codelInterval) / std::sqrt(static_cast<double>(qMax(1u, count)));
+    return from + qMax<SimTime_t>(1, static_cast<SimTime_t>(std::llround(gap)));
+}
+
+bool
+ActiveQueueManager::shouldDropOnDequeue(SimTime_t enqueueTime, SimTime_t now, int backlog)
+{
+    if(m_parameters.type != AqmType::CoDel) return false;
+
+    bool okToDrop = codelOkToDrop(now > enqueueTime ? now - enqueueTime : 0, now, backlog);
+
+    if(m_dropping)
+    {
+        if(!okToDrop)
+        {
+            m_dropping = false;
+            return false;
+        }
+
+        if(now < m_dropNext) return false;
+
+        ++m_count;
+        m_dropNext = controlLaw(m_dropNext, m_count);
+        return true;
+    }
+
+    if(!okToDrop) return false;
+
+    // Entering the dropping state. If it was left only recently, resume near the old drop rate
+    // instead of starting over.
+    m_dropping     = true;
+    quint32 delta  = m_count - m_lastCount;
+    m_count        = delta > 1 && now < m_dropNext + 16 * m_parameters.codelInterval ? delta : 1;
+    m_lastCount    = m_count;
+    m_dropNext     = controlLaw(now, m_count);
+    return true;
+}
+
+void
+ActiveQueueManager::queueEmptied(SimTime_t now)
+{
+    m_idle      = true;
+    m_idleSince = now;
+
+    m_firstAboveTime = 0;
+    m_dropping       = false;
+}
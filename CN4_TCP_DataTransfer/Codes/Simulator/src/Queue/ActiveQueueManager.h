@@ -0,0 +1,97 @@
+#ifndef ACTIVEQUEUEMANAGER_H
+#define ACTIVEQUEUEMANAGER_H
+
+#include <random>
+
+#include "../EventsCoordinator/SimulationScheduler.h"
+
+enum class AqmType
+{
+    None,     // drop only when the queue is full
+    Red,      // random early detection on the averaged queue length, decided on arrival
+    CoDel     // controlled delay on each packet's sojourn time, decided on departure
+};
+
+struct AqmParameters
+{
+    AqmType type = AqmType::None;
+
+    // RED: thresholds on the averaged queue length in packets, the drop probability reached at the
+    // upper threshold and the weight of each new sample in the average.
+    double redMinThreshold   = 5;
+    double redMaxThreshold   = 15;
+    double redMaxProbability = 0.1;
+    double redWeight         = 0.002;
+    // Seed of RED's random source. Each port mixes in its router and port number (Port::seedAqm()),
+    // so the same config drops the same packets in every run.
+    quint32 redSeed          = 1;
+
+    // CoDel: the sojourn time a queue may keep and how long it may stay above it, in ticks.
+    SimTime_t codelTarget   = 1;
+    SimTime_t codelInterval = 10;
+
+    // ECN: mark ECN-capable packets where RED or CoDel would drop them, and mark every ECN-capable
+    // arrival once the queue already holds ecnMarkThreshold packets (DCTCP's K; 0 disables it).
+    bool ecn              = false;
+    int  ecnMarkThreshold = 0;
+};
+
+/**
+ * Active queue management for one output queue.
+ *
+ * RED keeps an exponentially weighted average of the queue length and drops arrivals with a
+ * probability that grows linearly between the two thresholds, spread out so drops don't cluster.
+ * CoDel looks at how long each departing packet waited: once the sojourn has stayed above the
+ * target for a whole interval it starts dropping, and the gap between drops shrinks with the
+ * square root of the drop count until the sojourn falls back under the target. Times are
+ * simulation ticks, taken from the tick each packet was queued at.
+ */
+class ActiveQueueManager
+{
+public:
+    explicit ActiveQueueManager(const AqmParameters &parameters = AqmParameters());
+
+    void                 setParameters(const AqmParameters &parameters);
+    const AqmParameters &parameters() const { return m_parameters; }
+    AqmType              type() const { return m_parameters.type; }
+
+    /** Reseeds RED's random source, for reproducible runs. */
+    void seed(quint32 seed);
+
+    /** RED: whether to drop a packet arriving at @p now to a queue holding @p queueLength packets. */
+    bool shouldDropOnEnqueue(int queueLength, SimTime_t now);
+
+    /**
+     * CoDel: whether to drop a packet queued at @p enqueueTime and leaving at @p now, with
+     * @p backlog packets still queued behind it.
+     */
+    bool shouldDropOnDequeue(SimTime_t enqueueTime, SimTime_t now, int backlog);
+
+    /** Tells the manager the queue ran empty at @p now. */
+    void queueEmptied(SimTime_t now);
+
+    double averageQueueLength() const { return m_average; }
+    bool   isDropping() const { return m_dropping; }
+
+private:
+    bool      codelOkToDrop(SimTime_t sojourn, SimTime_t now, int backlog);
+    SimTime_t controlLaw(SimTime_t from, quint32 count) const;
+
+    AqmParameters m_parameters;
+
+    // RED state.
+    double       m_average   = 0;
+    int          m_sinceDrop = 0;    // arrivals between the thresholds since the last drop
+    bool         m_idle      = true;
+    SimTime_t    m_idleSince = 0;
+    std::mt19937 m_random;
+
+    // CoDel state.
+    bool      m_dropping       = false;
+    SimTime_t m_firstAboveTime = 0;
+    SimTime_t m_dropNext       = 0;
+    quint32   m_count          = 0;
+    quint32   m_lastCount      = 0;
+};
+
+#endif    // ACTIVEQUEUEMANAGER_H
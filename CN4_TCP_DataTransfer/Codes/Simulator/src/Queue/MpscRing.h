@@ -0,0 +1,202 @@
+#ifndef MPSCRING_H
+#define MPSCRING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * Bounded lock-free multi-producer/single-consumer ring.
+ *
+ * Every slot carries a sequence number that tells whose turn it is: producers claim a slot by
+ * advancing the tail with a CAS and release it by bumping the sequence, the consumer does the same
+ * on the head. Because the head is also claimed with a CAS, a producer may evict the oldest item
+ * to make room (drop-head) without racing the consumer. Occupancy, high-watermark and drop counters
+ * are kept alongside so callers don't need a lock just to report them. The capacity is exact rather
+ * than rounded to a power of two, since it is a configured buffer size.
+ */
+template <typename T>
+class MpscRing
+{
+public:
+    static constexpr size_t CACHE_LINE = 64;
+
+    explicit MpscRing(size_t capacity = 64) : m_slots(capacity > 0 ? capacity : 1), m_capacity(m_slots.size())
+    {
+        for(size_t i = 0; i < m_capacity; ++i) m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    MpscRing(const MpscRing &)            = delete;
+    MpscRing &operator=(const MpscRing &) = delete;
+
+    /** Any thread: append one item. Returns false, counting a drop, when the ring is full. */
+    bool
+    tryPush(const T &value)
+    {
+        if(pushImpl(value)) return true;
+
+        m_drops.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    /**
+     * Any thread: append one item, evicting the oldest ones while the ring is full.
+     * Evicted items are handed to @p onEvicted and counted as drops. Returns the number evicted.
+     */
+    template <typename Evicted>
+    size_t
+    pushEvicting(const T &value, Evicted &&onEvicted)
+    {
+        size_t evicted = 0;
+        T      oldest;
+
+        while(!pushImpl(value))
+        {
+            if(!tryPop(oldest)) continue;
+
+            m_drops.fetch_add(1, std::memory_order_relaxed);
+            onEvicted(oldest);
+            ++evicted;
+        }
+
+        return evicted;
+    }
+
+    /** Consumer (or an evicting producer): take the oldest item. Returns false when empty. */
+    bool
+    tryPop(T &out)
+    {
+        size_t pos = m_head.load(std::memory_order_relaxed);
+
+        for(;;)
+        {
+            Slot          &slot = m_slots[pos % m_capacity];
+            size_t         seq  = slot.sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+
+            if(diff == 0)
+            {
+                if(m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            }
+            else if(diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = m_head.load(std::memory_order_relaxed);
+            }
+        }
+
+        Slot &slot = m_slots[pos % m_capacity];
+        out        = std::move(slot.value);
+        slot.value = T();
+        slot.sequence.store(pos + m_capacity, std::memory_order_release);
+        return true;
+    }
+
+    /** Consumer: read the oldest item without taking it. Returns nullptr when empty. */
+    const T *
+    peek() const
+    {
+        size_t      pos  = m_head.load(std::memory_order_relaxed);
+        const Slot &slot = m_slots[pos % m_capacity];
+
+        return slot.sequence.load(std::memory_order_acquire) == pos + 1 ? &slot.value : nullptr;
+    }
+
+    size_t
+    capacity() const
+    {
+        return m_capacity;
+    }
+
+    /** Claimed slots, including ones a producer is still filling; a snapshot under concurrency. */
+    size_t
+    size() const
+    {
+        size_t head = m_head.load(std::memory_order_acquire);
+        size_t tail = m_tail.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+    bool
+    isEmpty() const
+    {
+        return size() == 0;
+    }
+
+    size_t
+    highWatermark() const
+    {
+        return m_highWatermark.load(std::memory_order_relaxed);
+    }
+
+    uint64_t
+    drops() const
+    {
+        return m_drops.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<size_t> sequence {0};
+        T                   value {};
+    };
+
+    bool
+    pushImpl(const T &value)
+    {
+        size_t pos = m_tail.load(std::memory_order_relaxed);
+
+        for(;;)
+        {
+            Slot          &slot = m_slots[pos % m_capacity];
+            size_t         seq  = slot.sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+
+            if(diff == 0)
+            {
+                if(m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            }
+            else if(diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+
+        Slot &slot = m_slots[pos % m_capacity];
+        slot.value = value;
+        slot.sequence.store(pos + 1, std::memory_order_release);
+
+        size_t head      = m_head.load(std::memory_order_relaxed);
+        size_t occupancy = pos + 1 > head ? pos + 1 - head : 0;
+        size_t seen      = m_highWatermark.load(std::memory_order_relaxed);
+        while(occupancy > seen && !m_highWatermark.compare_exchange_weak(seen, occupancy, std::memory_order_relaxed))
+        {
+        }
+
+        return true;
+    }
+
+    // Consumer side.
+    alignas(CACHE_LINE) std::atomic<size_t> m_head {0};
+
+    // Producer side.
+    alignas(CACHE_LINE) std::atomic<size_t> m_tail {0};
+
+    alignas(CACHE_LINE) std::atomic<size_t> m_highWatermark {0};
+    std::atomic<uint64_t>                    m_drops {0};
+
+    std::vector<Slot> m_slots;
+    size_t            m_capacity;
+};
+
+#endif    // MPSCRING_H
@@ -0,0 +1,207 @@
+#include "OutputQueue.h"
+
+OutputQueue::OutputQueue(QueueScheduler scheduler, int capacity) :
+    m_scheduler(scheduler),
+    m_capacity(qMax(1, capacity))
+{
+    m_weights.fill(1);
+}
+
+void
+OutputQueue::setScheduler(QueueScheduler scheduler)
+{
+    if(m_size > 0) return;
+
+    m_scheduler = scheduler;
+}
+
+void
+OutputQueue::setCapacity(int packets)
+{
+    m_capacity = qMax(1, packets);
+}
+
+void
+OutputQueue::setWeights(const std::array<int, CLASS_COUNT> &weights)
+{
+    for(int c = 0; c < CLASS_COUNT; ++c) m_weights[c] = qMax(1, weights[c]);
+}
+
+int
+OutputQueue::classIndex(int trafficClass) const
+{
+    return m_scheduler == QueueScheduler::Fifo ? 0 : qBound(0, trafficClass, CLASS_COUNT - 1);
+}
+
+int
+OutputQueue::classSize(int trafficClass) const
+{
+    return static_cast<int>(m_classes[qBound(0, trafficClass, CLASS_COUNT - 1)].size());
+}
+
+bool
+OutputQueue::enqueue(const PacketPtr_t &packet, int trafficClass, int bytes, SimTime_t now)
+{
+    if(m_size >= m_capacity)
+    {
+        ++m_tailDrops;
+        return false;
+    }
+
+    if(m_aqm.shouldDropOnEnqueue(m_size, now))
+    {
+        if(!markEcn(packet))
+        {
+            ++m_aqmDrops;
+            return false;
+        }
+    }
+    else if(m_aqm.parameters().ecnMarkThreshold > 0 && m_size >= m_aqm.parameters().ecnMarkThreshold)
+    {
+        markEcn(packet);
+    }
+
+    int   c = classIndex(trafficClass);
+    Entry entry;
+    entry.packet      = packet;
+    entry.enqueueTime = now;
+    entry.bytes       = qMax(1, bytes);
+
+    if(m_scheduler == QueueScheduler::WeightedFair)
+    {
+        entry.finishTag = qMax(m_virtualTime, m_lastFinish[c]) + static_cast<double>(entry.bytes) / m_weights[c];
+        m_lastFinish[c] = entry.finishTag;
+    }
+
+    m_classes[c].enqueue(entry);
+    m_highWatermark = qMax(m_highWatermark, ++m_size);
+    return true;
+}
+
+bool
+OutputQueue::dequeue(Entry &out, SimTime_t now)
+{
+    while(m_size > 0)
+    {
+        takeNext(out);
+
+        if(m_aqm.shouldDropOnDequeue(out.enqueueTime, now, m_size) && !markEcn(out.packet))
+        {
+            ++m_aqmDrops;
+            if(m_size == 0) m_aqm.queueEmptied(now);
+            continue;
+        }
+
+        if(m_size == 0) m_aqm.queueEmptied(now);
+        return true;
+    }
+
+    return false;
+}
+
+bool
+OutputQueue::markEcn(const PacketPtr_t &packet)
+{
+    if(!m_aqm.parameters().ecn || !packet || !packet->isEcnCapable()) return false;
+
+    // Already marked upstream: still spared the drop, but not counted again.
+    if(!packet->isCongestionExperienced())
+    {
+        packet->markCongestionExperienced();
+        ++m_ecnMarks;
+    }
+    return true;
+}
+
+void
+OutputQueue::takeNext(Entry &out)
+{
+    int c = 0;
+    switch(m_scheduler)
+    {
+    case QueueScheduler::Fifo:              c = 0; break;
+    case QueueScheduler::StrictPriority:    c = pickStrictPriority(); break;
+    case QueueScheduler::DeficitRoundRobin: c = pickDeficitRoundRobin(); break;
+    case QueueScheduler::WeightedFair:      c = pickWeightedFair(); break;
+    }
+
+    out = m_classes[c].dequeue();
+    --m_size;
+
+    if(m_scheduler == QueueScheduler::DeficitRoundRobin)
+    {
+        m_deficit[c] -= out.bytes;
+        if(m_classes[c].isEmpty()) advanceRound();
+    }
+    else if(m_scheduler == QueueScheduler::WeightedFair)
+    {
+        m_virtualTime = out.finishTag;
+
+        // Idle: restart the virtual clock so the tags don't grow without bound.
+        if(m_size == 0)
+        {
+            m_virtualTime = 0;
+            m_lastFinish.fill(0);
+        }
+    }
+}
+
+int
+OutputQueue::pickStrictPriority() const
+{
+    for(int c = CLASS_COUNT - 1; c > 0; --c)
+    {
+        if(!m_classes[c].isEmpty()) return c;
+    }
+
+    return 0;
+}
+
+void
+OutputQueue::advanceRound()
+{
+    // A class that leaves its turn with nothing queued keeps no credit.
+    if(m_classes[m_cursor].isEmpty()) m_deficit[m_cursor] = 0;
+
+    m_cursor  = (m_cursor + 1) % CLASS_COUNT;
+    m_charged = false;
+}
+
+int
+OutputQueue::pickDeficitRoundRobin()
+{
+    // Terminates because every visit to a non-empty class adds a quantum to its deficit.
+    for(;;)
+    {
+        QQueue<Entry> &queue = m_classes[m_cursor];
+
+        if(queue.isEmpty())
+        {
+            advanceRound();
+            continue;
+        }
+
+        if(!m_charged)
+        {
+            m_deficit[m_cursor] += static_cast<qint64>(QUANTUM_BYTES) * m_weights[m_cursor];
+            m_charged = true;
+        }
+
+        if(queue.head().bytes <= m_deficit[m_cursor]) return m_cursor;
+
+        advanceRound();
+    }
+}
+
+int
+OutputQueue::pickWeightedFair() const
+{
+    int best = -1;
+    for(int c = 0; c < CLASS_COUNT; ++c)
+    {
+        if(m_classes[c].isEmpty()) continue;
+        if(best < 0 || m_classes[c].head().finishTag < m_classes[best].head().finishTag) best = c;
+    }
+
+    return best;
+}
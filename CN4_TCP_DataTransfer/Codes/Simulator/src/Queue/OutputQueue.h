@@ -0,0 +1,116 @@
+#ifndef OUTPUTQUEUE_H
+#define OUTPUTQUEUE_H
+
+#include <QQueue>
+#include <array>
+
+#include "../EventsCoordinator/SimulationScheduler.h"
+#include "../Packet/Packet.h"
+#include "ActiveQueueManager.h"
+
+enum class QueueScheduler
+{
+    Fifo,                 // one queue, arrival order
+    DeficitRoundRobin,    // classes take turns, each sending up to its byte quantum per round
+    StrictPriority,       // the highest non-empty class always goes first
+    WeightedFair          // self-clocked fair queueing, bandwidth shared by class weight
+};
+
+/**
+ * Egress queue of one port.
+ *
+ * Packets wait here between being forwarded and being put on the link, split into traffic classes.
+ * The scheduler decides which class is served next; FIFO keeps a single class. The capacity is
+ * shared by all classes and a full queue drops the arriving packet. Before that, the queue's active
+ * queue manager may drop early: RED on arrival, CoDel on departure. With ECN on, ECN-capable
+ * packets are marked congestion-experienced instead of being dropped early, and also once the queue
+ * passes the marking threshold. Each entry remembers the tick it was queued so the time spent
+ * waiting can be charged to the packet and CoDel can measure it.
+ */
+class OutputQueue
+{
+public:
+    static constexpr int CLASS_COUNT      = 8;
+    static constexpr int DEFAULT_CAPACITY = 64;
+    static constexpr int QUANTUM_BYTES    = 1'500;    // DRR quantum of a class with weight 1
+
+    struct Entry
+    {
+        PacketPtr_t packet;
+        SimTime_t   enqueueTime = 0;
+        int         bytes       = 0;
+        double      finishTag   = 0;    // WFQ only
+    };
+
+    explicit OutputQueue(QueueScheduler scheduler = QueueScheduler::Fifo, int capacity = DEFAULT_CAPACITY);
+
+    /** Changes the discipline; only allowed while the queue is empty. */
+    void           setScheduler(QueueScheduler scheduler);
+    QueueScheduler scheduler() const { return m_scheduler; }
+
+    void setCapacity(int packets);
+    int  capacity() const { return m_capacity; }
+
+    /** Per-class weights used by DRR (quantum multiplier) and WFQ (bandwidth share); at least 1. */
+    void setWeights(const std::array<int, CLASS_COUNT> &weights);
+
+    void                      setAqm(const AqmParameters &parameters) { m_aqm.setParameters(parameters); }
+    ActiveQueueManager       &aqm() { return m_aqm; }
+    const ActiveQueueManager &aqm() const { return m_aqm; }
+
+    /**
+     * Queues @p packet in @p trafficClass. Returns false, counting a drop, when the queue is full
+     * or RED drops it; an ECN-capable packet RED picks is marked and queued instead.
+     */
+    bool enqueue(const PacketPtr_t &packet, int trafficClass, int bytes, SimTime_t now);
+
+    /**
+     * Takes the packet the scheduler picks next, skipping those CoDel drops at @p now. CoDel marks
+     * ECN-capable packets rather than skipping them.
+     * Returns false when the queue is empty.
+     */
+    bool dequeue(Entry &out, SimTime_t now = 0);
+
+    int     size() const { return m_size; }
+    bool    isEmpty() const { return m_size == 0; }
+    int     classSize(int trafficClass) const;
+    int     highWatermark() const { return m_highWatermark; }
+    quint64 tailDrops() const { return m_tailDrops; }
+    quint64 aqmDrops() const { return m_aqmDrops; }
+    quint64 drops() const { return m_tailDrops + m_aqmDrops; }
+    quint64 ecnMarks() const { return m_ecnMarks; }
+
+private:
+    void takeNext(Entry &out);
+    bool markEcn(const PacketPtr_t &packet);
+    int  classIndex(int trafficClass) const;
+    int  pickStrictPriority() const;
+    int  pickDeficitRoundRobin();
+    int  pickWeightedFair() const;
+    void advanceRound();
+
+    QueueScheduler                          m_scheduler;
+    int                                     m_capacity;
+    std::array<QQueue<Entry>, CLASS_COUNT> m_classes;
+    std::array<int, CLASS_COUNT>            m_weights;
+
+    // DRR: the class whose turn it is, whether it has been given its quantum this turn, and the
+    // bytes each class may still send.
+    int                              m_cursor  = 0;
+    bool                             m_charged = false;
+    std::array<qint64, CLASS_COUNT> m_deficit {};
+
+    // WFQ: virtual time (finish tag of the last packet served) and last finish tag per class.
+    double                           m_virtualTime = 0;
+    std::array<double, CLASS_COUNT> m_lastFinish {};
+
+    ActiveQueueManager m_aqm;
+
+    int     m_size          = 0;
+    int     m_highWatermark = 0;
+    quint64 m_tailDrops     = 0;
+    quint64 m_aqmDrops      = 0;
+    quint64 m_ecnMarks      = 0;
+};
+
+#endif    // OUTPUTQUEUE_H
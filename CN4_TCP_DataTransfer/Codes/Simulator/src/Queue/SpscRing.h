@@ -0,0 +1,125 @@
+#ifndef SPSCRING_H
+#define SPSCRING_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * Bounded lock-free single-producer/single-consumer ring.
+ *
+ * The producer stages items with push() and makes them visible with publish(), so a whole tick
+ * worth of packets is handed over with one release store. The consumer takes published items in
+ * batches with drain(). Producer and consumer indices live on separate cache lines, and each side
+ * keeps a cached copy of the other side's index so the shared lines are only touched when the
+ * cached view runs out.
+ */
+template <typename T>
+class SpscRing
+{
+public:
+    static constexpr size_t CACHE_LINE = 64;
+
+    explicit SpscRing(size_t capacity = 256)
+    {
+        size_t size = 2;
+        while(size < capacity) size <<= 1;
+
+        m_slots.resize(size);
+        m_mask = size - 1;
+    }
+
+    SpscRing(const SpscRing &)            = delete;
+    SpscRing &operator=(const SpscRing &) = delete;
+
+    /** Producer: stage one item. Returns false, leaving the item untouched, when the ring is full. */
+    bool
+    push(const T &value)
+    {
+        if(m_pendingTail - m_cachedHead > m_mask)
+        {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if(m_pendingTail - m_cachedHead > m_mask) return false;
+        }
+
+        m_slots[m_pendingTail & m_mask] = value;
+        ++m_pendingTail;
+        return true;
+    }
+
+    /** Producer: make everything staged so far visible to the consumer. */
+    size_t
+    publish()
+    {
+        size_t published = m_pendingTail - m_tail.load(std::memory_order_relaxed);
+        if(published > 0) m_tail.store(m_pendingTail, std::memory_order_release);
+        return published;
+    }
+
+    /** Producer: free slots, counting staged items as used. */
+    size_t
+    freeSlots()
+    {
+        m_cachedHead = m_head.load(std::memory_order_acquire);
+        return capacity() - (m_pendingTail - m_cachedHead);
+    }
+
+    /**
+     * Consumer: hand up to @p maxItems published items to @p consumer, in order.
+     * Returns the number of items taken.
+     */
+    template <typename Consumer>
+    size_t
+    drain(Consumer &&consumer, size_t maxItems = static_cast<size_t>(-1))
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+
+        if(head == m_cachedTail)
+        {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if(head == m_cachedTail) return 0;
+        }
+
+        size_t count = m_cachedTail - head;
+        if(count > maxItems) count = maxItems;
+
+        for(size_t i = 0; i < count; ++i)
+        {
+            T item = std::move(m_slots[(head + i) & m_mask]);
+            m_slots[(head + i) & m_mask] = T();
+            consumer(item);
+        }
+
+        m_head.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    size_t
+    capacity() const
+    {
+        return m_mask + 1;
+    }
+
+    /** Published items not yet drained; exact only when called by one of the two sides. */
+    size_t
+    size() const
+    {
+        return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+    }
+
+private:
+    // Consumer side.
+    alignas(CACHE_LINE) std::atomic<size_t> m_head {0};
+    size_t                                  m_cachedTail = 0;
+
+    // Producer side.
+    alignas(CACHE_LINE) std::atomic<size_t> m_tail {0};
+    size_t                                  m_pendingTail = 0;
+    size_t                                  m_cachedHead  = 0;
+
+    alignas(CACHE_LINE) std::vector<T> m_slots;
+    size_t                             m_mask = 0;
+};
+
+#endif    // SPSCRING_H
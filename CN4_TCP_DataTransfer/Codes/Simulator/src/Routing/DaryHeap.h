@@ -0,0 +1,159 @@
+#ifndef DARYHEAP_H
+#define DARYHEAP_H
+
+#include <QtGlobal>
+
+#include <vector>
+
+/**
+ * Indexed min-heap of items 0..capacity-1 keyed by an integer priority, with a fan-out of
+ * @p Arity.
+ *
+ * A position table makes decrease-key O(log_d n). A wider fan-out makes the tree shallower, which
+ * suits shortest-path searches that do many more decrease-keys than pops.
+ */
+template <int Arity = 4>
+class DaryHeap
+{
+    static_assert(Arity >= 2, "a heap needs at least two children per node");
+
+public:
+    explicit DaryHeap(int capacity = 0)
+    {
+        reset(capacity);
+    }
+
+    /** Empties the heap and makes room for items 0..capacity-1. */
+    void
+    reset(int capacity)
+    {
+        m_heap.clear();
+        m_heap.reserve(capacity);
+        m_keys.assign(capacity, 0);
+        m_positions.assign(capacity, NOT_IN_HEAP);
+    }
+
+    bool
+    isEmpty() const
+    {
+        return m_heap.empty();
+    }
+
+    int
+    size() const
+    {
+        return static_cast<int>(m_heap.size());
+    }
+
+    bool
+    contains(int item) const
+    {
+        return m_positions[item] != NOT_IN_HEAP;
+    }
+
+    /** Inserts @p item, or lowers its key if it is already queued with a larger one. */
+    void
+    pushOrDecrease(int item, qint64 key)
+    {
+        int position = m_positions[item];
+        if(position == NOT_IN_HEAP)
+        {
+            position          = static_cast<int>(m_heap.size());
+            m_heap.push_back(item);
+            m_positions[item] = position;
+        }
+        else if(key >= m_keys[item])
+        {
+            return;
+        }
+
+        m_keys[item] = key;
+        siftUp(position);
+    }
+
+    qint64
+    topKey() const
+    {
+        return m_keys[m_heap.front()];
+    }
+
+    int
+    pop()
+    {
+        int top              = m_heap.front();
+        m_positions[top]     = NOT_IN_HEAP;
+
+        int last             = m_heap.back();
+        m_heap.pop_back();
+        if(!m_heap.empty())
+        {
+            m_heap.front()    = last;
+            m_positions[last] = 0;
+            siftDown(0);
+        }
+
+        return top;
+    }
+
+private:
+    static constexpr int NOT_IN_HEAP = -1;
+
+    void
+    siftUp(int position)
+    {
+        int    item = m_heap[position];
+        qint64 key  = m_keys[item];
+
+        while(position > 0)
+        {
+            int parent = (position - 1) / Arity;
+            if(m_keys[m_heap[parent]] <= key) break;
+
+            place(position, m_heap[parent]);
+            position = parent;
+        }
+
+        place(position, item);
+    }
+
+    void
+    siftDown(int position)
+    {
+        const int count = static_cast<int>(m_heap.size());
+        int       item  = m_heap[position];
+        qint64    key   = m_keys[item];
+
+        for(;;)
+        {
+            int first = position * Arity + 1;
+            if(first >= count) break;
+
+            int best = first;
+            int end  = qMin(first + Arity, count);
+            for(int child = first + 1; child < end; ++child)
+            {
+                if(m_keys[m_heap[child]] < m_keys[m_heap[best]]) best = child;
+            }
+
+            if(m_keys[m_heap[best]] >= key) break;
+
+            place(position, m_heap[best]);
+            position = best;
+        }
+
+        place(position, item);
+    }
+
+    void
+    place(int position, int item)
+    {
+        m_heap[position]  = item;
+        m_positions[item] = position;
+    }
+
+    std::vector<int>    m_heap;
+    std::vector<qint64> m_keys;
+    std::vector<int>    m_positions;
+};
+
+#endif    // DARYHEAP_H
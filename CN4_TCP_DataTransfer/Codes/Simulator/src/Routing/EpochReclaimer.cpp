@@ -0,0 +1,117 @@
+#include "EpochReclaimer.h"
+
+#include <QtGlobal>
+
+struct ThreadReader
+{
+    int slot  = -1;
+    int depth = 0;
+
+    ~ThreadReader()
+    {
+        if(slot >= 0) EpochReclaimer::instance().releaseSlot(slot);
+    }
+};
+
+namespace
+{
+
+thread_local ThreadReader t_reader;
+
+}    // namespace
+
+EpochReclaimer &
+EpochReclaimer::instance()
+{
+    static EpochReclaimer reclaimer;
+    return reclaimer;
+}
+
+EpochReclaimer::ReadGuard::ReadGuard()
+{
+    if(t_reader.depth++ > 0) return;
+
+    EpochReclaimer &reclaimer = instance();
+    if(t_reader.slot < 0) t_reader.slot = reclaimer.claimSlot();
+    reclaimer.enter(t_reader.slot);
+}
+
+EpochReclaimer::ReadGuard::~ReadGuard()
+{
+    if(--t_reader.depth > 0) return;
+
+    instance().leave(t_reader.slot);
+}
+
+quint64
+EpochReclaimer::retireEpoch()
+{
+    return m_epoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+}
+
+bool
+EpochReclaimer::isQuiescent(quint64 epoch) const
+{
+    for(const auto &slot : m_slots)
+    {
+        if(!slot.claimed.load(std::memory_order_acquire)) continue;
+
+        quint64 pinned = slot.epoch.load(std::memory_order_seq_cst);
+        if(pinned != 0 && pinned < epoch) return false;
+    }
+
+    return true;
+}
+
+quint64
+EpochReclaimer::currentEpoch() const
+{
+    return m_epoch.load(std::memory_order_acquire);
+}
+
+int
+EpochReclaimer::activeReaders() const
+{
+    int active = 0;
+    for(const auto &slot : m_slots)
+    {
+        if(slot.epoch.load(std::memory_order_acquire) != 0) ++active;
+    }
+
+    return active;
+}
+
+int
+EpochReclaimer::claimSlot()
+{
+    for(int i = 0; i < MAX_READERS; ++i)
+    {
+        bool expected = false;
+        if(m_slots[i].claimed.compare_exchange_strong(expected, true, std::memory_order_acq_rel))
+            return i;
+    }
+
+    qFatal("EpochReclaimer: more than %d reader threads", MAX_READERS);
+    return -1;
+}
+
+void
+EpochReclaimer::releaseSlot(int slot)
+{
+    m_slots[slot].epoch.store(0, std::memory_order_release);
+    m_slots[slot].claimed.store(false, std::memory_order_release);
+}
+
+void
+EpochReclaimer::enter(int slot)
+{
+    // Sequentially consistent, so the pointer loads that follow cannot be reordered above the pin:
+    // a reader either pinned before a retirement epoch was taken or already sees the new pointer.
+    m_slots[slot].epoch.store(m_epoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+}
+
+void
+EpochReclaimer::leave(int slot)
+{
+    m_slots[slot].epoch.store(0, std::memory_order_release);
+}
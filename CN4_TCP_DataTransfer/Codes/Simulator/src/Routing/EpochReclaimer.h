@@ -0,0 +1,65 @@
+#ifndef EPOCHRECLAIMER_H
+#define EPOCHRECLAIMER_H
+
+#include <QtGlobal>
+
+#include <array>
+#include <atomic>
+
+/**
+ * Epoch-based reclamation for data shared with lock-free readers.
+ *
+ * A reader opens a ReadGuard, which pins the current global epoch in a per-thread slot for as
+ * long as the guard lives. A writer that unlinks an object takes a fresh epoch with retireEpoch()
+ * and may free the object once isQuiescent() reports that no reader pinned an older epoch is
+ * still inside its guard. Readers never block and never write shared state besides their own slot.
+ */
+class EpochReclaimer
+{
+public:
+    static constexpr int MAX_READERS = 256;
+
+    static EpochReclaimer &instance();
+
+    /** Pins the calling thread for the lifetime of the guard; guards nest. */
+    class ReadGuard
+    {
+    public:
+        ReadGuard();
+        ~ReadGuard();
+
+        ReadGuard(const ReadGuard &)            = delete;
+        ReadGuard &operator=(const ReadGuard &) = delete;
+    };
+
+    /** Advances the global epoch. Objects unlinked before the call are retired under the result. */
+    quint64 retireEpoch();
+
+    /** True once every reader that could still see an object retired under @p epoch has left. */
+    bool    isQuiescent(quint64 epoch) const;
+
+    quint64 currentEpoch() const;
+    int     activeReaders() const;
+
+private:
+    friend class ReadGuard;
+    friend struct ThreadReader;
+
+    struct alignas(64) ReaderSlot
+    {
+        std::atomic<quint64> epoch {0};    // 0 while the owning thread is outside any guard
+        std::atomic<bool>    claimed {false};
+    };
+
+    EpochReclaimer() = default;
+
+    int  claimSlot();
+    void releaseSlot(int slot);
+    void enter(int slot);
+    void leave(int slot);
+
+    std::atomic<quint64>                m_epoch {1};
+    std::array<ReaderSlot, MAX_READERS> m_slots;
+};
+
+#endif    // EPOCHRECLAIMER_H
@@ -0,0 +1,129 @@
+#include "ForwardingTable.h"
+
+#include <algorithm>
+
+ForwardingTable::ForwardingTable() :
+    m_prefixCount(0)
+{
+    clear();
+}
+
+void
+ForwardingTable::clear()
+{
+    m_nodes.clear();
+    m_prefixCount = 0;
+    newNode(EMPTY_SLOT, 0);
+}
+
+void
+ForwardingTable::build(std::vector<Prefix> prefixes)
+{
+    // Shortest first, so every prefix only ever has to overwrite less specific ones.
+    std::stable_sort(prefixes.begin(), prefixes.end(),
+                     [](const Prefix &a, const Prefix &b) { return a.length < b.length; });
+
+    clear();
+    m_nodes.reserve(1 + prefixes.size() / 4);
+
+    for(const auto &prefix : prefixes)
+    {
+        insert(prefix.prefix, prefix.length, prefix.value);
+    }
+}
+
+void
+ForwardingTable::insert(quint32 prefix, quint8 length, quint32 value)
+{
+    if(length > 32) length = 32;
+    if(length < 32) prefix &= ~(0xFFFF'FFFFu >> length);
+
+    const quint32 slot  = (value & ~CHILD_FLAG) + 1;
+    int           node  = 0;
+    int           shift = 24;
+
+    // Walk down the full bytes of the prefix, creating nodes as needed.
+    while(length > 32 - shift)
+    {
+        int     index   = (prefix >> shift) & 0xFF;
+        quint32 current = m_nodes[node].entries[index];
+
+        if(!(current & CHILD_FLAG))
+        {
+            int child                    = newNode(current, m_nodes[node].lengths[index]);
+            m_nodes[node].entries[index] = CHILD_FLAG | static_cast<quint32>(child);
+            current                      = m_nodes[node].entries[index];
+        }
+
+        node   = static_cast<int>(current & ~CHILD_FLAG);
+        shift -= 8;
+    }
+
+    // The remaining bits cover a run of slots in this node.
+    int span  = 8 - (length - (24 - shift));
+    int first = ((prefix >> shift) & 0xFF) & ~((1 << span) - 1);
+
+    for(int index = first; index < first + (1 << span); ++index)
+    {
+        assign(node, index, slot, length);
+    }
+
+    ++m_prefixCount;
+}
+
+quint32
+ForwardingTable::lookup(quint32 address) const
+{
+    const Node *node = &m_nodes[0];
+
+    for(int shift = 24;; shift -= 8)
+    {
+        quint32 slot = node->entries[(address >> shift) & 0xFF];
+        if(!(slot & CHILD_FLAG)) return slot == EMPTY_SLOT ? NO_ROUTE : slot - 1;
+
+        node = &m_nodes[slot & ~CHILD_FLAG];
+    }
+}
+
+int
+ForwardingTable::prefixCount() const
+{
+    return m_prefixCount;
+}
+
+int
+ForwardingTable::nodeCount() const
+{
+    return static_cast<int>(m_nodes.size());
+}
+
+int
+ForwardingTable::newNode(quint32 slot, quint8 length)
+{
+    Node node;
+    node.entries.fill(slot);
+    node.lengths.fill(length);
+    m_nodes.push_back(node);
+    return static_cast<int>(m_nodes.size()) - 1;
+}
+
+void
+ForwardingTable::assign(int node, int index, quint32 slot, quint8 length)
+{
+    quint32 current = m_nodes[node].entries[index];
+
+    if(current & CHILD_FLAG)
+    {
+        // Push the prefix into the slots of the more specific node below that it still wins.
+        int child = static_cast<int>(current & ~CHILD_FLAG);
+        for(int i = 0; i < 256; ++i)
+        {
+            assign(child, i, slot, length);
+        }
+    }
+    else if(m_nodes[node].lengths[index] <= length)
+    {
+        m_nodes[node].entries[index] = slot;
+        m_nodes[node].lengths[index] = length;
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef FORWARDINGTABLE_H
+#define FORWARDINGTABLE_H
+
+#include <QtGlobal>
+
+#include <array>
+#include <vector>
+
+/**
+ * Longest-prefix-match table over IPv4 addresses.
+ *
+ * A fixed-stride multibit trie: four levels of 256-slot nodes, one per address byte. Prefixes that
+ * do not end on a byte boundary are expanded over the slots they cover, and a shorter prefix is
+ * pushed down into the nodes created below it, so a lookup is at most four array reads and never
+ * backtracks, whatever the number of routes. The table stores a caller-chosen 31-bit value per
+ * prefix, usually an index into the caller's own route array.
+ */
+class ForwardingTable
+{
+public:
+    static constexpr quint32 NO_ROUTE = 0xFFFF'FFFFu;
+
+    struct Prefix
+    {
+        quint32 prefix = 0;
+        quint8  length = 32;
+        quint32 value  = 0;
+    };
+
+    ForwardingTable();
+
+    void    clear();
+
+    /** Replaces the whole table; cheaper than inserting the routes one by one. */
+    void    build(std::vector<Prefix> prefixes);
+
+    /** Adds or overrides one prefix; more specific prefixes already in the table keep their slots. */
+    void    insert(quint32 prefix, quint8 length, quint32 value);
+
+    quint32 lookup(quint32 address) const;
+
+    int     prefixCount() const;
+    int     nodeCount() const;
+
+private:
+    static constexpr quint32 CHILD_FLAG = 0x8000'0000u;
+    static constexpr quint32 EMPTY_SLOT = 0;
+
+    struct Node
+    {
+        std::array<quint32, 256> entries;    // EMPTY_SLOT, value + 1, or CHILD_FLAG | node index
+        std::array<quint8, 256>  lengths;    // prefix length of the value held in (or pushed into) a slot
+    };
+
+    int  newNode(quint32 slot, quint8 length);
+    void assign(int node, int index, quint32 slot, quint8 length);
+
+    std::vector<Node> m_nodes;
+    int               m_prefixCount;
+};
+
+#endif    // FORWARDINGTABLE_H
@@ -0,0 +1,224 @@
+#include "LinkStateDatabase.h"
+
+namespace
+{
+    // FNV-1a over the sequence numbers of a view.
+    quint64
+    viewHash(const std::vector<quint32> &sequences)
+    {
+        quint64 hash = 14695981039346656037ULL;
+        for(quint32 sequence : sequences)
+        {
+            hash ^= sequence;
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+}
+
+LinkStateDatabase &
+LinkStateDatabase::instance()
+{
+    static LinkStateDatabase database;
+    return database;
+}
+
+int
+LinkStateDatabase::routerId(quint32 address)
+{
+    QMutexLocker locker(&m_mutex);
+    return routerIdLocked(address);
+}
+
+int
+LinkStateDatabase::findRouterId(quint32 address) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_ids.value(address, -1);
+}
+
+quint32
+LinkStateDatabase::routerAddress(int id) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_addresses[id];
+}
+
+int
+LinkStateDatabase::routerCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return static_cast<int>(m_addresses.size());
+}
+
+int
+LinkStateDatabase::acquire(quint32 originAddress, quint32 sequence,
+                           const std::vector<quint32> &links)
+{
+    QMutexLocker locker(&m_mutex);
+
+    const int origin = routerIdLocked(originAddress);
+    for(auto &version : m_versions[origin])
+    {
+        if(version.sequence == sequence)
+        {
+            ++version.references;
+            return origin;
+        }
+    }
+
+    std::vector<int> ids;
+    ids.reserve(links.size());
+    for(quint32 link : links)
+    {
+        ids.push_back(routerIdLocked(link));
+    }
+
+    Version version;
+    version.sequence   = sequence;
+    version.references = 1;
+    version.links      = std::make_shared<const std::vector<int>>(std::move(ids));
+
+    ++m_lsaCount;
+    m_linkCount += static_cast<int>(version.links->size());
+    m_versions[origin].push_back(std::move(version));
+    return origin;
+}
+
+void
+LinkStateDatabase::release(int origin, quint32 sequence)
+{
+    QMutexLocker locker(&m_mutex);
+
+    auto &versions = m_versions[origin];
+    for(size_t i = 0; i < versions.size(); ++i)
+    {
+        if(versions[i].sequence != sequence) continue;
+
+        if(--versions[i].references == 0)
+        {
+            --m_lsaCount;
+            m_linkCount -= static_cast<int>(versions[i].links->size());
+            versions.erase(versions.begin() + static_cast<std::ptrdiff_t>(i));
+        }
+        return;
+    }
+}
+
+std::shared_ptr<const CsrGraph>
+LinkStateDatabase::graph(const std::vector<quint32> &sequences)
+{
+    const quint64 key   = viewHash(sequences);
+    const int     nodes = static_cast<int>(sequences.size());
+
+    // Under the lock only look the view up and take its LSAs' link lists.
+    std::vector<Links_t> links(sequences.size());
+    {
+        QMutexLocker locker(&m_mutex);
+
+        auto cached = m_graphs.find(key);
+        if(cached != m_graphs.end() && cached->sequences == sequences)
+        {
+            cached->lastUse = ++m_graphUses;
+            return cached->graph;
+        }
+
+        for(int from = 0; from < nodes; ++from)
+        {
+            if(sequences[from] == 0) continue;
+
+            const Version *version = findVersionLocked(from, sequences[from]);
+            if(version) links[from] = version->links;
+        }
+    }
+
+    auto has = [&](int node) { return node < nodes && sequences[node] != 0; };
+
+    std::vector<CsrGraph::Arc> arcs;
+    for(int from = 0; from < nodes; ++from)
+    {
+        if(!links[from]) continue;
+
+        for(int to : *links[from])
+        {
+            if(has(to)) arcs.push_back({from, to, 1});
+        }
+    }
+
+    auto graph = std::make_shared<const CsrGraph>(CsrGraph::fromArcs(nodes, arcs));
+
+    QMutexLocker locker(&m_mutex);
+
+    // Another worker with the same view may have got there first; everyone shares its graph.
+    auto cached = m_graphs.find(key);
+    if(cached != m_graphs.end() && cached->sequences == sequences)
+    {
+        cached->lastUse = ++m_graphUses;
+        return cached->graph;
+    }
+
+    if(cached == m_graphs.end() && m_graphs.size() >= GRAPH_CACHE_SIZE)
+    {
+        auto oldest = m_graphs.begin();
+        for(auto it = m_graphs.begin(); it != m_graphs.end(); ++it)
+        {
+            if(it->lastUse < oldest->lastUse) oldest = it;
+        }
+        m_graphs.erase(oldest);
+    }
+
+    m_graphs.insert(key, CachedGraph{sequences, graph, ++m_graphUses});
+    return graph;
+}
+
+int
+LinkStateDatabase::lsaCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_lsaCount;
+}
+
+int
+LinkStateDatabase::linkCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_linkCount;
+}
+
+void
+LinkStateDatabase::clear()
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_ids.clear();
+    m_addresses.clear();
+    m_versions.clear();
+    m_lsaCount  = 0;
+    m_linkCount = 0;
+    m_graphs.clear();
+    m_graphUses = 0;
+}
+
+int
+LinkStateDatabase::routerIdLocked(quint32 address)
+{
+    auto it = m_ids.constFind(address);
+    if(it != m_ids.constEnd()) return it.value();
+
+    const int id = static_cast<int>(m_addresses.size());
+    m_ids.insert(address, id);
+    m_addresses.push_back(address);
+    m_versions.emplace_back();
+    return id;
+}
+
+const LinkStateDatabase::Version *
+LinkStateDatabase::findVersionLocked(int origin, quint32 sequence) const
+{
+    for(const auto &version : m_versions[origin])
+    {
+        if(version.sequence == sequence) return &version;
+    }
+
+    return nullptr;
+}
@@ -0,0 +1,92 @@
+#ifndef LINKSTATEDATABASE_H
+#define LINKSTATEDATABASE_H
+
+#include "ShortestPath.h"
+
+#include <QHash>
+#include <QMutex>
+
+#include <memory>
+#include <vector>
+
+/**
+ * The OSPF link-state database shared by all routers of the simulation.
+ *
+ * Routers are numbered densely by address, once for the whole network. Every LSA version, an
+ * (origin, sequence) pair, is stored once as an immutable list of router ids, and reference
+ * counted by the routers that currently hold it, so the LSDB a router has learned is nothing but
+ * a sequence number per origin (0 for none). graph() turns such a sequence vector into a CSR
+ * graph; routers with the same view share one graph, which is copied on write when a view moves
+ * on. The last few views' graphs are kept, so routers that disagree during convergence don't
+ * evict each other's, and a graph is built outside the lock. All members are thread-safe.
+ */
+class LinkStateDatabase
+{
+public:
+    static constexpr int GRAPH_CACHE_SIZE = 16;
+
+    static LinkStateDatabase &instance();
+
+    /** Dense id of the router with @p address, assigned on first use. */
+    int     routerId(quint32 address);
+    /** Id of @p address, or -1 if it never took part in OSPF. */
+    int     findRouterId(quint32 address) const;
+    quint32 routerAddress(int id) const;
+    int     routerCount() const;
+
+    /**
+     * Takes a reference on the LSA version (@p originAddress, @p sequence), storing @p links the
+     * first time the version is seen. Returns the id of the origin.
+     */
+    int     acquire(quint32 originAddress, quint32 sequence, const std::vector<quint32> &links);
+    /** Drops a reference taken with acquire(); the last one frees the version. */
+    void    release(int origin, quint32 sequence);
+
+    /**
+     * Graph over the LSAs named by @p sequences, indexed by origin id; links towards routers the
+     * view has no LSA for are left out.
+     */
+    std::shared_ptr<const CsrGraph> graph(const std::vector<quint32> &sequences);
+
+    /** LSA versions currently stored, and links they hold in total. */
+    int     lsaCount() const;
+    int     linkCount() const;
+
+    /** Forgets everything; only for tests, with no router holding references. */
+    void    clear();
+
+private:
+    typedef std::shared_ptr<const std::vector<int>> Links_t;
+
+    struct Version
+    {
+        quint32 sequence   = 0;
+        int     references = 0;
+        Links_t links;    // immutable, so a graph build can use it after the lock is released
+    };
+
+    struct CachedGraph
+    {
+        std::vector<quint32>            sequences;
+        std::shared_ptr<const CsrGraph> graph;
+        quint64                         lastUse = 0;
+    };
+
+    LinkStateDatabase() = default;
+
+    int            routerIdLocked(quint32 address);
+    const Version *findVersionLocked(int origin, quint32 sequence) const;
+
+    mutable QMutex                    m_mutex;
+    QHash<quint32, int>               m_ids;
+    std::vector<quint32>              m_addresses;
+    std::vector<std::vector<Version>> m_versions;    // per origin, usually one or two
+    int                               m_lsaCount  = 0;
+    int                               m_linkCount = 0;
+
+    // Recently built graphs, keyed by a hash of their view and evicted least recently used first.
+    QHash<quint64, CachedGraph>       m_graphs;
+    quint64                           m_graphUses = 0;
+};
+
+#endif    // LINKSTATEDATABASE_H
@@ -0,0 +1,98 @@
+#ifndef RCUPOINTER_H
+#define RCUPOINTER_H
+
+#include "EpochReclaimer.h"
+
+#include <QMutex>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/**
+ * A pointer to an immutable object that writers replace wholesale and readers follow lock-free.
+ *
+ * publish() swaps in a new object and retires the old one; retired objects are deleted once the
+ * EpochReclaimer reports that no reader can still hold them. Readers call load() inside an
+ * EpochReclaimer::ReadGuard and must not keep the pointer past the guard.
+ */
+template <typename T>
+class RcuPointer
+{
+public:
+    RcuPointer() = default;
+
+    ~RcuPointer()
+    {
+        delete m_current.load(std::memory_order_relaxed);
+        for(const auto &retired : m_retired)
+        {
+            delete retired.object;
+        }
+    }
+
+    RcuPointer(const RcuPointer &)            = delete;
+    RcuPointer &operator=(const RcuPointer &) = delete;
+
+    const T *
+    load() const
+    {
+        return m_current.load(std::memory_order_seq_cst);
+    }
+
+    void
+    publish(std::unique_ptr<const T> next)
+    {
+        const T *previous = m_current.exchange(next.release(), std::memory_order_seq_cst);
+
+        QMutexLocker locker(&m_mutex);
+        if(previous) m_retired.push_back({EpochReclaimer::instance().retireEpoch(), previous});
+        reclaimLocked();
+    }
+
+    /** Deletes the retired objects no reader can reach any more; returns how many are left. */
+    int
+    reclaim()
+    {
+        QMutexLocker locker(&m_mutex);
+        return reclaimLocked();
+    }
+
+    int
+    retiredCount() const
+    {
+        QMutexLocker locker(&m_mutex);
+        return static_cast<int>(m_retired.size());
+    }
+
+private:
+    struct Retired
+    {
+        quint64  epoch;
+        const T *object;
+    };
+
+    int
+    reclaimLocked()
+    {
+        const EpochReclaimer &reclaimer = EpochReclaimer::instance();
+
+        size_t kept = 0;
+        for(const auto &retired : m_retired)
+        {
+            if(reclaimer.isQuiescent(retired.epoch))
+                delete retired.object;
+            else
+                m_retired[kept++] = retired;
+        }
+        m_retired.resize(kept);
+
+        return static_cast<int>(kept);
+    }
+
+    std::atomic<const T *> m_current {nullptr};
+    mutable QMutex         m_mutex;
+    std::vector<Retired>   m_retired;
+};
+
+#endif    // RCUPOINTER_H
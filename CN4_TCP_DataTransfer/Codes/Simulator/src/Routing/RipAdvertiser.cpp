@@ -0,0 +1,119 @@
+#include "RipAdvertiser.h"
+
+#include "../Packet/ControlMessage.h"
+
+namespace
+{
+
+constexpr quint8 ADVERTISED_FLAGS = RouteEntry::FLAG_WILDCARD_HOST | RouteEntry::FLAG_MAPPED_PREFIX;
+
+bool
+sameAdvertisement(const RouteEntry &a, const RouteEntry &b)
+{
+    return a.metric == b.metric && a.portIndex == b.portIndex &&
+           (a.flags & ADVERTISED_FLAGS) == (b.flags & ADVERTISED_FLAGS);
+}
+
+void
+addRecord(ControlMessageWriter &update, const RouteEntry &entry, int metric)
+{
+    quint16 flags = 0;
+    if(entry.flags & RouteEntry::FLAG_WILDCARD_HOST) flags |= ControlRecord::FLAG_WILDCARD_HOST;
+    if(entry.flags & RouteEntry::FLAG_MAPPED_PREFIX) flags |= ControlRecord::FLAG_IPV4_MAPPED_IPV6;
+
+    update.addRecord(entry.prefix, entry.length, static_cast<quint8>(qBound(0, metric, 255)), flags);
+}
+
+}    // namespace
+
+RipAdvertiser::RipAdvertiser(int infinityMetric) :
+    m_infinity(infinityMetric),
+    m_generation(0),
+    m_recordCount(0)
+{}
+
+int
+RipAdvertiser::encodeTable(const RoutingTable &table, quint32 origin)
+{
+    return encode(table, origin, true);
+}
+
+int
+RipAdvertiser::encodeChanges(const RoutingTable &table, quint32 origin)
+{
+    return encode(table, origin, false);
+}
+
+int
+RipAdvertiser::encode(const RoutingTable &table, quint32 origin, bool everything)
+{
+    ++m_generation;
+    m_learnedThrough.clear();
+    m_payloads.clear();
+
+    ControlMessageWriter update(UT::PacketControlType::RIP, origin, 0,
+                                everything ? table.size() : 0);
+
+    for(const RouteEntry &entry : table)
+    {
+        Advertised &advertised =
+          m_advertised[RoutingTable::keyOf(entry.prefix, entry.length, entry.isDirect())];
+
+        const bool changed    = advertised.generation == 0 ||
+                                !sameAdvertisement(advertised.route, entry);
+        advertised.route      = entry;
+        advertised.generation = m_generation;
+
+        if(!changed && !everything) continue;
+
+        if(entry.portIndex >= 0 && !entry.isDirect())
+            m_learnedThrough[entry.portIndex].append(update.recordCount());
+        addRecord(update, entry, entry.metric);
+    }
+
+    // Routes that left the table since the last update are withdrawn.
+    for(auto it = m_advertised.begin(); it != m_advertised.end();)
+    {
+        if(it.value().generation == m_generation)
+        {
+            ++it;
+            continue;
+        }
+
+        addRecord(update, it.value().route, m_infinity);
+        it = m_advertised.erase(it);
+    }
+
+    m_recordCount = update.recordCount();
+    m_message     = update.finish();
+    return m_recordCount;
+}
+
+QByteArray
+RipAdvertiser::payloadFor(int portIndex)
+{
+    auto cached = m_payloads.constFind(portIndex);
+    if(cached != m_payloads.constEnd()) return cached.value();
+
+    const auto       learned = m_learnedThrough.constFind(portIndex);
+    const QByteArray payload =
+      learned == m_learnedThrough.constEnd()
+        ? m_message
+        : ControlMessageWriter::withRecordMetric(m_message, learned.value(),
+                                                 static_cast<quint8>(m_infinity));
+
+    m_payloads.insert(portIndex, payload);
+    return payload;
+}
+
+int
+RipAdvertiser::recordCount() const
+{
+    return m_recordCount;
+}
+
+int
+RipAdvertiser::advertisedCount() const
+{
+    return static_cast<int>(m_advertised.size());
+}
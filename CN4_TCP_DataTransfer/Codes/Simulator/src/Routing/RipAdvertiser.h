@@ -0,0 +1,60 @@
+#ifndef RIPADVERTISER_H
+#define RIPADVERTISER_H
+
+#include "RoutingTable.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+
+/**
+ * Encodes a router's RIP updates.
+ *
+ * The advertiser remembers what it last advertised for every route, so a triggered update only
+ * carries the routes whose advertised form changed since, plus the routes that left the table,
+ * advertised as unreachable. A periodic refresh carries the whole table.
+ *
+ * An update is encoded once. Each port then gets a copy in which the routes learned through that
+ * port are poisoned (split horizon with poison reverse). Ports that learned none of the routes
+ * share the encoded message itself, and every port's payload is built once per update however
+ * many packets are sent from it.
+ */
+class RipAdvertiser
+{
+public:
+    explicit RipAdvertiser(int infinityMetric);
+
+    /** Encodes every route of @p table. Returns the number of records. */
+    int        encodeTable(const RoutingTable &table, quint32 origin);
+
+    /** Encodes the routes that changed since the last update. Returns 0 if nothing did. */
+    int        encodeChanges(const RoutingTable &table, quint32 origin);
+
+    /** The last encoded update as sent through the port with index @p portIndex. */
+    QByteArray payloadFor(int portIndex);
+
+    int        recordCount() const;
+
+    /** Routes currently known to the neighbours, as far as this advertiser is concerned. */
+    int        advertisedCount() const;
+
+private:
+    struct Advertised
+    {
+        RouteEntry route;
+        quint64    generation = 0;
+    };
+
+    int                          encode(const RoutingTable &table, quint32 origin, bool everything);
+
+    int                          m_infinity;
+    quint64                      m_generation;
+    QHash<quint64, Advertised>   m_advertised;
+
+    QByteArray                   m_message;
+    int                          m_recordCount;
+    QHash<int, QList<int>>       m_learnedThrough;    // port index -> records learned through it
+    QHash<int, QByteArray>       m_payloads;
+};
+
+#endif    // RIPADVERTISER_H
@@ -0,0 +1,181 @@
+#include "RoutingTable.h"
+
+#include "../Packet/ControlMessage.h"
+
+RouteEntry
+RouteEntry::fromStrings(const QString &destination, const QString &mask, const QString &nextHop)
+{
+    RouteEntry entry;
+    quint16    addressFlags = 0;
+
+    entry.prefix = ControlAddress::fromString(destination, &addressFlags);
+    entry.length = ControlAddress::maskToPrefixLength(mask);
+
+    if(addressFlags & ControlRecord::FLAG_WILDCARD_HOST)
+    {
+        entry.flags  |= FLAG_WILDCARD_HOST;
+        entry.length  = 24;
+    }
+    if(addressFlags & ControlRecord::FLAG_IPV4_MAPPED_IPV6) entry.flags |= FLAG_MAPPED_PREFIX;
+    if(entry.length < 32) entry.prefix &= ~(0xFFFF'FFFFu >> entry.length);
+
+    entry.nextHop = ControlAddress::fromString(nextHop, &addressFlags);
+    if(addressFlags & ControlRecord::FLAG_IPV4_MAPPED_IPV6) entry.flags |= FLAG_MAPPED_NEXT_HOP;
+
+    return entry;
+}
+
+QString
+RouteEntry::destination() const
+{
+    quint16 addressFlags = 0;
+    if(flags & FLAG_WILDCARD_HOST) addressFlags |= ControlRecord::FLAG_WILDCARD_HOST;
+    if(flags & FLAG_MAPPED_PREFIX) addressFlags |= ControlRecord::FLAG_IPV4_MAPPED_IPV6;
+
+    return ControlAddress::toString(prefix, addressFlags);
+}
+
+QString
+RouteEntry::mask() const
+{
+    return ControlAddress::prefixLengthToMask(length);
+}
+
+QString
+RouteEntry::nextHopAddress() const
+{
+    return ControlAddress::toString(
+      nextHop, (flags & FLAG_MAPPED_NEXT_HOP) ? ControlRecord::FLAG_IPV4_MAPPED_IPV6 : 0);
+}
+
+RouteEntry
+ForwardingSnapshot::lookup(quint32 address) const
+{
+    quint32 index = table.lookup(address);
+    return index == ForwardingTable::NO_ROUTE ? RouteEntry() : routes[index];
+}
+
+quint64
+RoutingTable::keyOf(quint32 prefix, quint8 length, bool direct)
+{
+    return (static_cast<quint64>(prefix) << 16) | (static_cast<quint64>(length) << 8) |
+           (direct ? 1 : 0);
+}
+
+RouteEntry *
+RoutingTable::find(quint32 prefix, quint8 length, bool direct)
+{
+    return find(keyOf(prefix, length, direct));
+}
+
+RouteEntry *
+RoutingTable::find(quint64 key)
+{
+    auto it = m_index.constFind(key);
+    return it == m_index.constEnd() ? nullptr : &m_entries[it.value()];
+}
+
+const RouteEntry *
+RoutingTable::find(quint32 prefix, quint8 length, bool direct) const
+{
+    auto it = m_index.constFind(keyOf(prefix, length, direct));
+    return it == m_index.constEnd() ? nullptr : &m_entries[it.value()];
+}
+
+RouteEntry &
+RoutingTable::insert(const RouteEntry &entry)
+{
+    quint64 key = keyOf(entry.prefix, entry.length, entry.isDirect());
+    auto    it  = m_index.constFind(key);
+
+    if(it != m_index.constEnd())
+    {
+        m_entries[it.value()] = entry;
+        return m_entries[it.value()];
+    }
+
+    m_index.insert(key, static_cast<int>(m_entries.size()));
+    m_entries.push_back(entry);
+    return m_entries.back();
+}
+
+bool
+RoutingTable::remove(quint32 prefix, quint8 length, bool direct)
+{
+    auto it = m_index.constFind(keyOf(prefix, length, direct));
+    if(it == m_index.constEnd()) return false;
+
+    removeAt(static_cast<size_t>(it.value()));
+    return true;
+}
+
+std::unique_ptr<ForwardingSnapshot>
+RoutingTable::compile(int unreachableMetric) const
+{
+    auto                                 snapshot = std::make_unique<ForwardingSnapshot>();
+    std::vector<ForwardingTable::Prefix> prefixes;
+    QHash<quint64, quint32>              byPrefix;
+
+    snapshot->routes.reserve(m_entries.size());
+    prefixes.reserve(m_entries.size());
+
+    for(const auto &route : m_entries)
+    {
+        if(route.metric < 0 || route.metric >= unreachableMetric) continue;
+
+        // A direct and a learned route may share a prefix: keep the lower metric, the direct one on
+        // a tie.
+        quint64 key      = keyOf(route.prefix, route.length, false);
+        auto    existing = byPrefix.constFind(key);
+        if(existing != byPrefix.constEnd())
+        {
+            RouteEntry &kept = snapshot->routes[existing.value()];
+            if(route.metric < kept.metric || (route.metric == kept.metric && route.isDirect()))
+                kept = route;
+            continue;
+        }
+
+        quint32 index = static_cast<quint32>(snapshot->routes.size());
+        byPrefix.insert(key, index);
+        snapshot->routes.push_back(route);
+        prefixes.push_back({route.prefix, route.length, index});
+    }
+
+    snapshot->table.build(std::move(prefixes));
+    return snapshot;
+}
+
+void
+RoutingTable::clear()
+{
+    m_entries.clear();
+    m_index.clear();
+}
+
+int
+RoutingTable::size() const
+{
+    return static_cast<int>(m_entries.size());
+}
+
+bool
+RoutingTable::isEmpty() const
+{
+    return m_entries.empty();
+}
+
+void
+RoutingTable::removeAt(size_t index)
+{
+    const RouteEntry &removed = m_entries[index];
+    m_index.remove(keyOf(removed.prefix, removed.length, removed.isDirect()));
+
+    if(index + 1 != m_entries.size())
+    {
+        m_entries[index] = m_entries.back();
+        const RouteEntry &moved = m_entries[index];
+        m_index.insert(keyOf(moved.prefix, moved.length, moved.isDirect()), static_cast<int>(index));
+    }
+
+    m_entries.pop_back();
+}
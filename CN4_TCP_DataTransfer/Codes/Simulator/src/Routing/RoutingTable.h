@@ -0,0 +1,139 @@
+#ifndef ROUTINGTABLE_H
+#define ROUTINGTABLE_H
+
+#include "ForwardingTable.h"
+
+#include <QHash>
+#include <QString>
+
+#include <memory>
+#include <vector>
+
+enum class RoutingProtocol : quint8
+{
+    RIP,
+    OSPF,
+    EBGP,
+    IBGP,
+    ITSELF
+};
+
+/** The RIP timer a learned route is waiting on; each one hands over to the next when it fires. */
+enum class RouteTimer : quint8
+{
+    None,
+    Invalid,
+    HoldDown,
+    Flush
+};
+
+/**
+ * One route of the routing table, 24 bytes.
+ *
+ * Addresses are IPv4 values in host order and the port the route was learned from is an index
+ * into the router's ports (-1 for none). Dotted strings are only built for logs and messages.
+ * A learned route has at most one RIP timer running, in the router's timing wheel; the entry
+ * keeps its id and which of the timers it is.
+ */
+struct RouteEntry
+{
+    static constexpr quint8 FLAG_DIRECT          = 0x01;
+    static constexpr quint8 FLAG_VIP             = 0x02;
+    static constexpr quint8 FLAG_WILDCARD_HOST   = 0x04;    // the "a.b.c.xx" form of a /24
+    static constexpr quint8 FLAG_MAPPED_PREFIX   = 0x08;    // the "::ffff:" form of the prefix
+    static constexpr quint8 FLAG_MAPPED_NEXT_HOP = 0x10;
+
+    quint32         prefix         = 0;
+    quint32         nextHop        = 0;
+    qint32          lastUpdateTime = 0;
+    quint32         timerId        = 0;    // TimingWheel id, 0 for none
+    qint16          metric         = -1;
+    qint16          portIndex      = -1;
+    quint8          length         = 32;
+    RoutingProtocol protocol       = RoutingProtocol::RIP;
+    quint8          flags          = 0;
+    RouteTimer      timer          = RouteTimer::None;
+
+    /** Parses the dotted forms used in the configuration and the logs. */
+    static RouteEntry fromStrings(const QString &destination, const QString &mask,
+                                  const QString &nextHop);
+
+    bool              isNull() const { return metric < 0; }
+    bool              isDirect() const { return flags & FLAG_DIRECT; }
+    bool              isVip() const { return flags & FLAG_VIP; }
+
+    QString           destination() const;
+    QString           mask() const;
+    QString           nextHopAddress() const;
+};
+
+/**
+ * Immutable forwarding view of a routing table: the best route per prefix behind a
+ * longest-prefix-match trie. Built by RoutingTable::compile() and never modified afterwards, so
+ * any number of threads may look routes up in it while the routing table keeps changing.
+ */
+struct ForwardingSnapshot
+{
+    ForwardingTable         table;
+    std::vector<RouteEntry> routes;    // indexed by the values stored in table
+
+    RouteEntry              lookup(quint32 address) const;
+};
+
+/**
+ * The routing information base: routes indexed by (prefix, length, direct).
+ *
+ * A direct route and a learned route to the same prefix are kept side by side, as before.
+ * Entries live in one dense array for fast iteration; a hash from the key to the array slot makes
+ * lookups, updates and removals O(1), removal moving the last entry into the freed slot.
+ */
+class RoutingTable
+{
+public:
+    static quint64    keyOf(quint32 prefix, quint8 length, bool direct);
+
+    RouteEntry       *find(quint32 prefix, quint8 length, bool direct);
+    RouteEntry       *find(quint64 key);
+    const RouteEntry *find(quint32 prefix, quint8 length, bool direct) const;
+
+    /** Adds @p entry, replacing any route with the same key. */
+    RouteEntry       &insert(const RouteEntry &entry);
+    bool              remove(quint32 prefix, quint8 length, bool direct);
+
+    template <typename Predicate>
+    int
+    removeIf(Predicate predicate)
+    {
+        int removed = 0;
+        for(size_t i = m_entries.size(); i-- > 0;)
+        {
+            if(predicate(m_entries[i]))
+            {
+                removeAt(i);
+                ++removed;
+            }
+        }
+
+        return removed;
+    }
+
+    /** Compiles the usable routes, those with a metric below @p unreachableMetric, into a snapshot. */
+    std::unique_ptr<ForwardingSnapshot> compile(int unreachableMetric) const;
+
+    void              clear();
+    int               size() const;
+    bool              isEmpty() const;
+
+    std::vector<RouteEntry>::iterator       begin() { return m_entries.begin(); }
+    std::vector<RouteEntry>::iterator       end() { return m_entries.end(); }
+    std::vector<RouteEntry>::const_iterator begin() const { return m_entries.begin(); }
+    std::vector<RouteEntry>::const_iterator end() const { return m_entries.end(); }
+
+private:
+    void                    removeAt(size_t index);
+
+    std::vector<RouteEntry> m_entries;
+    QHash<quint64, int>     m_index;
+};
+
+#endif    // ROUTINGTABLE_H
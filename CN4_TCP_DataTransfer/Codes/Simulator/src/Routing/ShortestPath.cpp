@@ -0,0 +1,227 @@
+#include "ShortestPath.h"
+
+#include "DaryHeap.h"
+
+#include <algorithm>
+
+CsrGraph
+CsrGraph::fromArcs(int nodeCount, const std::vector<Arc> &arcs)
+{
+    CsrGraph graph;
+    graph.offsets.assign(nodeCount + 1, 0);
+    graph.targets.resize(arcs.size());
+    graph.weights.resize(arcs.size());
+
+    for(const auto &arc : arcs)
+    {
+        ++graph.offsets[arc.from + 1];
+    }
+    for(int n = 0; n < nodeCount; ++n)
+    {
+        graph.offsets[n + 1] += graph.offsets[n];
+    }
+
+    std::vector<int> cursor(graph.offsets.begin(), graph.offsets.end() - 1);
+    for(const auto &arc : arcs)
+    {
+        int slot            = cursor[arc.from]++;
+        graph.targets[slot] = arc.to;
+        graph.weights[slot] = arc.weight;
+    }
+
+    graph.reverseOffsets.assign(nodeCount + 1, 0);
+    graph.sources.resize(arcs.size());
+    graph.reverseWeights.resize(arcs.size());
+
+    for(const auto &arc : arcs)
+    {
+        ++graph.reverseOffsets[arc.to + 1];
+    }
+    for(int n = 0; n < nodeCount; ++n)
+    {
+        graph.reverseOffsets[n + 1] += graph.reverseOffsets[n];
+    }
+
+    cursor.assign(graph.reverseOffsets.begin(), graph.reverseOffsets.end() - 1);
+    for(const auto &arc : arcs)
+    {
+        int slot                   = cursor[arc.to]++;
+        graph.sources[slot]        = arc.from;
+        graph.reverseWeights[slot] = arc.weight;
+    }
+
+    return graph;
+}
+
+int
+CsrGraph::arcWeight(int from, int to) const
+{
+    for(int arc = offsets[from]; arc < offsets[from + 1]; ++arc)
+    {
+        if(targets[arc] == to) return weights[arc];
+    }
+
+    return -1;
+}
+
+void
+ShortestPathTree::compute(const CsrGraph &graph, int source)
+{
+    const int nodes = graph.nodeCount();
+
+    m_source = source;
+    m_distance.assign(nodes, UNREACHABLE);
+    m_parent.assign(nodes, NO_NODE);
+    m_firstHop.assign(nodes, NO_NODE);
+
+    if(source < 0 || source >= nodes) return;
+
+    DaryHeap<4> heap(nodes);
+    m_distance[source] = 0;
+    heap.pushOrDecrease(source, 0);
+
+    while(!heap.isEmpty())
+    {
+        qint64 distance = heap.topKey();
+        int    node     = heap.pop();
+
+        for(int arc = graph.offsets[node]; arc < graph.offsets[node + 1]; ++arc)
+        {
+            int    next      = graph.targets[arc];
+            qint64 candidate = distance + graph.weights[arc];
+
+            if(m_distance[next] != UNREACHABLE && m_distance[next] <= candidate) continue;
+
+            m_distance[next] = candidate;
+            m_parent[next]   = node;
+            m_firstHop[next] = node == source ? next : m_firstHop[node];
+            heap.pushOrDecrease(next, candidate);
+        }
+    }
+}
+
+std::vector<int>
+ShortestPathTree::repair(const CsrGraph &graph, const std::vector<int> &changedNodes)
+{
+    const int nodes = graph.nodeCount();
+
+    m_distance.resize(nodes, UNREACHABLE);
+    m_parent.resize(nodes, NO_NODE);
+    m_firstHop.resize(nodes, NO_NODE);
+
+    std::vector<int> touched;
+    if(m_source < 0 || m_source >= nodes) return touched;
+
+    // Children of every node in the current tree, in CSR form.
+    std::vector<int> childOffsets(nodes + 1, 0);
+    for(int node = 0; node < nodes; ++node)
+    {
+        if(m_parent[node] != NO_NODE) ++childOffsets[m_parent[node] + 1];
+    }
+    for(int node = 0; node < nodes; ++node)
+    {
+        childOffsets[node + 1] += childOffsets[node];
+    }
+    std::vector<int> children(childOffsets.back());
+    std::vector<int> cursor(childOffsets.begin(), childOffsets.end() - 1);
+    for(int node = 0; node < nodes; ++node)
+    {
+        if(m_parent[node] != NO_NODE) children[cursor[m_parent[node]]++] = node;
+    }
+
+    // A tree arc that vanished or got dearer cuts the whole subtree below it loose.
+    std::vector<char> cut(nodes, 0);
+    std::vector<int>  pending;
+    for(int node : changedNodes)
+    {
+        if(node < 0 || node >= nodes) continue;
+
+        for(int i = childOffsets[node]; i < childOffsets[node + 1]; ++i)
+        {
+            int child  = children[i];
+            int weight = graph.arcWeight(node, child);
+            if(weight >= 0 && m_distance[node] + weight == m_distance[child]) continue;
+
+            if(!cut[child])
+            {
+                cut[child] = 1;
+                pending.push_back(child);
+            }
+        }
+    }
+
+    while(!pending.empty())
+    {
+        int node = pending.back();
+        pending.pop_back();
+        touched.push_back(node);
+
+        for(int i = childOffsets[node]; i < childOffsets[node + 1]; ++i)
+        {
+            if(!cut[children[i]])
+            {
+                cut[children[i]] = 1;
+                pending.push_back(children[i]);
+            }
+        }
+    }
+
+    for(int node : touched)
+    {
+        m_distance[node] = UNREACHABLE;
+        m_parent[node]   = NO_NODE;
+        m_firstHop[node] = NO_NODE;
+    }
+
+    DaryHeap<4> heap(nodes);
+    auto        relax = [&](int from, int to, qint64 candidate) {
+        if(m_distance[to] != UNREACHABLE && m_distance[to] <= candidate) return;
+
+        m_distance[to] = candidate;
+        m_parent[to]   = from;
+        m_firstHop[to] = from == m_source ? to : m_firstHop[from];
+        heap.pushOrDecrease(to, candidate);
+    };
+
+    // Reattach the cut nodes to the intact part of the tree...
+    const size_t cutCount = touched.size();
+    for(size_t i = 0; i < cutCount; ++i)
+    {
+        int node = touched[i];
+        for(int arc = graph.reverseOffsets[node]; arc < graph.reverseOffsets[node + 1]; ++arc)
+        {
+            int source = graph.sources[arc];
+            if(cut[source] || m_distance[source] == UNREACHABLE) continue;
+
+            relax(source, node, m_distance[source] + graph.reverseWeights[arc]);
+        }
+    }
+
+    // ...offer the arcs that appeared or got cheaper...
+    for(int node : changedNodes)
+    {
+        if(node < 0 || node >= nodes || cut[node] || m_distance[node] == UNREACHABLE) continue;
+
+        for(int arc = graph.offsets[node]; arc < graph.offsets[node + 1]; ++arc)
+        {
+            relax(node, graph.targets[arc], m_distance[node] + graph.weights[arc]);
+        }
+    }
+
+    // ...and let the improvements run down the graph in Dijkstra order.
+    while(!heap.isEmpty())
+    {
+        qint64 distance = heap.topKey();
+        int    node     = heap.pop();
+        touched.push_back(node);
+
+        for(int arc = graph.offsets[node]; arc < graph.offsets[node + 1]; ++arc)
+        {
+            relax(node, graph.targets[arc], distance + graph.weights[arc]);
+        }
+    }
+
+    std::sort(touched.begin(), touched.end());
+    touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+    return touched;
+}
@@ -0,0 +1,81 @@
+#ifndef SHORTESTPATH_H
+#define SHORTESTPATH_H
+
+#include <QtGlobal>
+
+#include <vector>
+
+/**
+ * Directed graph over dense node ids 0..nodeCount-1 in compressed sparse row form: the arcs
+ * leaving node n are targets[offsets[n]] .. targets[offsets[n + 1] - 1], with matching weights.
+ * The arcs entering n are kept the same way in the reverse arrays.
+ */
+struct CsrGraph
+{
+    struct Arc
+    {
+        int from   = 0;
+        int to     = 0;
+        int weight = 1;
+    };
+
+    std::vector<int> offsets {0};
+    std::vector<int> targets;
+    std::vector<int> weights;
+
+    std::vector<int> reverseOffsets {0};
+    std::vector<int> sources;
+    std::vector<int> reverseWeights;
+
+    static CsrGraph fromArcs(int nodeCount, const std::vector<Arc> &arcs);
+
+    /** Weight of the arc from @p from to @p to, or -1 if there is none. */
+    int             arcWeight(int from, int to) const;
+
+    int             nodeCount() const { return static_cast<int>(offsets.size()) - 1; }
+    int             arcCount() const { return static_cast<int>(targets.size()); }
+};
+
+/**
+ * Single-source shortest paths with a 4-ary heap, O(E log V).
+ *
+ * Besides the distance and the predecessor of every node, the search records the first hop out
+ * of the source, propagated along the tree as nodes are settled, so a routing table can be filled
+ * without walking predecessor chains afterwards.
+ */
+class ShortestPathTree
+{
+public:
+    static constexpr qint64 UNREACHABLE = -1;
+    static constexpr int    NO_NODE     = -1;
+
+    void   compute(const CsrGraph &graph, int source);
+
+    /**
+     * Brings the tree from the last compute() or repair() up to date with @p graph, in which only
+     * the arcs leaving @p changedNodes differ. New nodes may be appended; ids keep their meaning.
+     * Subtrees hanging off arcs that vanished or got dearer are cut and reattached, and cheaper or
+     * new arcs are propagated; the rest of the tree is not visited.
+     *
+     * Returns the nodes whose distance, parent or first hop may have changed, sorted.
+     */
+    std::vector<int> repair(const CsrGraph &graph, const std::vector<int> &changedNodes);
+
+    int    source() const { return m_source; }
+    int    nodeCount() const { return static_cast<int>(m_distance.size()); }
+
+    bool   isReachable(int node) const { return m_distance[node] != UNREACHABLE; }
+    qint64 distance(int node) const { return m_distance[node]; }
+    int    parent(int node) const { return m_parent[node]; }
+
+    /** Neighbour of the source the path to @p node starts with; NO_NODE for the source itself. */
+    int    firstHop(int node) const { return m_firstHop[node]; }
+
+private:
+    int                 m_source = NO_NODE;
+    std::vector<qint64> m_distance;
+    std::vector<int>    m_parent;
+    std::vector<int>    m_firstHop;
+};
+
+#endif    // SHORTESTPATH_H
@@ -0,0 +1,85 @@
+#include "SpfThrottle.h"
+
+SpfThrottle::SpfThrottle(quint64 initialDelay, quint64 holdTime, quint64 maxHoldTime) :
+    m_initialDelay(initialDelay),
+    m_initialHold(qMax<quint64>(holdTime, 1)),
+    m_maxHold(qMax(maxHoldTime, m_initialHold)),
+    m_hold(m_initialHold),
+    m_pending(false),
+    m_hasRun(false),
+    m_dueTime(0),
+    m_lastRun(0),
+    m_coalesced(0),
+    m_runs(0)
+{}
+
+quint64
+SpfThrottle::request(quint64 now)
+{
+    if(m_pending)
+    {
+        ++m_coalesced;
+        return m_dueTime;
+    }
+
+    m_pending = true;
+
+    if(m_hasRun && now < m_lastRun + m_hold)
+    {
+        // Still inside the hold of the last run: wait it out and back off further.
+        m_dueTime = m_lastRun + m_hold;
+        m_hold    = qMin(m_hold * 2, m_maxHold);
+    }
+    else
+    {
+        if(m_hasRun && now >= m_lastRun + m_maxHold) m_hold = m_initialHold;
+        m_dueTime = now + m_initialDelay;
+    }
+
+    return m_dueTime;
+}
+
+void
+SpfThrottle::completed(quint64 now)
+{
+    m_pending = false;
+    m_hasRun  = true;
+    m_lastRun = now;
+    ++m_runs;
+}
+
+bool
+SpfThrottle::isPending() const
+{
+    return m_pending;
+}
+
+bool
+SpfThrottle::isDue(quint64 now) const
+{
+    return m_pending && now >= m_dueTime;
+}
+
+quint64
+SpfThrottle::dueTime() const
+{
+    return m_dueTime;
+}
+
+quint64
+SpfThrottle::currentHold() const
+{
+    return m_hold;
+}
+
+quint64
+SpfThrottle::coalescedRequests() const
+{
+    return m_coalesced;
+}
+
+quint64
+SpfThrottle::runs() const
+{
+    return m_runs;
+}
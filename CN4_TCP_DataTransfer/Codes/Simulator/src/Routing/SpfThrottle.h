@@ -0,0 +1,49 @@
+#ifndef SPFTHROTTLE_H
+#define SPFTHROTTLE_H
+
+#include <QtGlobal>
+
+/**
+ * Decides when a requested SPF run actually happens.
+ *
+ * The first change after a quiet period is acted on after a short initial delay. Changes that
+ * arrive while a run is pending are folded into it, and a change that follows a run within the
+ * current hold time waits for the hold to expire, the hold doubling each time up to a maximum.
+ * Once nothing has been requested for a whole maximum hold, the hold drops back to its initial
+ * value. An LSA storm therefore costs one SPF run per hold window. Times are in ticks.
+ */
+class SpfThrottle
+{
+public:
+    explicit SpfThrottle(quint64 initialDelay = 1, quint64 holdTime = 5, quint64 maxHoldTime = 40);
+
+    /** Notes a topology change at @p now; returns the tick the SPF run is due. */
+    quint64 request(quint64 now);
+
+    /** Records that the pending run was done at @p now. */
+    void    completed(quint64 now);
+
+    bool    isPending() const;
+    bool    isDue(quint64 now) const;
+    quint64 dueTime() const;
+    quint64 currentHold() const;
+
+    /** Requests absorbed by a run that was already pending. */
+    quint64 coalescedRequests() const;
+    quint64 runs() const;
+
+private:
+    quint64 m_initialDelay;
+    quint64 m_initialHold;
+    quint64 m_maxHold;
+    quint64 m_hold;
+
+    bool    m_pending;
+    bool    m_hasRun;
+    quint64 m_dueTime;
+    quint64 m_lastRun;
+    quint64 m_coalesced;
+    quint64 m_runs;
+};
+
+#endif    // SPFTHROTTLE_H
@@ -1,5 +1,4 @@
 #include <QDebug>
-#include <QThread>
 #include <algorithm>
 #include <stdexcept>
 #include <QJsonArray>
@@ -46,6 +45,8 @@ void TopologyBuilder::createRouters() {
 
     int nodeCount = m_config.value("node_count").toInt();
     int portCount = m_config.value("router_port_count").toInt(6);
+    int bufferSize = m_config.value("router_buffer_size").toInt(0);    // 0: keep the global size
+    int serviceRate = m_config.value("port_service_rate").toInt(0);    // 0: keep the global rate
 
     if ((range.routerEndId - range.routerStartId + 1) != nodeCount) {
         throw std::runtime_error("Router count doesn't match assigned range.");
@@ -67,16 +68,12 @@ void TopologyBuilder::createRouters() {
             isBroken = true;
         }
 
+        // Routers run on the EventsCoordinator's worker pool, not on a thread of their own.
         auto router = QSharedPointer<Router>::create(routerId, "", portCount, nullptr, isBroken);
-        QThread *routerThread = new QThread(this);
-        router->moveToThread(routerThread);
-
-        connect(routerThread, &QThread::started, router.data(), &Router::initialize);
-        connect(routerThread, &QThread::finished, router.data(), &QObject::deleteLater);
-        connect(router.data(), &Router::finished, routerThread, &QThread::quit);
-        connect(router.data(), &Router::finished, routerThread, &QObject::deleteLater);
-
-        routerThread->start();
+        if (bufferSize > 0) router->setBufferSize(bufferSize);
+        if (serviceRate > 0) {
+            for (const auto &port : router->getPorts()) port->setServiceRate(serviceRate);
+        }
         m_routers.push_back(router);
         qDebug() << "Created Router with ID:" << routerId;
 
@@ -121,6 +118,9 @@ void TopologyBuilder::createPCs()
 
         int gatewayNodeId = gatewayObj.value("node").toInt();
         QJsonArray userArray = gatewayObj.value("users").toArray();
+        int trafficClass = gatewayObj.value("traffic_class").toInt(0);
+        // Either one algorithm for all the gateway's users or an object keyed by PC id.
+        QJsonValue congestionControl = gatewayObj.value("congestion_control");
 
         auto routerIt = std::find_if(m_routers.begin(), m_routers.end(),
                                                 [gatewayNodeId](const QSharedPointer<Router> &r) { return r->getId() == gatewayNodeId; });
@@ -141,13 +141,13 @@ void TopologyBuilder::createPCs()
             }
 
             auto pc = QSharedPointer<PC>::create(pcId, " ", nullptr);
-            QThread *pcThread = new QThread(this);
-            pc->moveToThread(pcThread);
-
-            connect(pcThread, &QThread::started, pc.data(), &PC::initialize);
-            connect(pcThread, &QThread::finished, pc.data(), &QObject::deleteLater);
-
-            pcThread->start();
+            pc->initialize();
+            pc->setTrafficClass(trafficClass);
+            QJsonValue algorithm = congestionControl.isObject()
+                                     ? congestionControl.toObject().value(QString::number(pcId))
+                                     : congestionControl;
+            if (algorithm.isString())
+                pc->setCongestionControl(CongestionControl::fromString(algorithm.toString()));
             m_pcs.push_back(pc);
 
             PortBindingManager bindingManager;
@@ -159,6 +159,7 @@ void TopologyBuilder::createPCs()
 
             bindingManager.bind(routerPort, pc->getPort(), gatewayNodeId, pcId);
             routerPort->connectToPC(pc);
+            (*routerIt)->attachHost(pc);
 
             qDebug() << "PC" << pcId << "bound to Router" << gatewayNodeId;
         }
@@ -0,0 +1,211 @@
+#include "BbrControl.h"
+
+#include <cmath>
+
+void
+BbrControl::onAck(const AckSample &sample)
+{
+    if(sample.newlyAcked == 0) return;
+
+    bool roundStart = sample.priorDelivered >= m_nextRoundDelivered;
+    if(roundStart)
+    {
+        m_nextRoundDelivered = sample.delivered;
+        ++m_round;
+    }
+
+    if(sample.deliveryRate > 0) updateBandwidth(sample.deliveryRate);
+    if(roundStart) checkFullPipe();
+
+    updateMode(sample);
+    updateWindow(sample);
+}
+
+void
+BbrControl::onLoss(LossEvent event, int pipe, SimTime_t now)
+{
+    Q_UNUSED(now)
+
+    // Losses don't change the model. Hold the window to what is in flight during recovery, restart
+    // from one segment after a timeout, and restore the window once the losses are repaired.
+    m_priorWindow = qMax(m_priorWindow, m_cwnd);
+    m_cwnd        = event == LossEvent::Timeout ? 1.0 : qMax(pipe + 1.0, static_cast<double>(MIN_WINDOW));
+}
+
+void
+BbrControl::onRecoveryEnd(int pipe, SimTime_t now)
+{
+    Q_UNUSED(pipe)
+    Q_UNUSED(now)
+
+    m_cwnd        = qMax(m_cwnd, m_priorWindow);
+    m_priorWindow = 0;
+}
+
+void
+BbrControl::onRttSample(SimTime_t rtt, SimTime_t now)
+{
+    m_minRttExpired = m_haveMinRtt && now - m_minRttStamp > ticks(MIN_RTT_WINDOW_SECONDS);
+
+    if(!m_haveMinRtt || rtt <= m_minRtt || m_minRttExpired)
+    {
+        m_haveMinRtt  = true;
+        m_minRtt      = rtt;
+        m_minRttStamp = now;
+    }
+}
+
+double
+BbrControl::pacingRate() const
+{
+    // Unpaced until the first delivery-rate sample; the window alone limits the sender then.
+    return m_pacingGain * bottleneckBandwidth();
+}
+
+double
+BbrControl::bottleneckBandwidth() const
+{
+    double best = 0;
+    for(const auto &sample : m_bandwidthSamples)
+    {
+        best = qMax(best, sample.second);
+    }
+    return best;
+}
+
+double
+BbrControl::bdp() const
+{
+    double bandwidth = bottleneckBandwidth();
+    if(!m_haveMinRtt || bandwidth <= 0) return INITIAL_WINDOW;
+
+    return bandwidth * qMax<SimTime_t>(m_minRtt, 1);
+}
+
+void
+BbrControl::updateBandwidth(double rate)
+{
+    if(!m_bandwidthSamples.empty() && m_bandwidthSamples.back().first == m_round)
+        m_bandwidthSamples.back().second = qMax(m_bandwidthSamples.back().second, rate);
+    else
+        m_bandwidthSamples.emplace_back(m_round, rate);
+
+    while(m_bandwidthSamples.front().first + BW_WINDOW_ROUNDS <= m_round)
+    {
+        m_bandwidthSamples.pop_front();
+    }
+}
+
+void
+BbrControl::checkFullPipe()
+{
+    if(m_filledPipe) return;
+
+    // The pipe is full once three rounds in a row failed to raise the bandwidth by 25%.
+    double bandwidth = bottleneckBandwidth();
+    if(bandwidth >= m_fullBandwidth * FULL_BW_GROWTH)
+    {
+        m_fullBandwidth      = bandwidth;
+        m_fullBandwidthCount = 0;
+        return;
+    }
+
+    if(++m_fullBandwidthCount >= FULL_BW_ROUNDS) m_filledPipe = true;
+}
+
+void
+BbrControl::updateMode(const AckSample &sample)
+{
+    if(m_mode == Mode::Startup && m_filledPipe)
+    {
+        m_mode       = Mode::Drain;
+        m_pacingGain = 1 / HIGH_GAIN;
+        m_cwndGain   = HIGH_GAIN;
+    }
+
+    if(m_mode == Mode::Drain && sample.pipe <= bdp()) enterProbeBw(sample.now);
+
+    if(m_mode == Mode::ProbeBw)
+    {
+        // Each phase lasts about one minimum RTT; the drain phase ends early once the queue the
+        // probe built is gone.
+        bool fullLength = sample.now - m_cycleStamp > qMax<SimTime_t>(m_minRtt, 1);
+        bool advance    = PACING_GAINS[m_cycleIndex] < 1 ? fullLength || sample.pipe <= bdp() : fullLength;
+
+        if(advance)
+        {
+            m_cycleIndex = (m_cycleIndex + 1) % static_cast<int>(PACING_GAINS.size());
+            m_cycleStamp = sample.now;
+            m_pacingGain = PACING_GAINS[m_cycleIndex];
+        }
+    }
+
+    if(m_minRttExpired && m_mode != Mode::ProbeRtt)
+    {
+        m_mode             = Mode::ProbeRtt;
+        m_pacingGain       = 1;
+        m_cwndGain         = 1;
+        m_priorWindow      = qMax(m_priorWindow, m_cwnd);
+        m_probeRttDraining = true;
+        m_minRttExpired    = false;
+    }
+
+    if(m_mode == Mode::ProbeRtt)
+    {
+        if(m_probeRttDraining && sample.pipe <= MIN_WINDOW)
+        {
+            m_probeRttDraining = false;
+            m_probeRttDone     = sample.now + ticks(PROBE_RTT_SECONDS);
+        }
+        else if(!m_probeRttDraining && sample.now >= m_probeRttDone)
+        {
+            m_minRttStamp = sample.now;
+            m_cwnd        = qMax(m_cwnd, m_priorWindow);
+            m_priorWindow = 0;
+
+            if(m_filledPipe)
+                enterProbeBw(sample.now);
+            else
+                enterStartup();
+        }
+    }
+}
+
+void
+BbrControl::updateWindow(const AckSample &sample)
+{
+    double target = qMax(m_cwndGain * bdp(), static_cast<double>(MIN_WINDOW));
+
+    // Grow by what was delivered; once the pipe is full, never beyond the target.
+    if(m_filledPipe)
+        m_cwnd = qMin(m_cwnd + sample.newlyAcked, target);
+    else if(m_cwnd < target || sample.delivered < static_cast<quint64>(INITIAL_WINDOW))
+        m_cwnd += sample.newlyAcked;
+
+    m_cwnd = qMax(m_cwnd, static_cast<double>(MIN_WINDOW));
+    if(m_mode == Mode::ProbeRtt) m_cwnd = qMin(m_cwnd, static_cast<double>(MIN_WINDOW));
+}
+
+void
+BbrControl::enterStartup()
+{
+    m_mode       = Mode::Startup;
+    m_pacingGain = HIGH_GAIN;
+    m_cwndGain   = HIGH_GAIN;
+}
+
+void
+BbrControl::enterProbeBw(SimTime_t now)
+{
+    m_mode       = Mode::ProbeBw;
+    m_cwndGain   = CWND_GAIN;
+    m_cycleIndex = 2;    // start cruising; the probe comes round in a few RTTs
+    m_cycleStamp = now;
+    m_pacingGain = PACING_GAINS[m_cycleIndex];
+}
+
+SimTime_t
+BbrControl::ticks(double seconds) const
+{
+    return qMax<SimTime_t>(1, static_cast<SimTime_t>(std::llround(seconds / secondsPerTick())));
+}
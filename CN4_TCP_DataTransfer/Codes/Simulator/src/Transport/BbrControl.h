@@ -0,0 +1,97 @@
+#ifndef BBRCONTROL_H
+#define BBRCONTROL_H
+
+#include <array>
+#include <deque>
+#include <utility>
+
+#include "CongestionControl.h"
+
+/**
+ * BBR, version 1.
+ *
+ * Instead of reacting to loss, BBR keeps a model of the path: the bottleneck bandwidth (the best
+ * delivery rate seen over the last ten round trips) and the minimum RTT (over the last ten seconds).
+ * It paces at a gain times that bandwidth and caps the window at a gain times their product, the
+ * BDP. Startup doubles the rate every round until the bandwidth stops growing, Drain empties the
+ * queue Startup built, ProbeBW then cycles the pacing gain through 1.25, 0.75 and six rounds at 1,
+ * and ProbeRTT drops to four segments for 200 ms whenever the minimum RTT has not been refreshed
+ * for ten seconds. Rates are in segments per tick; durations in seconds are converted with the
+ * tick duration.
+ */
+class BbrControl : public CongestionControl
+{
+public:
+    enum class Mode
+    {
+        Startup,
+        Drain,
+        ProbeBw,
+        ProbeRtt
+    };
+
+    static constexpr double HIGH_GAIN              = 2.885;    // 2 / ln 2
+    static constexpr double CWND_GAIN              = 2.0;
+    static constexpr int    BW_WINDOW_ROUNDS       = 10;
+    static constexpr int    FULL_BW_ROUNDS         = 3;
+    static constexpr double FULL_BW_GROWTH         = 1.25;
+    static constexpr double MIN_RTT_WINDOW_SECONDS = 10;
+    static constexpr double PROBE_RTT_SECONDS      = 0.2;
+    static constexpr int    MIN_WINDOW             = 4;
+
+    static constexpr std::array<double, 8> PACING_GAINS {1.25, 0.75, 1, 1, 1, 1, 1, 1};
+
+    CongestionAlgorithm algorithm() const override { return CongestionAlgorithm::Bbr; }
+
+    void onAck(const AckSample &sample) override;
+    void onLoss(LossEvent event, int pipe, SimTime_t now) override;
+    void onRecoveryEnd(int pipe, SimTime_t now) override;
+    void onRttSample(SimTime_t rtt, SimTime_t now) override;
+
+    double pacingRate() const override;
+    bool   inflatesInRecovery() const override { return false; }
+
+    Mode      mode() const { return m_mode; }
+    double    bottleneckBandwidth() const;
+    /** Minimum RTT in ticks; 0 until the first sample. */
+    SimTime_t minRtt() const { return m_minRtt; }
+    /** Estimated bandwidth-delay product in segments; the initial window until both are known. */
+    double    bdp() const;
+    bool      filledPipe() const { return m_filledPipe; }
+
+private:
+    void      updateBandwidth(double rate);
+    void      checkFullPipe();
+    void      updateMode(const AckSample &sample);
+    void      updateWindow(const AckSample &sample);
+    void      enterStartup();
+    void      enterProbeBw(SimTime_t now);
+    SimTime_t ticks(double seconds) const;
+
+    Mode   m_mode       = Mode::Startup;
+    double m_pacingGain = HIGH_GAIN;
+    double m_cwndGain   = HIGH_GAIN;
+
+    // Bandwidth max filter: the best rate of each of the last BW_WINDOW_ROUNDS round trips. A round
+    // ends when a segment sent after it began is acknowledged.
+    std::deque<std::pair<quint64, double>> m_bandwidthSamples;
+    quint64                                m_round              = 0;
+    quint64                                m_nextRoundDelivered = 0;
+
+    double m_fullBandwidth      = 0;
+    int    m_fullBandwidthCount = 0;
+    bool   m_filledPipe         = false;
+
+    bool      m_haveMinRtt    = false;
+    SimTime_t m_minRtt        = 0;
+    SimTime_t m_minRttStamp   = 0;
+    bool      m_minRttExpired = false;
+
+    int       m_cycleIndex       = 0;
+    SimTime_t m_cycleStamp       = 0;
+    bool      m_probeRttDraining = false;    // ProbeRTT: still waiting for the pipe to drain
+    SimTime_t m_probeRttDone     = 0;
+    double    m_priorWindow      = 0;
+};
+
+#endif    // BBRCONTROL_H
@@ -0,0 +1,153 @@
+#include "CongestionControl.h"
+
+#include "BbrControl.h"
+#include "CubicControl.h"
+
+std::unique_ptr<CongestionControl>
+CongestionControl::create(CongestionAlgorithm algorithm)
+{
+    switch(algorithm)
+    {
+    case CongestionAlgorithm::Dctcp:
+        return std::make_unique<DctcpControl>();
+    case CongestionAlgorithm::Cubic:
+        return std::make_unique<CubicControl>();
+    case CongestionAlgorithm::Bbr:
+        return std::make_unique<BbrControl>();
+    case CongestionAlgorithm::Reno:
+        break;
+    }
+
+    return std::make_unique<RenoControl>();
+}
+
+CongestionAlgorithm
+CongestionControl::fromString(const QString &name, CongestionAlgorithm fallback)
+{
+    QString key = name.trimmed().toLower();
+    if(key == "reno" || key == "newreno") return CongestionAlgorithm::Reno;
+    if(key == "dctcp") return CongestionAlgorithm::Dctcp;
+    if(key == "cubic") return CongestionAlgorithm::Cubic;
+    if(key == "bbr") return CongestionAlgorithm::Bbr;
+    return fallback;
+}
+
+QString
+CongestionControl::toString(CongestionAlgorithm algorithm)
+{
+    switch(algorithm)
+    {
+    case CongestionAlgorithm::Dctcp:
+        return "dctcp";
+    case CongestionAlgorithm::Cubic:
+        return "cubic";
+    case CongestionAlgorithm::Bbr:
+        return "bbr";
+    case CongestionAlgorithm::Reno:
+        break;
+    }
+
+    return "reno";
+}
+
+void
+CongestionControl::setTickDuration(std::chrono::milliseconds duration)
+{
+    s_secondsPerTick = qMax<qint64>(1, duration.count()) / 1000.0;
+}
+
+void
+CongestionControl::onRecoveryEnd(int pipe, SimTime_t now)
+{
+    Q_UNUSED(now)
+
+    // RFC 6582: deflate to ssthresh, or less if little is left in flight, to avoid a burst.
+    m_cwnd = qMin(m_ssthresh, qMax(pipe, 1) + 1.0);
+}
+
+void
+CongestionControl::onRttSample(SimTime_t rtt, SimTime_t now)
+{
+    Q_UNUSED(rtt)
+    Q_UNUSED(now)
+}
+
+void
+CongestionControl::onTick(SimTime_t now)
+{
+    Q_UNUSED(now)
+}
+
+bool
+CongestionControl::ecnReductionDue(const AckSample &sample)
+{
+    if(!sample.ecnEcho || sample.ackNumber <= m_ecnRecover) return false;
+
+    m_ecnRecover = sample.nextSequence;
+    ++m_ecnReductions;
+    return true;
+}
+
+void
+RenoControl::onAck(const AckSample &sample)
+{
+    if(sample.newlyAcked == 0 || sample.inRecovery) return;
+
+    // An ECN echo is a loss without the retransmission (RFC 3168).
+    if(ecnReductionDue(sample))
+    {
+        m_ssthresh = qMax(m_cwnd / 2, 2.0);
+        m_cwnd     = m_ssthresh;
+        return;
+    }
+
+    grow(sample.newlyAcked);
+}
+
+void
+RenoControl::onLoss(LossEvent event, int pipe, SimTime_t now)
+{
+    Q_UNUSED(now)
+
+    m_ssthresh = qMax(pipe / 2.0, 2.0);
+    m_cwnd     = event == LossEvent::Timeout ? 1.0 : m_ssthresh;
+}
+
+void
+RenoControl::grow(quint32 newlyAcked)
+{
+    m_cwnd += m_cwnd < m_ssthresh ? qMin(static_cast<double>(newlyAcked), 2.0) : static_cast<double>(newlyAcked) / m_cwnd;
+}
+
+void
+DctcpControl::onAck(const AckSample &sample)
+{
+    if(sample.newlyAcked == 0) return;
+
+    m_windowAcked += sample.newlyAcked;
+    if(sample.ecnEcho) m_windowMarked += sample.newlyAcked;
+
+    // A window of data has been acknowledged: fold its marked fraction into alpha and, if anything
+    // was marked, cut the window in proportion.
+    if(sample.ackNumber > m_windowEnd)
+    {
+        double fraction = m_windowAcked > 0 ? static_cast<double>(m_windowMarked) / m_windowAcked : 0;
+        m_alpha         = (1 - GAIN) * m_alpha + GAIN * fraction;
+
+        bool cut = m_windowMarked > 0 && !sample.inRecovery;
+
+        m_windowEnd    = sample.nextSequence;
+        m_windowAcked  = 0;
+        m_windowMarked = 0;
+
+        if(cut)
+        {
+            m_cwnd     = qMax(1.0, m_cwnd * (1 - m_alpha / 2));
+            m_ssthresh = qMax(m_cwnd, 2.0);
+            ++m_ecnReductions;
+            return;
+        }
+    }
+
+    if(!sample.inRecovery) grow(sample.newlyAcked);
+}
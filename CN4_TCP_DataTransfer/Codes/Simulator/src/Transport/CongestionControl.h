@@ -0,0 +1,141 @@
+#ifndef CONGESTIONCONTROL_H
+#define CONGESTIONCONTROL_H
+
+#include <QString>
+#include <chrono>
+#include <memory>
+
+#include "../EventsCoordinator/SimulationScheduler.h"
+
+enum class CongestionAlgorithm
+{
+    Reno,     // AIMD: halve on loss, about one segment per window in congestion avoidance
+    Dctcp,    // Reno growth; ECN echoes cut the window by the marked fraction (RFC 8257)
+    Cubic,    // window a cubic function of the time since the last reduction (RFC 9438)
+    Bbr       // model-based: paces at the estimated bottleneck rate, window from the BDP (BBRv1)
+};
+
+enum class LossEvent
+{
+    FastRetransmit,    // three duplicate ACKs
+    Timeout
+};
+
+/** What one ACK told the sender. Windows and counts are in segments, times in ticks. */
+struct AckSample
+{
+    SimTime_t now          = 0;
+    quint32   ackNumber    = 0;
+    quint32   nextSequence = 0;    // first segment not sent yet
+    quint32   newlyAcked   = 0;    // 0 for a duplicate ACK
+    int       pipe         = 0;    // segments still in the network after this ACK
+    bool      ecnEcho      = false;
+    bool      inRecovery   = false;
+
+    // Delivery-rate sample over the newest segment this ACK covers, in segments per tick (0 when
+    // there is none), and the delivery counts BBR uses to tell round trips apart.
+    double  deliveryRate   = 0;
+    quint64 delivered      = 0;    // segments delivered so far
+    quint64 priorDelivered = 0;    // delivered when that newest segment was sent
+};
+
+/**
+ * Congestion-control strategy of a TCPSender.
+ *
+ * The sender keeps loss detection, recovery and the retransmission timer, and asks the strategy for
+ * the congestion window and, for paced algorithms, the sending rate. The strategy hears about every
+ * ACK, each loss the sender detects, every RTT sample that passes Karn's rule and every tick. While
+ * in NewReno fast recovery the sender inflates the window on top of what the strategy sets, unless
+ * the strategy opts out.
+ */
+class CongestionControl
+{
+public:
+    static constexpr int INITIAL_WINDOW = 4;
+
+    virtual ~CongestionControl() = default;
+
+    static std::unique_ptr<CongestionControl> create(CongestionAlgorithm algorithm);
+
+    /** "reno", "dctcp", "cubic" or "bbr"; anything else gives @p fallback. */
+    static CongestionAlgorithm fromString(const QString &name, CongestionAlgorithm fallback = CongestionAlgorithm::Reno);
+    static QString             toString(CongestionAlgorithm algorithm);
+
+    /** Length of a tick, for the constants CUBIC and BBR define in seconds. */
+    static void   setTickDuration(std::chrono::milliseconds duration);
+    static double secondsPerTick() { return s_secondsPerTick; }
+
+    virtual CongestionAlgorithm algorithm() const = 0;
+
+    virtual void onAck(const AckSample &sample)                   = 0;
+    virtual void onLoss(LossEvent event, int pipe, SimTime_t now) = 0;
+    /** Fast recovery ended with an ACK covering everything sent before the loss. */
+    virtual void onRecoveryEnd(int pipe, SimTime_t now);
+    virtual void onRttSample(SimTime_t rtt, SimTime_t now);
+    virtual void onTick(SimTime_t now);
+
+    double window() const { return m_cwnd; }
+    double ssthresh() const { return m_ssthresh; }
+
+    /** Segments per tick the sender should pace at; 0 sends as fast as the window allows. */
+    virtual double pacingRate() const { return 0; }
+    /** Whether the sender inflates the window by each duplicate ACK during fast recovery. */
+    virtual bool   inflatesInRecovery() const { return true; }
+
+    /** Window reductions made in response to ECN echoes. */
+    quint64 ecnReductions() const { return m_ecnReductions; }
+
+protected:
+    /**
+     * RFC 3168: whether an ECN echo in @p sample calls for a reduction, at most once per window of
+     * data. Counts the reduction when it does.
+     */
+    bool ecnReductionDue(const AckSample &sample);
+
+    double  m_cwnd          = INITIAL_WINDOW;
+    double  m_ssthresh      = 1e9;
+    quint64 m_ecnReductions = 0;
+
+private:
+    quint32 m_ecnRecover = 0;
+
+    inline static double s_secondsPerTick = 0.1;
+};
+
+/** NewReno's window: slow start (RFC 3465, two segments per ACK at most), then AIMD. */
+class RenoControl : public CongestionControl
+{
+public:
+    CongestionAlgorithm algorithm() const override { return CongestionAlgorithm::Reno; }
+
+    void onAck(const AckSample &sample) override;
+    void onLoss(LossEvent event, int pipe, SimTime_t now) override;
+
+protected:
+    void grow(quint32 newlyAcked);
+};
+
+/**
+ * DCTCP: Reno's growth, but ECN echoes only cut the window by alpha / 2, where alpha is an EWMA of
+ * the fraction of segments marked per window of data.
+ */
+class DctcpControl : public RenoControl
+{
+public:
+    static constexpr double GAIN = 1.0 / 16;
+
+    CongestionAlgorithm algorithm() const override { return CongestionAlgorithm::Dctcp; }
+
+    void onAck(const AckSample &sample) override;
+
+    /** Starts at 1 so the first marks are taken seriously. */
+    double alpha() const { return m_alpha; }
+
+private:
+    double  m_alpha        = 1.0;
+    quint32 m_windowEnd    = 0;
+    quint64 m_windowAcked  = 0;
+    quint64 m_windowMarked = 0;
+};
+
+#endif    // CONGESTIONCONTROL_H
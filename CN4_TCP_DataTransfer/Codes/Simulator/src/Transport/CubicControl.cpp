@@ -0,0 +1,84 @@
+#include "CubicControl.h"
+
+#include <cmath>
+
+void
+CubicControl::onAck(const AckSample &sample)
+{
+    if(sample.newlyAcked == 0 || sample.inRecovery) return;
+
+    if(ecnReductionDue(sample))
+    {
+        reduce();
+        return;
+    }
+
+    if(m_cwnd < m_ssthresh)
+    {
+        grow(sample.newlyAcked);
+        return;
+    }
+
+    if(!m_epochStarted)
+    {
+        m_epochStarted = true;
+        m_epochStart   = sample.now;
+        m_renoWindow   = m_cwnd;
+
+        if(m_cwnd < m_windowMax)
+        {
+            m_k            = std::cbrt((m_windowMax - m_cwnd) / C);
+            m_originWindow = m_windowMax;
+        }
+        else
+        {
+            m_k            = 0;
+            m_originWindow = m_cwnd;
+        }
+    }
+
+    // Aim for where the curve will be one RTT from now, and never more than 1.5 times the window.
+    double rtt    = m_haveMinRtt ? m_minRtt * secondsPerTick() : 0;
+    double t      = (sample.now - m_epochStart) * secondsPerTick() + rtt;
+    double target = m_originWindow + C * std::pow(t - m_k, 3);
+    target        = qBound(m_cwnd, target, 1.5 * m_cwnd);
+
+    // Reno-friendly region: W_est grows by 3 * (1 - beta) / (1 + beta) segments per window.
+    m_renoWindow += 3 * (1 - BETA) / (1 + BETA) * sample.newlyAcked / m_cwnd;
+
+    if(m_renoWindow > target)
+        m_cwnd = m_renoWindow;
+    else
+        m_cwnd += (target - m_cwnd) / m_cwnd * sample.newlyAcked;
+}
+
+void
+CubicControl::onLoss(LossEvent event, int pipe, SimTime_t now)
+{
+    Q_UNUSED(pipe)
+    Q_UNUSED(now)
+
+    reduce();
+    if(event == LossEvent::Timeout) m_cwnd = 1;
+}
+
+void
+CubicControl::onRttSample(SimTime_t rtt, SimTime_t now)
+{
+    Q_UNUSED(now)
+
+    if(!m_haveMinRtt || rtt < m_minRtt) m_minRtt = rtt;
+    m_haveMinRtt = true;
+}
+
+void
+CubicControl::reduce()
+{
+    // Fast convergence: a flow that lost below its previous maximum releases some of its share.
+    m_windowMax     = m_cwnd < m_lastWindowMax ? m_cwnd * (1 + BETA) / 2 : m_cwnd;
+    m_lastWindowMax = m_cwnd;
+
+    m_ssthresh     = qMax(m_cwnd * BETA, 2.0);
+    m_cwnd         = m_ssthresh;
+    m_epochStarted = false;
+}
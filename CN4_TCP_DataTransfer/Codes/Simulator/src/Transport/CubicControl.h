@@ -0,0 +1,44 @@
+#ifndef CUBICCONTROL_H
+#define CUBICCONTROL_H
+
+#include "CongestionControl.h"
+
+/**
+ * CUBIC (RFC 9438).
+ *
+ * After a reduction the window follows W(t) = C * (t - K)^3 + Wmax, where t is the time since the
+ * reduction and K the time it takes to climb back to Wmax: fast while far below Wmax, flat around
+ * it, then probing faster again beyond it. Reductions use beta = 0.7, with fast convergence lowering
+ * Wmax when a flow keeps losing below its previous maximum. The window never grows slower than
+ * Reno would (the Reno-friendly region). Slow start below ssthresh is Reno's. Constants are in
+ * seconds, converted with the tick duration.
+ */
+class CubicControl : public RenoControl
+{
+public:
+    static constexpr double BETA = 0.7;
+    static constexpr double C    = 0.4;    // segments / s^3
+
+    CongestionAlgorithm algorithm() const override { return CongestionAlgorithm::Cubic; }
+
+    void onAck(const AckSample &sample) override;
+    void onLoss(LossEvent event, int pipe, SimTime_t now) override;
+    void onRttSample(SimTime_t rtt, SimTime_t now) override;
+
+    double windowMax() const { return m_windowMax; }
+
+private:
+    void reduce();
+
+    double    m_windowMax     = 0;
+    double    m_lastWindowMax = 0;
+    double    m_renoWindow    = 0;     // W_est, the window Reno would have by now
+    double    m_originWindow  = 0;
+    double    m_k             = 0;     // seconds
+    bool      m_epochStarted  = false;
+    SimTime_t m_epochStart    = 0;
+    bool      m_haveMinRtt    = false;
+    SimTime_t m_minRtt        = 0;     // ticks
+};
+
+#endif    // CUBICCONTROL_H
@@ -0,0 +1,121 @@
+#include "TCPReceiver.h"
+
+TCPReceiver::TCPReceiver(int capacity) : m_ring(qMax(1, capacity)) {}
+
+TCPReceiver::Arrival
+TCPReceiver::onSegment(quint32 sequence, const QByteArray &payload)
+{
+    ++m_stats.received;
+
+    if(sequence < m_nextExpected)
+    {
+        ++m_stats.duplicates;
+        return Arrival::Duplicate;
+    }
+
+    // Beyond the window its slot may alias one that is held, so this goes before the held() test.
+    if(sequence - m_nextExpected >= static_cast<quint32>(m_ring.size()))
+    {
+        ++m_stats.outOfWindow;
+        return Arrival::OutOfWindow;
+    }
+
+    if(sequence != m_nextExpected && held(sequence))
+    {
+        ++m_stats.duplicates;
+        return Arrival::Duplicate;
+    }
+
+    m_lastArrival = sequence;
+
+    if(sequence != m_nextExpected)
+    {
+        Slot &waiting   = slot(sequence);
+        waiting.present = true;
+        waiting.payload = payload;
+
+        ++m_buffered;
+        ++m_stats.outOfOrder;
+        m_stats.highWatermark = qMax(m_stats.highWatermark, m_buffered);
+        m_highestEnd          = qMax(m_highestEnd, sequence + 1);
+        return Arrival::OutOfOrder;
+    }
+
+    deliver(payload);
+    ++m_nextExpected;
+
+    // The hole is filled: everything that was waiting right behind it goes up as well.
+    while(held(m_nextExpected))
+    {
+        Slot &next = slot(m_nextExpected);
+        deliver(next.payload);
+        next.present = false;
+        next.payload.clear();
+        --m_buffered;
+        ++m_nextExpected;
+    }
+    m_highestEnd = qMax(m_highestEnd, m_nextExpected);
+
+    return Arrival::InOrder;
+}
+
+void
+TCPReceiver::fillAck(TCPHeader &header) const
+{
+    header.setAcknowledgmentNumber(m_nextExpected);
+    header.clearSackBlocks();
+    if(m_buffered == 0) return;
+
+    // Runs of held segments above the cumulative acknowledgment, lowest first.
+    QVector<TCPHeader::SackBlock> blocks;
+    for(quint32 sequence = m_nextExpected + 1; sequence < m_highestEnd; ++sequence)
+    {
+        if(!held(sequence)) continue;
+
+        TCPHeader::SackBlock block;
+        block.left = sequence;
+        while(sequence < m_highestEnd && held(sequence)) ++sequence;
+        block.right = sequence;
+        blocks.append(block);
+    }
+
+    // The block holding the latest arrival goes first, then the others in order.
+    for(const auto &block : blocks)
+    {
+        if(m_lastArrival >= block.left && m_lastArrival < block.right) header.addSackBlock(block.left, block.right);
+    }
+    for(const auto &block : blocks)
+    {
+        if(m_lastArrival < block.left || m_lastArrival >= block.right) header.addSackBlock(block.left, block.right);
+    }
+}
+
+QByteArray
+TCPReceiver::read()
+{
+    QByteArray data = m_readable;
+    m_readable.clear();
+    return data;
+}
+
+int
+TCPReceiver::holes() const
+{
+    int  holes  = 0;
+    bool inHole = false;
+    for(quint32 sequence = m_nextExpected; sequence < m_highestEnd; ++sequence)
+    {
+        bool missing = !held(sequence);
+        if(missing && !inHole) ++holes;
+        inHole = missing;
+    }
+    return holes;
+}
+
+void
+TCPReceiver::deliver(const QByteArray &payload)
+{
+    m_readable.append(payload);
+    ++m_stats.delivered;
+    m_stats.deliveredBytes += static_cast<quint64>(payload.size());
+}
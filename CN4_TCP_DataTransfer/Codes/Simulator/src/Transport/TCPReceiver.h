@@ -0,0 +1,84 @@
+#ifndef TCPRECEIVER_H
+#define TCPRECEIVER_H
+
+#include <QByteArray>
+#include <QVector>
+
+#include "../Header/TCPHeader.h"
+
+struct TCPReceiverStats
+{
+    quint64 received       = 0;    // segments, duplicates included
+    quint64 delivered      = 0;    // segments handed to the application in order
+    quint64 deliveredBytes = 0;
+    quint64 outOfOrder     = 0;    // arrived above a hole and were held
+    quint64 duplicates     = 0;
+    quint64 outOfWindow    = 0;    // too far ahead of the buffer, dropped
+    int     highWatermark  = 0;    // most segments held out of order at once
+};
+
+/**
+ * Receiver side of one TCP connection, counted in segments like TCPSender.
+ *
+ * Segments that arrive above a hole wait in a fixed ring indexed by sequence number modulo its
+ * capacity, which covers the window [nextExpected, nextExpected + capacity). Filling the hole
+ * delivers the whole run in order to the application stream that read() drains. The ACK for every
+ * arrival carries the cumulative acknowledgment and SACK blocks for what is held beyond it, the
+ * block with the latest arrival first (RFC 2018).
+ */
+class TCPReceiver
+{
+public:
+    static constexpr int DEFAULT_CAPACITY = 256;
+
+    enum class Arrival
+    {
+        InOrder,       // delivered, possibly with segments that were waiting behind it
+        OutOfOrder,    // held until the hole below it is filled
+        Duplicate,
+        OutOfWindow
+    };
+
+    explicit TCPReceiver(int capacity = DEFAULT_CAPACITY);
+
+    Arrival onSegment(quint32 sequence, const QByteArray &payload);
+
+    /** Cumulative acknowledgment: the next segment not yet received in order. */
+    quint32 nextExpected() const { return m_nextExpected; }
+
+    /** Sets the acknowledgment number and SACK blocks of @p header. */
+    void fillAck(TCPHeader &header) const;
+
+    /** Takes the in-order bytes delivered since the last call. */
+    QByteArray read();
+
+    int capacity() const { return m_ring.size(); }
+    /** Segments held out of order. */
+    int buffered() const { return m_buffered; }
+    /** Missing runs between the cumulative acknowledgment and the highest segment held. */
+    int holes() const;
+
+    TCPReceiverStats stats() const { return m_stats; }
+
+private:
+    struct Slot
+    {
+        bool       present = false;
+        QByteArray payload;
+    };
+
+    Slot &slot(quint32 sequence) { return m_ring[static_cast<int>(sequence % m_ring.size())]; }
+    bool  held(quint32 sequence) const { return m_ring[static_cast<int>(sequence % m_ring.size())].present; }
+    void  deliver(const QByteArray &payload);
+
+    QVector<Slot> m_ring;
+    quint32       m_nextExpected = 0;
+    quint32       m_highestEnd   = 0;    // one past the highest segment held
+    quint32       m_lastArrival  = 0;
+    int           m_buffered     = 0;
+    QByteArray    m_readable;
+
+    TCPReceiverStats m_stats;
+};
+
+#endif    // TCPRECEIVER_H
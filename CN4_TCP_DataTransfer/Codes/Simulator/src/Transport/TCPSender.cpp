@@ -0,0 +1,305 @@
+#include "TCPSender.h"
+
+#include <cmath>
+#include <iterator>
+
+TCPSender::TCPSender() : m_cc(CongestionControl::create(CongestionAlgorithm::Reno)) {}
+
+void
+TCPSender::setCongestionControl(CongestionAlgorithm algorithm)
+{
+    m_cc        = CongestionControl::create(algorithm);
+    m_inflation = 0;
+}
+
+bool
+TCPSender::nextRetransmission(quint32 &sequence, QByteArray &payload) const
+{
+    if(m_lost.empty()) return false;
+    if(!m_forceHead && pipe() >= static_cast<int>(window())) return false;
+    if(!m_forceHead && paced() && m_pacingCredit < 1) return false;
+
+    sequence = *m_lost.begin();
+    payload  = m_segments.value(sequence).payload;
+    return true;
+}
+
+void
+TCPSender::onRetransmitted(quint32 sequence, SimTime_t now)
+{
+    auto it = m_segments.find(sequence);
+    if(it == m_segments.end()) return;
+
+    m_lost.erase(sequence);
+    stamp(*it, now);
+    it->retransmitted = true;
+    m_forceHead       = false;
+    consumePacing();
+    ++m_stats.retransmitted;
+
+    if(!m_timerRunning) armTimer(now);
+}
+
+bool
+TCPSender::canSendNew() const
+{
+    if(paced() && m_pacingCredit < 1) return false;
+    return m_lost.empty() && pipe() < static_cast<int>(window());
+}
+
+quint32
+TCPSender::onSent(const QByteArray &payload, SimTime_t now)
+{
+    quint32 sequence = m_nextSequence++;
+
+    Segment segment;
+    segment.payload = payload;
+    stamp(segment, now);
+    m_segments.insert(sequence, segment);
+    consumePacing();
+    ++m_stats.sent;
+
+    if(!m_timerRunning) armTimer(now);
+    return sequence;
+}
+
+void
+TCPSender::onAck(quint32 ackNumber, bool ecnEcho, SimTime_t now, const QList<TCPHeader::SackBlock> &sackBlocks)
+{
+    if(ecnEcho) ++m_stats.ecnEchoes;
+
+    // Acknowledges data never sent.
+    if(ackNumber > m_nextSequence) return;
+
+    applySack(sackBlocks);
+
+    if(ackNumber > m_unacknowledged)
+    {
+        quint32 newlyAcked = ackNumber - m_unacknowledged;
+
+        AckSample sample;
+        sample.now          = now;
+        sample.ackNumber    = ackNumber;
+        sample.nextSequence = m_nextSequence;
+        sample.newlyAcked   = newlyAcked;
+        sample.ecnEcho      = ecnEcho;
+
+        m_delivered += newlyAcked;
+        sample.delivered = m_delivered;
+
+        auto newest = m_segments.constFind(ackNumber - 1);
+        if(newest != m_segments.cend())
+        {
+            // Karn's rule: a segment that was resent gives no RTT sample.
+            if(!newest->retransmitted) sampleRtt(now - newest->sentAt, now);
+
+            SimTime_t interval    = qMax<SimTime_t>(1, now - newest->deliveredTime);
+            sample.deliveryRate   = static_cast<double>(m_delivered - newest->delivered) / interval;
+            sample.priorDelivered = newest->delivered;
+        }
+        m_deliveredTime = now;
+
+        while(!m_segments.isEmpty() && m_segments.firstKey() < ackNumber)
+        {
+            m_lost.erase(m_segments.firstKey());
+            m_sacked.erase(m_segments.firstKey());
+            m_segments.erase(m_segments.begin());
+        }
+        m_unacknowledged = ackNumber;
+        m_duplicateAcks  = 0;
+        m_stats.acked += newlyAcked;
+
+        if(m_inRecovery)
+        {
+            if(static_cast<qint64>(ackNumber) > m_recover)
+            {
+                // Full ACK: everything sent before the loss has arrived.
+                m_inRecovery = false;
+                m_inflation  = 0;
+                m_cc->onRecoveryEnd(pipe(), now);
+            }
+            else
+            {
+                // Partial ACK: the next hole was lost as well. Resend it now and take back the
+                // inflation the acknowledged segments had added.
+                markLost(ackNumber, true);
+                markSackHoles();
+                m_inflation = qMax(0.0, m_inflation - newlyAcked + 1);
+            }
+        }
+
+        sample.pipe       = pipe();
+        sample.inRecovery = m_inRecovery;
+        m_cc->onAck(sample);
+
+        if(m_segments.isEmpty())
+            m_timerRunning = false;
+        else
+            armTimer(now);
+        return;
+    }
+
+    if(ackNumber != m_unacknowledged || m_segments.isEmpty()) return;
+
+    ++m_duplicateAcks;
+    ++m_stats.duplicateAcks;
+
+    if(m_inRecovery)
+    {
+        // Each duplicate means another segment has left the network; with SACK, pipe() already
+        // knows which one.
+        if(inflates()) m_inflation += 1;
+        markSackHoles();
+        return;
+    }
+
+    // NewReno only starts a new recovery once the previous one's data has been acknowledged.
+    if(m_duplicateAcks == DUP_ACK_THRESHOLD && static_cast<qint64>(ackNumber) > m_recover)
+    {
+        m_cc->onLoss(LossEvent::FastRetransmit, pipe(), now);
+        m_recover    = static_cast<qint64>(m_nextSequence) - 1;
+        m_inRecovery = true;
+        m_inflation  = inflates() ? DUP_ACK_THRESHOLD : 0;
+        markLost(ackNumber, true);
+        markSackHoles();
+        ++m_stats.fastRetransmits;
+    }
+}
+
+bool
+TCPSender::onTick(SimTime_t now)
+{
+    double rate = m_cc->pacingRate();
+    if(rate > 0)
+    {
+        // Keep at most a couple of segments' worth of budget so an idle spell can't turn into a burst.
+        m_pacingCredit = qMin(m_pacingCredit + rate * (now - m_lastPacingTick), qMax(rate, 2.0));
+    }
+    m_lastPacingTick = now;
+    m_cc->onTick(now);
+
+    if(!m_timerRunning || m_segments.isEmpty() || now < m_rtoDeadline) return false;
+
+    m_cc->onLoss(LossEvent::Timeout, pipe(), now);
+    m_inflation     = 0;
+    m_inRecovery    = false;
+    m_duplicateAcks = 0;
+    m_recover       = static_cast<qint64>(m_nextSequence) - 1;
+
+    for(auto it = m_segments.cbegin(); it != m_segments.cend(); ++it)
+    {
+        if(!m_sacked.count(it.key())) m_lost.insert(it.key());
+    }
+    m_forceHead = true;
+
+    m_rto = qMin(m_rto * 2, MAX_RTO);
+    armTimer(now);
+    ++m_stats.timeouts;
+    return true;
+}
+
+TCPSenderStats
+TCPSender::stats() const
+{
+    TCPSenderStats stats = m_stats;
+    stats.windowCuts     = m_cc->ecnReductions();
+    stats.algorithm      = m_cc->algorithm();
+    stats.window         = window();
+    stats.ssthresh       = ssthresh();
+    stats.pacingRate     = m_cc->pacingRate();
+    stats.srtt           = m_srtt;
+    return stats;
+}
+
+void
+TCPSender::markLost(quint32 sequence, bool force)
+{
+    if(!m_segments.contains(sequence) || m_sacked.count(sequence)) return;
+
+    m_lost.insert(sequence);
+    if(force) m_forceHead = true;
+}
+
+void
+TCPSender::applySack(const QList<TCPHeader::SackBlock> &sackBlocks)
+{
+    for(const auto &block : sackBlocks)
+    {
+        m_sackSeen = true;
+
+        quint32 right = qMin(block.right, m_nextSequence);
+        for(quint32 sequence = qMax(block.left, m_unacknowledged); sequence < right; ++sequence)
+        {
+            if(!m_segments.contains(sequence) || !m_sacked.insert(sequence).second) continue;
+
+            // It arrived after all, whether or not it was already queued for resending.
+            m_lost.erase(sequence);
+            ++m_stats.sacked;
+        }
+    }
+}
+
+void
+TCPSender::markSackHoles()
+{
+    if(m_sacked.size() < static_cast<size_t>(DUP_ACK_THRESHOLD)) return;
+
+    // RFC 6675 IsLost(): a segment with DUP_ACK_THRESHOLD SACKed segments above it is gone. Resent
+    // segments are left to partial ACKs and the timer, so a hole isn't resent on every ACK.
+    auto    third = m_sacked.rbegin();
+    std::advance(third, DUP_ACK_THRESHOLD - 1);
+    quint32 limit = *third;
+
+    for(auto it = m_segments.cbegin(); it != m_segments.cend() && it.key() < limit; ++it)
+    {
+        if(!it->retransmitted) markLost(it.key(), false);
+    }
+}
+
+void
+TCPSender::sampleRtt(SimTime_t rtt, SimTime_t now)
+{
+    double sample = static_cast<double>(qMax<SimTime_t>(rtt, 0));
+
+    if(!m_haveRtt)
+    {
+        m_srtt    = sample;
+        m_rttvar  = sample / 2;
+        m_haveRtt = true;
+    }
+    else
+    {
+        m_rttvar = 0.75 * m_rttvar + 0.25 * std::abs(m_srtt - sample);
+        m_srtt   = 0.875 * m_srtt + 0.125 * sample;
+    }
+
+    // The clock granularity G is one tick.
+    SimTime_t rto = static_cast<SimTime_t>(std::ceil(m_srtt + qMax(1.0, 4 * m_rttvar)));
+    m_rto         = qBound(MIN_RTO, rto, MAX_RTO);
+
+    m_cc->onRttSample(qMax<SimTime_t>(rtt, 0), now);
+}
+
+void
+TCPSender::stamp(Segment &segment, SimTime_t now)
+{
+    // Coming back from idle, the delivery clock restarts now rather than at the last ACK.
+    if(m_segments.isEmpty()) m_deliveredTime = now;
+
+    segment.sentAt        = now;
+    segment.delivered     = m_delivered;
+    segment.deliveredTime = m_deliveredTime;
+}
+
+void
+TCPSender::consumePacing()
+{
+    if(paced()) m_pacingCredit = qMax(0.0, m_pacingCredit - 1);
+}
+
+void
+TCPSender::armTimer(SimTime_t now)
+{
+    m_timerRunning = true;
+    m_rtoDeadline  = now + m_rto;
+}
@@ -0,0 +1,175 @@
+#ifndef TCPSENDER_H
+#define TCPSENDER_H
+
+#include <QByteArray>
+#include <QMap>
+#include <memory>
+#include <set>
+
+#include "../EventsCoordinator/SimulationScheduler.h"
+#include "../Header/TCPHeader.h"
+#include "CongestionControl.h"
+
+struct TCPSenderStats
+{
+    quint64 sent            = 0;    // new segments
+    quint64 retransmitted   = 0;
+    quint64 acked           = 0;    // segments cumulatively acknowledged
+    quint64 duplicateAcks   = 0;
+    quint64 sacked          = 0;    // segments reported received by SACK before the cumulative ACK
+    quint64 fastRetransmits = 0;
+    quint64 timeouts        = 0;
+    quint64 ecnEchoes       = 0;    // ACKs that came back with ECE
+    quint64 windowCuts      = 0;    // reductions in response to ECN echoes
+
+    // Snapshot of the state at the time stats() was called; windows in segments, times in ticks.
+    CongestionAlgorithm algorithm  = CongestionAlgorithm::Reno;
+    double              window     = 0;
+    double              ssthresh   = 0;
+    double              pacingRate = 0;    // segments per tick, 0 when unpaced
+    double              srtt       = 0;
+};
+
+/**
+ * Sender side of one TCP connection, counted in segments (one packet each) and simulation ticks.
+ *
+ * The window itself comes from a CongestionControl strategy, Reno unless set otherwise; the sender
+ * feeds it ACKs, losses, RTT samples and ticks, and paces new data when the strategy asks for it.
+ * Three duplicate ACKs trigger a fast retransmit and NewReno fast recovery (RFC 6582): further
+ * duplicates inflate the window, a partial ACK resends the next hole straight away and only an ACK
+ * covering everything sent before the loss ends recovery. The retransmission timer follows RFC 6298,
+ * with Karn's rule and exponential backoff; a timeout takes every outstanding segment as lost and
+ * resends them as the window reopens. With ECN on, segments go out ECN-capable and ECE echoes are
+ * passed on to the strategy.
+ *
+ * SACK blocks on the ACKs feed a scoreboard (RFC 6675): SACKed segments no longer count as in the
+ * network, and in recovery every hole with three SACKed segments above it is taken as lost, so
+ * several losses in one window are resent within a round trip instead of one per partial ACK. Once
+ * the receiver has sent SACK, the window is no longer inflated by duplicate ACKs.
+ *
+ * The owner puts nextRetransmission() on the link first, then new data while canSendNew() allows,
+ * and reports each segment with onRetransmitted() / onSent() as it goes out.
+ */
+class TCPSender
+{
+public:
+    static constexpr int       INITIAL_WINDOW    = CongestionControl::INITIAL_WINDOW;
+    static constexpr int       DUP_ACK_THRESHOLD = 3;
+    static constexpr SimTime_t INITIAL_RTO       = 30;
+    static constexpr SimTime_t MIN_RTO           = 2;
+    static constexpr SimTime_t MAX_RTO           = 600;
+
+    TCPSender();
+
+    void setEcn(bool enabled) { m_ecn = enabled; }
+    bool ecn() const { return m_ecn; }
+
+    /** Replaces the strategy; meant to be called before the first segment goes out. */
+    void                     setCongestionControl(CongestionAlgorithm algorithm);
+    const CongestionControl &congestionControl() const { return *m_cc; }
+
+    /**
+     * The oldest segment waiting to be resent, if the window has room for it. The segment a fast
+     * retransmit, partial ACK or timeout just picked goes out even when the window is full.
+     */
+    bool nextRetransmission(quint32 &sequence, QByteArray &payload) const;
+    void onRetransmitted(quint32 sequence, SimTime_t now);
+
+    /**
+     * Whether a new segment fits in the window and, when paced, the rate allows it; never while a
+     * lost segment still waits.
+     */
+    bool    canSendNew() const;
+    /** Records a new segment carrying @p payload and returns its sequence number. */
+    quint32 onSent(const QByteArray &payload, SimTime_t now);
+
+    /**
+     * A cumulative ACK: @p ackNumber is the next segment the receiver expects, @p sackBlocks the
+     * segments it holds beyond that.
+     */
+    void onAck(quint32 ackNumber, bool ecnEcho, SimTime_t now,
+               const QList<TCPHeader::SackBlock> &sackBlocks = {});
+
+    /**
+     * Once per tick: refills the pacing budget, lets the strategy see the time and fires the
+     * retransmission timer when it has expired by @p now. Returns whether the timer fired.
+     */
+    bool onTick(SimTime_t now);
+
+    /** The strategy's window plus the fast-recovery inflation. */
+    double    window() const { return m_cc->window() + m_inflation; }
+    double    ssthresh() const { return m_cc->ssthresh(); }
+    SimTime_t rto() const { return m_rto; }
+    /** Whether the retransmission timer is running, and the tick it fires on. */
+    bool      timerRunning() const { return m_timerRunning && !m_segments.isEmpty(); }
+    SimTime_t rtoDeadline() const { return m_rtoDeadline; }
+    bool      inRecovery() const { return m_inRecovery; }
+    quint32   nextSequence() const { return m_nextSequence; }
+    quint32   unacknowledged() const { return m_unacknowledged; }
+    int       outstanding() const { return static_cast<int>(m_segments.size()); }
+    int       sacked() const { return static_cast<int>(m_sacked.size()); }
+    /** Segments believed to be in the network: outstanding ones neither SACKed nor marked lost. */
+    int       pipe() const { return outstanding() - static_cast<int>(m_lost.size() + m_sacked.size()); }
+
+    TCPSenderStats stats() const;
+
+private:
+    struct Segment
+    {
+        QByteArray payload;
+        SimTime_t  sentAt        = 0;
+        bool       retransmitted = false;
+
+        // Delivery state when the segment was (re)sent, for the rate sample its ACK yields.
+        quint64   delivered     = 0;
+        SimTime_t deliveredTime = 0;
+    };
+
+    void markLost(quint32 sequence, bool force);
+    void applySack(const QList<TCPHeader::SackBlock> &sackBlocks);
+    void markSackHoles();
+    bool inflates() const { return m_cc->inflatesInRecovery() && !m_sackSeen; }
+    void sampleRtt(SimTime_t rtt, SimTime_t now);
+    void stamp(Segment &segment, SimTime_t now);
+    bool paced() const { return m_cc->pacingRate() > 0; }
+    void consumePacing();
+    void armTimer(SimTime_t now);
+
+    std::unique_ptr<CongestionControl> m_cc;
+
+    QMap<quint32, Segment> m_segments;    // sent and not yet acknowledged, by sequence number
+    std::set<quint32>      m_lost;        // outstanding segments waiting to be resent
+    std::set<quint32>      m_sacked;      // outstanding segments the receiver already holds
+    bool                   m_sackSeen = false;
+    bool                   m_forceHead = false;
+
+    quint32 m_nextSequence   = 0;
+    quint32 m_unacknowledged = 0;
+
+    double  m_inflation     = 0;    // duplicates seen during fast recovery
+    int     m_duplicateAcks = 0;
+    bool    m_inRecovery    = false;
+    qint64  m_recover       = -1;    // highest sequence sent when the last loss was detected
+
+    // RFC 6298 estimator, in ticks.
+    bool      m_haveRtt      = false;
+    double    m_srtt         = 0;
+    double    m_rttvar       = 0;
+    SimTime_t m_rto          = INITIAL_RTO;
+    bool      m_timerRunning = false;
+    SimTime_t m_rtoDeadline  = 0;
+
+    // Delivery-rate estimation (segments acknowledged, and when the count last moved).
+    quint64   m_delivered     = 0;
+    SimTime_t m_deliveredTime = 0;
+
+    // Pacing budget in segments, refilled at the strategy's rate every tick.
+    double    m_pacingCredit   = 0;
+    SimTime_t m_lastPacingTick = 0;
+
+    bool m_ecn = false;
+
+    TCPSenderStats m_stats;
+};
+
+#endif    // TCPSENDER_H
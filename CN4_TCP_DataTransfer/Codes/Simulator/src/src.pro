@@ -16,13 +16,34 @@ RESOURCES += \
 SOURCES += \
     $$PWD/DHCPServer/DHCPServer.cpp \
     $$PWD/EventsCoordinator/EventsCoordinator.cpp \
+    $$PWD/EventsCoordinator/SimulationScheduler.cpp \
+    $$PWD/EventsCoordinator/TickExecutor.cpp \
+    $$PWD/EventsCoordinator/TimerService.cpp \
+    $$PWD/EventsCoordinator/TimingWheel.cpp \
     $$PWD/IP/IP.cpp \
     $$PWD/PortBindingManager/PortBindingManager.cpp \
     $$PWD/Port/Port.cpp \
+    $$PWD/Queue/ActiveQueueManager.cpp \
+    $$PWD/Queue/OutputQueue.cpp \
+    $$PWD/Transport/BbrControl.cpp \
+    $$PWD/Transport/CongestionControl.cpp \
+    $$PWD/Transport/CubicControl.cpp \
+    $$PWD/Transport/TCPReceiver.cpp \
+    $$PWD/Transport/TCPSender.cpp \
+    $$PWD/Routing/ForwardingTable.cpp \
+    $$PWD/Routing/EpochReclaimer.cpp \
+    $$PWD/Routing/LinkStateDatabase.cpp \
+    $$PWD/Routing/RipAdvertiser.cpp \
+    $$PWD/Routing/RoutingTable.cpp \
+    $$PWD/Routing/ShortestPath.cpp \
+    $$PWD/Routing/SpfThrottle.cpp \
     $$PWD/MACAddress/MACAddress.cpp \
     $$PWD/MACAddress/MACAddressGenerator.cpp \
     $$PWD/DataGenerator/DataGenerator.cpp \
+    $$PWD/Packet/ControlMessage.cpp \
     $$PWD/Packet/Packet.cpp \
+    $$PWD/Packet/PacketPath.cpp \
+    $$PWD/Packet/PacketPool.cpp \
     $$PWD/Header/DataLinkHeader.cpp \
     $$PWD/Header/TCPHeader.cpp \
     $$PWD/NetworkSimulator/Simulator.cpp \
@@ -42,14 +63,39 @@ SOURCES += \
 HEADERS += \
     $$PWD/DHCPServer/DHCPServer.h \
     $$PWD/EventsCoordinator/EventsCoordinator.h \
+    $$PWD/EventsCoordinator/SimulationScheduler.h \
+    $$PWD/EventsCoordinator/TickExecutor.h \
+    $$PWD/EventsCoordinator/TimerService.h \
+    $$PWD/EventsCoordinator/TimingWheel.h \
     $$PWD/Globals/Globals.h \
     $$PWD/IP/IP.h \
     $$PWD/PortBindingManager/PortBindingManager.h \
     $$PWD/Port/Port.h \
+    $$PWD/Queue/ActiveQueueManager.h \
+    $$PWD/Queue/MpscRing.h \
+    $$PWD/Queue/OutputQueue.h \
+    $$PWD/Transport/BbrControl.h \
+    $$PWD/Transport/CongestionControl.h \
+    $$PWD/Transport/CubicControl.h \
+    $$PWD/Transport/TCPReceiver.h \
+    $$PWD/Transport/TCPSender.h \
+    $$PWD/Queue/SpscRing.h \
+    $$PWD/Routing/ForwardingTable.h \
+    $$PWD/Routing/DaryHeap.h \
+    $$PWD/Routing/EpochReclaimer.h \
+    $$PWD/Routing/LinkStateDatabase.h \
+    $$PWD/Routing/RcuPointer.h \
+    $$PWD/Routing/RipAdvertiser.h \
+    $$PWD/Routing/RoutingTable.h \
+    $$PWD/Routing/ShortestPath.h \
+    $$PWD/Routing/SpfThrottle.h \
     $$PWD/MACAddress/MACAddress.h \
     $$PWD/MACAddress/MACAddressGenerator.h \
     $$PWD/DataGenerator/DataGenerator.h \
+    $$PWD/Packet/ControlMessage.h \
     $$PWD/Packet/Packet.h \
+    $$PWD/Packet/PacketPath.h \
+    $$PWD/Packet/PacketPool.h \
     $$PWD/Header/DataLinkHeader.h \
     $$PWD/Header/TCPHeader.h \
     $$PWD/NetworkSimulator/Simulator.h \
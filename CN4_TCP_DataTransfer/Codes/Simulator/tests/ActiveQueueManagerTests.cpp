@@ -0,0 +1,219 @@
+#include <QtTest/QtTest>
+#include "../src/Queue/ActiveQueueManager.h"
+#include "../src/Queue/OutputQueue.h"
+
+class ActiveQueueManagerTests : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testNoneNeverDrops();
+    void testRedPassesBelowMinThreshold();
+    void testRedDropsAboveMaxThreshold();
+    void testRedDropsSomeBetweenThresholds();
+    void testRedIsReproducibleFromItsSeed();
+    void testCoDelWaitsAnIntervalBeforeDropping();
+    void testCoDelDropsFasterWhileDelayPersists();
+    void testCoDelStopsWhenSojournFalls();
+    void testOutputQueueCountsCoDelDrops();
+    void testEcnMarksPastThreshold();
+    void testEcnMarksInsteadOfRedDrop();
+    void testCoDelMarksEcnCapablePackets();
+
+private:
+    static AqmParameters red(double weight = 1.0);
+    static AqmParameters codel();
+    static PacketPtr_t packet(EcnCodepoint ecn);
+};
+
+AqmParameters ActiveQueueManagerTests::red(double weight) {
+    AqmParameters parameters;
+    parameters.type = AqmType::Red;
+    parameters.redMinThreshold = 5;
+    parameters.redMaxThreshold = 15;
+    parameters.redMaxProbability = 0.5;
+    parameters.redWeight = weight;
+    return parameters;
+}
+
+AqmParameters ActiveQueueManagerTests::codel() {
+    AqmParameters parameters;
+    parameters.type = AqmType::CoDel;
+    parameters.codelTarget = 2;
+    parameters.codelInterval = 10;
+    return parameters;
+}
+
+PacketPtr_t ActiveQueueManagerTests::packet(EcnCodepoint ecn) {
+    auto packet = PacketPtr_t::create(PacketType::Data, QByteArray("payload"));
+    packet->setEcn(ecn);
+    return packet;
+}
+
+void ActiveQueueManagerTests::testNoneNeverDrops() {
+    ActiveQueueManager aqm;
+    for (int i = 0; i < 100; ++i) {
+        QVERIFY(!aqm.shouldDropOnEnqueue(1000, i));
+        QVERIFY(!aqm.shouldDropOnDequeue(0, 1000 + i, 1000));
+    }
+}
+
+void ActiveQueueManagerTests::testRedPassesBelowMinThreshold() {
+    ActiveQueueManager aqm(red());
+    for (int i = 0; i < 100; ++i) {
+        QVERIFY(!aqm.shouldDropOnEnqueue(4, i));
+    }
+    QCOMPARE(aqm.averageQueueLength(), 4.0);
+}
+
+void ActiveQueueManagerTests::testRedDropsAboveMaxThreshold() {
+    ActiveQueueManager aqm(red());
+    QVERIFY(aqm.shouldDropOnEnqueue(20, 0));
+    QVERIFY(aqm.shouldDropOnEnqueue(15, 1));
+}
+
+void ActiveQueueManagerTests::testRedDropsSomeBetweenThresholds() {
+    ActiveQueueManager aqm(red());
+    aqm.seed(7);
+
+    int drops = 0;
+    for (int i = 0; i < 1000; ++i) {
+        if (aqm.shouldDropOnEnqueue(10, i)) ++drops;
+    }
+
+    // Base probability 0.25 at the midpoint, spread out so drops come every few arrivals.
+    QVERIFY(drops > 200);
+    QVERIFY(drops < 600);
+}
+
+void ActiveQueueManagerTests::testRedIsReproducibleFromItsSeed() {
+    // Two queues built from the same parameters drop exactly the same arrivals.
+    ActiveQueueManager first(red());
+    ActiveQueueManager second(red());
+
+    for (int i = 0; i < 1000; ++i) {
+        QCOMPARE(first.shouldDropOnEnqueue(10, i), second.shouldDropOnEnqueue(10, i));
+    }
+}
+
+void ActiveQueueManagerTests::testCoDelWaitsAnIntervalBeforeDropping() {
+    ActiveQueueManager aqm(codel());
+
+    // Sojourn 5 ticks, above the target of 2, from tick 100 on.
+    QVERIFY(!aqm.shouldDropOnDequeue(95, 100, 10));
+    QVERIFY(!aqm.shouldDropOnDequeue(100, 105, 10));
+    QVERIFY(!aqm.shouldDropOnDequeue(104, 109, 10));
+    QVERIFY(aqm.shouldDropOnDequeue(105, 110, 10));
+    QVERIFY(aqm.isDropping());
+}
+
+void ActiveQueueManagerTests::testCoDelDropsFasterWhileDelayPersists() {
+    ActiveQueueManager aqm(codel());
+
+    QList<SimTime_t> dropTimes;
+    for (SimTime_t now = 100; now < 160; ++now) {
+        if (aqm.shouldDropOnDequeue(now - 5, now, 10)) dropTimes.append(now);
+    }
+
+    QVERIFY(dropTimes.size() >= 4);
+    // Gaps follow interval / sqrt(count): 10, 7, 6, 5, ...
+    QCOMPARE(dropTimes[1] - dropTimes[0], static_cast<SimTime_t>(10));
+    QVERIFY(dropTimes[2] - dropTimes[1] < dropTimes[1] - dropTimes[0]);
+    QVERIFY(dropTimes[3] - dropTimes[2] <= dropTimes[2] - dropTimes[1]);
+}
+
+void ActiveQueueManagerTests::testCoDelStopsWhenSojournFalls() {
+    ActiveQueueManager aqm(codel());
+
+    for (SimTime_t now = 100; now <= 110; ++now) {
+        aqm.shouldDropOnDequeue(now - 5, now, 10);
+    }
+    QVERIFY(aqm.isDropping());
+
+    QVERIFY(!aqm.shouldDropOnDequeue(111, 112, 10));
+    QVERIFY(!aqm.isDropping());
+}
+
+void ActiveQueueManagerTests::testOutputQueueCountsCoDelDrops() {
+    OutputQueue queue(QueueScheduler::Fifo, 64);
+    queue.setAqm(codel());
+
+    // A standing queue: every packet waits 5 ticks, so CoDel eventually drops.
+    SimTime_t now = 0;
+    OutputQueue::Entry entry;
+    for (; now < 40; ++now) {
+        queue.enqueue(PacketPtr_t::create(PacketType::Data, QByteArray("x")), 0, 100, now);
+        queue.enqueue(PacketPtr_t::create(PacketType::Data, QByteArray("y")), 0, 100, now);
+        if (now >= 5) queue.dequeue(entry, now);
+    }
+
+    QVERIFY(queue.aqmDrops() > 0);
+    QCOMPARE(queue.tailDrops(), static_cast<quint64>(0));
+    QCOMPARE(queue.drops(), queue.aqmDrops());
+}
+
+void ActiveQueueManagerTests::testEcnMarksPastThreshold() {
+    AqmParameters parameters;
+    parameters.ecn = true;
+    parameters.ecnMarkThreshold = 2;
+
+    OutputQueue queue(QueueScheduler::Fifo, 8);
+    queue.setAqm(parameters);
+
+    QList<PacketPtr_t> sent;
+    for (int i = 0; i < 4; ++i) {
+        sent.append(packet(EcnCodepoint::Ect0));
+        QVERIFY(queue.enqueue(sent.last(), 0, 100, 0));
+    }
+    auto legacy = packet(EcnCodepoint::NotEct);
+    QVERIFY(queue.enqueue(legacy, 0, 100, 0));
+
+    QVERIFY(!sent[0]->isCongestionExperienced());
+    QVERIFY(!sent[1]->isCongestionExperienced());
+    QVERIFY(sent[2]->isCongestionExperienced());
+    QVERIFY(sent[3]->isCongestionExperienced());
+    QVERIFY(!legacy->isCongestionExperienced());
+    QCOMPARE(queue.ecnMarks(), static_cast<quint64>(2));
+    QCOMPARE(queue.drops(), static_cast<quint64>(0));
+}
+
+void ActiveQueueManagerTests::testEcnMarksInsteadOfRedDrop() {
+    AqmParameters parameters = red();
+    parameters.ecn = true;
+
+    OutputQueue queue(QueueScheduler::Fifo, 64);
+    queue.setAqm(parameters);
+    for (int i = 0; i < 20; ++i) {
+        queue.enqueue(packet(EcnCodepoint::NotEct), 0, 100, 0);
+    }
+    QVERIFY(queue.aqmDrops() > 0);
+
+    // Above the maximum threshold RED picks every arrival; ECN-capable ones are marked and kept.
+    quint64 drops = queue.aqmDrops();
+    auto capable = packet(EcnCodepoint::Ect0);
+    QVERIFY(queue.enqueue(capable, 0, 100, 0));
+    QVERIFY(capable->isCongestionExperienced());
+    QCOMPARE(queue.aqmDrops(), drops);
+    QCOMPARE(queue.ecnMarks(), static_cast<quint64>(1));
+}
+
+void ActiveQueueManagerTests::testCoDelMarksEcnCapablePackets() {
+    AqmParameters parameters = codel();
+    parameters.ecn = true;
+
+    OutputQueue queue(QueueScheduler::Fifo, 64);
+    queue.setAqm(parameters);
+
+    SimTime_t now = 0;
+    OutputQueue::Entry entry;
+    for (; now < 40; ++now) {
+        queue.enqueue(packet(EcnCodepoint::Ect0), 0, 100, now);
+        queue.enqueue(packet(EcnCodepoint::Ect0), 0, 100, now);
+        if (now >= 5) queue.dequeue(entry, now);
+    }
+
+    QVERIFY(queue.ecnMarks() > 0);
+    QCOMPARE(queue.drops(), static_cast<quint64>(0));
+}
+
+// QTEST_MAIN(ActiveQueueManagerTests)
+#include "ActiveQueueManagerTests.moc"
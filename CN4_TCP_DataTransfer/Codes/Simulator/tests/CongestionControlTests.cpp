@@ -0,0 +1,244 @@
+#include <QtTest/QtTest>
+#include "../src/Transport/BbrControl.h"
+#include "../src/Transport/CubicControl.h"
+#include "../src/Transport/TCPSender.h"
+
+class CongestionControlTests : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void init();
+    void testFromStringAndFactory();
+    void testRenoHalvesOnFastRetransmit();
+    void testRenoCutsOncePerWindowOnEcnEcho();
+    void testCubicReducesByBeta();
+    void testCubicGrowsBackTowardsLastMaximum();
+    void testCubicFastConvergence();
+    void testBbrStartupGrowsAndPaces();
+    void testBbrLeavesStartupWhenBandwidthPlateaus();
+    void testBbrProbesRttWhenMinimumExpires();
+    void testBbrRestoresWindowAfterRecovery();
+    void testSenderPacesAtBbrRate();
+
+private:
+    static AckSample ack(quint32 ackNumber, quint32 newlyAcked, SimTime_t now);
+    static void fillPipe(BbrControl &bbr, SimTime_t &now);
+};
+
+void CongestionControlTests::init() {
+    CongestionControl::setTickDuration(std::chrono::milliseconds(100));
+}
+
+AckSample CongestionControlTests::ack(quint32 ackNumber, quint32 newlyAcked, SimTime_t now) {
+    AckSample sample;
+    sample.now = now;
+    sample.ackNumber = ackNumber;
+    sample.nextSequence = ackNumber;
+    sample.newlyAcked = newlyAcked;
+    return sample;
+}
+
+void CongestionControlTests::fillPipe(BbrControl &bbr, SimTime_t &now) {
+    // One round per 10 ticks, 20 segments each time, at a steady 2 segments per tick.
+    quint64 delivered = 0;
+    for (int round = 0; round < 6; ++round) {
+        now += 10;
+        bbr.onRttSample(10, now);
+
+        AckSample sample = ack(static_cast<quint32>(delivered + 20), 20, now);
+        sample.priorDelivered = delivered;
+        delivered += 20;
+        sample.delivered = delivered;
+        sample.deliveryRate = 2.0;
+        sample.pipe = 10;
+        bbr.onAck(sample);
+    }
+}
+
+void CongestionControlTests::testFromStringAndFactory() {
+    QCOMPARE(CongestionControl::fromString("cubic"), CongestionAlgorithm::Cubic);
+    QCOMPARE(CongestionControl::fromString(" BBR "), CongestionAlgorithm::Bbr);
+    QCOMPARE(CongestionControl::fromString("newreno"), CongestionAlgorithm::Reno);
+    QCOMPARE(CongestionControl::fromString("vegas", CongestionAlgorithm::Dctcp), CongestionAlgorithm::Dctcp);
+
+    for (CongestionAlgorithm algorithm : {CongestionAlgorithm::Reno, CongestionAlgorithm::Dctcp,
+                                          CongestionAlgorithm::Cubic, CongestionAlgorithm::Bbr}) {
+        QCOMPARE(CongestionControl::create(algorithm)->algorithm(), algorithm);
+        QCOMPARE(CongestionControl::fromString(CongestionControl::toString(algorithm)), algorithm);
+    }
+}
+
+void CongestionControlTests::testRenoHalvesOnFastRetransmit() {
+    RenoControl reno;
+    reno.onLoss(LossEvent::FastRetransmit, 20, 0);
+    QCOMPARE(reno.ssthresh(), 10.0);
+    QCOMPARE(reno.window(), 10.0);
+
+    reno.onLoss(LossEvent::Timeout, 10, 1);
+    QCOMPARE(reno.ssthresh(), 5.0);
+    QCOMPARE(reno.window(), 1.0);
+}
+
+void CongestionControlTests::testRenoCutsOncePerWindowOnEcnEcho() {
+    RenoControl reno;
+    for (quint32 sequence = 2; sequence <= 16; sequence += 2) {
+        reno.onAck(ack(sequence, 2, 0));
+    }
+    double before = reno.window();
+
+    // Every ACK of the next window echoes ECE; only the first one counts.
+    for (quint32 sequence = 17; sequence <= 20; ++sequence) {
+        AckSample sample = ack(sequence, 1, 1);
+        sample.nextSequence = 40;
+        sample.ecnEcho = true;
+        reno.onAck(sample);
+    }
+
+    QCOMPARE(reno.ecnReductions(), quint64(1));
+    QVERIFY(reno.window() < before / 2 + 1);
+}
+
+void CongestionControlTests::testCubicReducesByBeta() {
+    CubicControl cubic;
+    for (quint32 sequence = 2; sequence <= 16; sequence += 2) {
+        cubic.onAck(ack(sequence, 2, 0));
+    }
+    QCOMPARE(cubic.window(), 20.0);
+
+    cubic.onLoss(LossEvent::FastRetransmit, 20, 0);
+    QCOMPARE(cubic.windowMax(), 20.0);
+    QCOMPARE(cubic.window(), 20.0 * CubicControl::BETA);
+    QCOMPARE(cubic.ssthresh(), cubic.window());
+}
+
+void CongestionControlTests::testCubicGrowsBackTowardsLastMaximum() {
+    CubicControl cubic;
+    for (quint32 sequence = 2; sequence <= 16; sequence += 2) {
+        cubic.onAck(ack(sequence, 2, 0));
+    }
+    cubic.onLoss(LossEvent::FastRetransmit, 20, 0);
+
+    // A window acknowledged every second (10 ticks): quick recovery at first, a plateau around the
+    // old maximum near K = cbrt(6 / C) ~ 2.5 s, then probing beyond it.
+    quint32 acked = 16;
+    QList<double> windows;
+    for (SimTime_t now = 0; now <= 60; now += 10) {
+        quint32 window = static_cast<quint32>(cubic.window());
+        acked += window;
+        cubic.onAck(ack(acked, window, now));
+        windows.append(cubic.window());
+    }
+
+    QVERIFY(windows[1] > 18 && windows[1] < 20);
+    QVERIFY(qAbs(windows[3] - 20) < 0.5);
+    QVERIFY(windows[6] > 22);
+}
+
+void CongestionControlTests::testCubicFastConvergence() {
+    CubicControl cubic;
+    for (quint32 sequence = 2; sequence <= 16; sequence += 2) {
+        cubic.onAck(ack(sequence, 2, 0));
+    }
+    cubic.onLoss(LossEvent::FastRetransmit, 20, 0);
+
+    // Losing again below the previous maximum gives some of the share away.
+    cubic.onLoss(LossEvent::FastRetransmit, 14, 1);
+    QCOMPARE(cubic.windowMax(), 14.0 * (1 + CubicControl::BETA) / 2);
+}
+
+void CongestionControlTests::testBbrStartupGrowsAndPaces() {
+    BbrControl bbr;
+    QCOMPARE(bbr.pacingRate(), 0.0);
+    QCOMPARE(bbr.mode(), BbrControl::Mode::Startup);
+
+    AckSample sample = ack(4, 4, 4);
+    sample.delivered = 4;
+    sample.deliveryRate = 1.0;
+    bbr.onAck(sample);
+
+    QCOMPARE(bbr.bottleneckBandwidth(), 1.0);
+    QCOMPARE(bbr.pacingRate(), BbrControl::HIGH_GAIN);
+    QCOMPARE(bbr.window(), 8.0);
+}
+
+void CongestionControlTests::testBbrLeavesStartupWhenBandwidthPlateaus() {
+    BbrControl bbr;
+    SimTime_t now = 0;
+    fillPipe(bbr, now);
+
+    QVERIFY(bbr.filledPipe());
+    QCOMPARE(bbr.mode(), BbrControl::Mode::ProbeBw);
+    QCOMPARE(bbr.minRtt(), SimTime_t(10));
+    QCOMPARE(bbr.bdp(), 20.0);
+    QCOMPARE(bbr.pacingRate(), bbr.bottleneckBandwidth());
+    QVERIFY(bbr.window() <= BbrControl::CWND_GAIN * bbr.bdp());
+}
+
+void CongestionControlTests::testBbrProbesRttWhenMinimumExpires() {
+    BbrControl bbr;
+    SimTime_t now = 0;
+    fillPipe(bbr, now);
+    double before = bbr.window();
+
+    // Ten seconds (100 ticks) without a lower RTT: drain to four segments for 200 ms.
+    now += 101;
+    bbr.onRttSample(12, now);
+    AckSample sample = ack(200, 1, now);
+    sample.priorDelivered = 120;
+    sample.delivered = 121;
+    sample.pipe = 3;
+    bbr.onAck(sample);
+    QCOMPARE(bbr.mode(), BbrControl::Mode::ProbeRtt);
+    QCOMPARE(bbr.window(), double(BbrControl::MIN_WINDOW));
+
+    sample.now = now + 2;
+    sample.delivered = 122;
+    bbr.onAck(sample);
+    QCOMPARE(bbr.mode(), BbrControl::Mode::ProbeBw);
+    QVERIFY(bbr.window() >= before);
+}
+
+void CongestionControlTests::testBbrRestoresWindowAfterRecovery() {
+    BbrControl bbr;
+    SimTime_t now = 0;
+    fillPipe(bbr, now);
+    double before = bbr.window();
+    double pacing = bbr.pacingRate();
+
+    bbr.onLoss(LossEvent::FastRetransmit, 10, now);
+    QCOMPARE(bbr.window(), 11.0);
+    QCOMPARE(bbr.pacingRate(), pacing);
+
+    bbr.onRecoveryEnd(5, now + 10);
+    QCOMPARE(bbr.window(), before);
+
+    bbr.onLoss(LossEvent::Timeout, 10, now + 20);
+    QCOMPARE(bbr.window(), 1.0);
+}
+
+void CongestionControlTests::testSenderPacesAtBbrRate() {
+    TCPSender sender;
+    sender.setCongestionControl(CongestionAlgorithm::Bbr);
+    sender.onTick(0);
+    while (sender.canSendNew()) {
+        sender.onSent(QByteArray("data"), 0);
+    }
+    QCOMPARE(sender.outstanding(), TCPSender::INITIAL_WINDOW);
+
+    // Four segments in four ticks: one per tick, paced at 2.885 per tick in startup.
+    sender.onAck(4, false, 4);
+    QCOMPARE(sender.congestionControl().pacingRate(), BbrControl::HIGH_GAIN);
+    QVERIFY(!sender.canSendNew());
+
+    sender.onTick(5);
+    int sent = 0;
+    while (sender.canSendNew()) {
+        sender.onSent(QByteArray("data"), 5);
+        ++sent;
+    }
+    QCOMPARE(sent, 2);
+    QVERIFY(sender.window() > sender.outstanding());
+}
+
+// QTEST_MAIN(CongestionControlTests)
+#include "CongestionControlTests.moc"
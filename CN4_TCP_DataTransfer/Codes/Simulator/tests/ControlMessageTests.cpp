@@ -0,0 +1,84 @@
+#include <QtTest/QtTest>
+#include "../src/Packet/ControlMessage.h"
+
+class ControlMessageTests : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testRouteUpdateRoundTrip();
+    void testAddressFlagsRoundTrip();
+    void testMaskConversion();
+    void testRejectsTruncatedMessages();
+    void testWithRecordMetricCopies();
+};
+
+void ControlMessageTests::testRouteUpdateRoundTrip() {
+    ControlMessageWriter writer(UT::PacketControlType::RIP,
+                                ControlAddress::fromString("192.168.100.7"), 42, 2);
+    writer.addRoute("192.168.100.1", "255.255.255.255", 3);
+    writer.addRoute("192.168.200.9", "255.255.255.0", 300);
+    QCOMPARE(writer.recordCount(), 2);
+
+    QByteArray bytes = writer.finish();
+    QCOMPARE(bytes.size(), 12 + 2 * 8);
+
+    ControlMessageReader reader(bytes);
+    QVERIFY(reader.isValid());
+    QCOMPARE(reader.type(), UT::PacketControlType::RIP);
+    QCOMPARE(reader.originAddress(), QString("192.168.100.7"));
+    QCOMPARE(reader.sequence(), static_cast<quint32>(42));
+    QCOMPARE(reader.recordCount(), 2);
+
+    QCOMPARE(reader.recordAddress(0), QString("192.168.100.1"));
+    QCOMPARE(reader.record(0).prefixLength, static_cast<quint8>(32));
+    QCOMPARE(reader.record(0).metric, static_cast<quint8>(3));
+
+    QCOMPARE(reader.recordAddress(1), QString("192.168.200.9"));
+    QCOMPARE(reader.record(1).prefixLength, static_cast<quint8>(24));
+    QCOMPARE(reader.record(1).metric, static_cast<quint8>(255));
+}
+
+void ControlMessageTests::testAddressFlagsRoundTrip() {
+    quint16 flags = 0;
+
+    quint32 wildcard = ControlAddress::fromString("192.168.200.xx", &flags);
+    QCOMPARE(flags, ControlRecord::FLAG_WILDCARD_HOST);
+    QCOMPARE(ControlAddress::toString(wildcard, flags), QString("192.168.200.xx"));
+
+    quint32 mapped = ControlAddress::fromString("::ffff:10.0.0.5", &flags);
+    QCOMPARE(flags, ControlRecord::FLAG_IPV4_MAPPED_IPV6);
+    QCOMPARE(mapped, static_cast<quint32>(0x0A000005));
+    QCOMPARE(ControlAddress::toString(mapped, flags), QString("::ffff:10.0.0.5"));
+}
+
+void ControlMessageTests::testMaskConversion() {
+    QCOMPARE(ControlAddress::maskToPrefixLength("255.255.255.255"), static_cast<quint8>(32));
+    QCOMPARE(ControlAddress::maskToPrefixLength("255.255.240.0"), static_cast<quint8>(20));
+    QCOMPARE(ControlAddress::prefixLengthToMask(20), QString("255.255.240.0"));
+    QCOMPARE(ControlAddress::prefixLengthToMask(0), QString("0.0.0.0"));
+}
+
+void ControlMessageTests::testRejectsTruncatedMessages() {
+    ControlMessageWriter writer(UT::PacketControlType::OSPFLSA, 1, 7);
+    writer.addAddress("10.0.0.1");
+    QByteArray bytes = writer.finish();
+
+    QVERIFY(!ControlMessageReader(bytes.left(bytes.size() - 1)).isValid());
+    QVERIFY(!ControlMessageReader(QByteArray("RIP_UPDATE:1.2.3.4")).isValid());
+    QCOMPARE(ControlMessageReader(QByteArray()).recordCount(), 0);
+}
+
+void ControlMessageTests::testWithRecordMetricCopies() {
+    ControlMessageWriter writer(UT::PacketControlType::RIP, 1);
+    writer.addRoute("10.0.0.1", "255.255.255.255", 2);
+    writer.addRoute("10.0.0.2", "255.255.255.255", 3);
+    QByteArray original = writer.finish();
+
+    QByteArray patched = ControlMessageWriter::withRecordMetric(original, {1, 7}, 16);
+    QCOMPARE(ControlMessageReader(patched).record(0).metric, static_cast<quint8>(2));
+    QCOMPARE(ControlMessageReader(patched).record(1).metric, static_cast<quint8>(16));
+    QCOMPARE(ControlMessageReader(original).record(1).metric, static_cast<quint8>(3));
+}
+
+// QTEST_MAIN(ControlMessageTests)
+#include "ControlMessageTests.moc"
@@ -0,0 +1,93 @@
+#include <QtTest/QtTest>
+#include <random>
+#include "../src/Routing/ForwardingTable.h"
+
+namespace {
+quint32 address(int a, int b, int c, int d) {
+    return (quint32(a) << 24) | (quint32(b) << 16) | (quint32(c) << 8) | quint32(d);
+}
+}
+
+class ForwardingTableTests : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testEmptyTable();
+    void testLongestPrefixWins();
+    void testShorterPrefixInsertedLater();
+    void testDefaultRoute();
+    void testBuildMatchesLinearScan();
+};
+
+void ForwardingTableTests::testEmptyTable() {
+    ForwardingTable table;
+    QCOMPARE(table.lookup(address(192, 168, 1, 1)), ForwardingTable::NO_ROUTE);
+    QCOMPARE(table.nodeCount(), 1);
+}
+
+void ForwardingTableTests::testLongestPrefixWins() {
+    ForwardingTable table;
+    table.insert(address(192, 168, 200, 0), 24, 1);
+    table.insert(address(192, 168, 200, 7), 32, 2);
+    table.insert(address(10, 0, 0, 0), 12, 3);
+
+    QCOMPARE(table.lookup(address(192, 168, 200, 7)), static_cast<quint32>(2));
+    QCOMPARE(table.lookup(address(192, 168, 200, 8)), static_cast<quint32>(1));
+    QCOMPARE(table.lookup(address(192, 168, 201, 7)), ForwardingTable::NO_ROUTE);
+    QCOMPARE(table.lookup(address(10, 15, 255, 255)), static_cast<quint32>(3));
+    QCOMPARE(table.lookup(address(10, 16, 0, 0)), ForwardingTable::NO_ROUTE);
+}
+
+void ForwardingTableTests::testShorterPrefixInsertedLater() {
+    ForwardingTable table;
+    table.insert(address(192, 168, 100, 5), 32, 1);
+    table.insert(address(192, 168, 100, 0), 24, 2);
+    table.insert(address(192, 168, 100, 5), 32, 3);
+
+    QCOMPARE(table.lookup(address(192, 168, 100, 5)), static_cast<quint32>(3));
+    QCOMPARE(table.lookup(address(192, 168, 100, 6)), static_cast<quint32>(2));
+}
+
+void ForwardingTableTests::testDefaultRoute() {
+    ForwardingTable table;
+    table.insert(0, 0, 9);
+    table.insert(address(172, 16, 0, 0), 16, 4);
+
+    QCOMPARE(table.lookup(address(8, 8, 8, 8)), static_cast<quint32>(9));
+    QCOMPARE(table.lookup(address(172, 16, 3, 4)), static_cast<quint32>(4));
+    QCOMPARE(table.lookup(address(172, 17, 3, 4)), static_cast<quint32>(9));
+}
+
+void ForwardingTableTests::testBuildMatchesLinearScan() {
+    std::mt19937 random(7);
+    std::vector<ForwardingTable::Prefix> prefixes;
+    for (quint32 i = 0; i < 500; ++i) {
+        quint8 length = static_cast<quint8>(8 + random() % 25);
+        quint32 prefix = address(192, 168, 0, 0) | (random() & 0xFFFF);
+        if (length < 32) prefix &= ~(0xFFFFFFFFu >> length);
+        prefixes.push_back({prefix, length, i});
+    }
+
+    ForwardingTable table;
+    table.build(prefixes);
+
+    for (int i = 0; i < 2000; ++i) {
+        quint32 target = address(192, 168, 0, 0) | (random() & 0xFFFF);
+
+        quint32 expected = ForwardingTable::NO_ROUTE;
+        int expectedLength = -1;
+        for (const auto &p : prefixes) {
+            quint32 mask = p.length == 0 ? 0 : ~(0xFFFFFFFFu >> p.length);
+            if (p.length == 32) mask = 0xFFFFFFFFu;
+            if ((target & mask) == p.prefix && p.length >= expectedLength) {
+                expected = p.value;
+                expectedLength = p.length;
+            }
+        }
+
+        QCOMPARE(table.lookup(target), expected);
+    }
+}
+
+// QTEST_MAIN(ForwardingTableTests)
+#include "ForwardingTableTests.moc"
@@ -0,0 +1,124 @@
+#include <QtTest/QtTest>
+#include "../src/Routing/LinkStateDatabase.h"
+
+class LinkStateDatabaseTests : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void init();
+    void cleanup();
+    void testRouterIdsAreDense();
+    void testIdenticalLsasAreShared();
+    void testLastReleaseFreesVersion();
+    void testGraphFollowsView();
+    void testEqualViewsShareGraph();
+    void testDivergentViewsKeepTheirGraphs();
+};
+
+void LinkStateDatabaseTests::init() {
+    LinkStateDatabase::instance().clear();
+}
+
+void LinkStateDatabaseTests::cleanup() {
+    LinkStateDatabase::instance().clear();
+}
+
+void LinkStateDatabaseTests::testRouterIdsAreDense() {
+    LinkStateDatabase &lsdb = LinkStateDatabase::instance();
+
+    QCOMPARE(lsdb.routerId(0x0A000005), 0);
+    QCOMPARE(lsdb.routerId(0x0A000001), 1);
+    QCOMPARE(lsdb.routerId(0x0A000005), 0);
+    QCOMPARE(lsdb.findRouterId(0x0A000009), -1);
+    QCOMPARE(lsdb.routerAddress(1), static_cast<quint32>(0x0A000001));
+    QCOMPARE(lsdb.routerCount(), 2);
+}
+
+void LinkStateDatabaseTests::testIdenticalLsasAreShared() {
+    LinkStateDatabase &lsdb = LinkStateDatabase::instance();
+
+    // A hundred routers learning the same LSA store it once.
+    for (int router = 0; router < 100; ++router) {
+        lsdb.acquire(1, 7, {2, 3, 4});
+    }
+
+    QCOMPARE(lsdb.lsaCount(), 1);
+    QCOMPARE(lsdb.linkCount(), 3);
+
+    lsdb.acquire(1, 8, {2});
+    QCOMPARE(lsdb.lsaCount(), 2);
+    QCOMPARE(lsdb.linkCount(), 4);
+}
+
+void LinkStateDatabaseTests::testLastReleaseFreesVersion() {
+    LinkStateDatabase &lsdb = LinkStateDatabase::instance();
+    int origin = lsdb.acquire(1, 3, {2});
+    lsdb.acquire(1, 3, {2});
+
+    lsdb.release(origin, 3);
+    QCOMPARE(lsdb.lsaCount(), 1);
+    lsdb.release(origin, 3);
+    QCOMPARE(lsdb.lsaCount(), 0);
+    QCOMPARE(lsdb.linkCount(), 0);
+}
+
+void LinkStateDatabaseTests::testGraphFollowsView() {
+    LinkStateDatabase &lsdb = LinkStateDatabase::instance();
+    int a = lsdb.acquire(1, 1, {2, 3});
+    int b = lsdb.acquire(2, 1, {1});
+    int c = lsdb.routerId(3);
+
+    std::vector<quint32> view(lsdb.routerCount(), 0);
+    view[a] = 1;
+    view[b] = 1;
+
+    // 3 has no LSA in the view, so the link towards it is left out.
+    auto graph = lsdb.graph(view);
+    QCOMPARE(graph->nodeCount(), 3);
+    QCOMPARE(graph->arcCount(), 2);
+    QCOMPARE(graph->arcWeight(a, b), 1);
+    QCOMPARE(graph->arcWeight(a, c), -1);
+}
+
+void LinkStateDatabaseTests::testEqualViewsShareGraph() {
+    LinkStateDatabase &lsdb = LinkStateDatabase::instance();
+    int a = lsdb.acquire(1, 1, {2});
+    int b = lsdb.acquire(2, 1, {1});
+    lsdb.acquire(2, 2, {});
+
+    std::vector<quint32> view(lsdb.routerCount(), 0);
+    view[a] = 1;
+    view[b] = 1;
+
+    auto first = lsdb.graph(view);
+    QVERIFY(lsdb.graph(view) == first);
+
+    // Moving the view on builds a new graph; the old one stays intact for whoever holds it.
+    view[b] = 2;
+    auto second = lsdb.graph(view);
+    QVERIFY(second != first);
+    QCOMPARE(first->arcCount(), 2);
+    QCOMPARE(second->arcCount(), 1);
+}
+
+void LinkStateDatabaseTests::testDivergentViewsKeepTheirGraphs() {
+    LinkStateDatabase &lsdb = LinkStateDatabase::instance();
+    int a = lsdb.acquire(1, 1, {2});
+    int b = lsdb.acquire(2, 1, {1});
+    lsdb.acquire(2, 2, {});
+
+    std::vector<quint32> oldView(lsdb.routerCount(), 0);
+    oldView[a] = 1;
+    oldView[b] = 1;
+    std::vector<quint32> newView = oldView;
+    newView[b] = 2;
+
+    // While routers disagree, each view keeps its own graph instead of rebuilding on every SPF.
+    auto oldGraph = lsdb.graph(oldView);
+    auto newGraph = lsdb.graph(newView);
+    QVERIFY(lsdb.graph(oldView) == oldGraph);
+    QVERIFY(lsdb.graph(newView) == newGraph);
+}
+
+// QTEST_MAIN(LinkStateDatabaseTests)
+#include "LinkStateDatabaseTests.moc"
@@ -0,0 +1,131 @@
+#include <QtTest/QtTest>
+#include <QList>
+#include <thread>
+#include <vector>
+#include "../src/Queue/MpscRing.h"
+
+class MpscRingTests : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testCapacityIsExact();
+    void testPushFailsWhenFullAndCountsDrop();
+    void testPushEvictingDropsOldest();
+    void testPeekDoesNotConsume();
+    void testHighWatermark();
+    void testProducersKeepPerProducerOrder();
+};
+
+void MpscRingTests::testCapacityIsExact() {
+    MpscRing<int> ring(6);
+    QCOMPARE(ring.capacity(), static_cast<size_t>(6));
+
+    for (int i = 0; i < 6; ++i) {
+        QVERIFY(ring.tryPush(i));
+    }
+    QVERIFY(!ring.tryPush(6));
+}
+
+void MpscRingTests::testPushFailsWhenFullAndCountsDrop() {
+    MpscRing<int> ring(2);
+
+    QVERIFY(ring.tryPush(1));
+    QVERIFY(ring.tryPush(2));
+    QVERIFY(!ring.tryPush(3));
+    QCOMPARE(ring.drops(), static_cast<uint64_t>(1));
+    QCOMPARE(ring.size(), static_cast<size_t>(2));
+
+    int value = 0;
+    QVERIFY(ring.tryPop(value));
+    QCOMPARE(value, 1);
+    QVERIFY(ring.tryPush(3));
+}
+
+void MpscRingTests::testPushEvictingDropsOldest() {
+    MpscRing<int> ring(3);
+    for (int i = 1; i <= 3; ++i) {
+        ring.tryPush(i);
+    }
+
+    QList<int> evicted;
+    QCOMPARE(ring.pushEvicting(4, [&](int v) { evicted.append(v); }), static_cast<size_t>(1));
+    QCOMPARE(evicted, QList<int>({1}));
+    QCOMPARE(ring.drops(), static_cast<uint64_t>(1));
+
+    QList<int> remaining;
+    int value = 0;
+    while (ring.tryPop(value)) {
+        remaining.append(value);
+    }
+    QCOMPARE(remaining, QList<int>({2, 3, 4}));
+}
+
+void MpscRingTests::testPeekDoesNotConsume() {
+    MpscRing<int> ring(4);
+    QVERIFY(ring.peek() == nullptr);
+
+    ring.tryPush(7);
+    QVERIFY(ring.peek() != nullptr);
+    QCOMPARE(*ring.peek(), 7);
+    QCOMPARE(ring.size(), static_cast<size_t>(1));
+
+    int value = 0;
+    QVERIFY(ring.tryPop(value));
+    QVERIFY(ring.peek() == nullptr);
+    QVERIFY(ring.isEmpty());
+}
+
+void MpscRingTests::testHighWatermark() {
+    MpscRing<int> ring(8);
+    int value = 0;
+
+    for (int i = 0; i < 5; ++i) {
+        ring.tryPush(i);
+    }
+    while (ring.tryPop(value)) {
+    }
+    ring.tryPush(1);
+
+    QCOMPARE(ring.highWatermark(), static_cast<size_t>(5));
+    QCOMPARE(ring.size(), static_cast<size_t>(1));
+}
+
+void MpscRingTests::testProducersKeepPerProducerOrder() {
+    MpscRing<int> ring(64);
+    const int producers = 4;
+    const int perProducer = 20000;
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&ring, p, perProducer]() {
+            for (int i = 0; i < perProducer; ++i) {
+                while (!ring.tryPush(p * perProducer + i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<int> next(producers, 0);
+    bool inOrder = true;
+    int received = 0;
+    int value = 0;
+    while (received < producers * perProducer) {
+        if (!ring.tryPop(value)) continue;
+
+        int producer = value / perProducer;
+        inOrder = inOrder && (value % perProducer == next[producer]);
+        ++next[producer];
+        ++received;
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    QVERIFY(inOrder);
+    QCOMPARE(received, producers * perProducer);
+    QVERIFY(ring.highWatermark() <= ring.capacity());
+}
+
+// QTEST_MAIN(MpscRingTests)
+#include "MpscRingTests.moc"
@@ -0,0 +1,130 @@
+#include <QtTest/QtTest>
+#include <QList>
+#include "../src/Queue/OutputQueue.h"
+
+class OutputQueueTests : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testFifoKeepsArrivalOrder();
+    void testFullQueueDropsArrival();
+    void testStrictPriorityServesHighestClassFirst();
+    void testDeficitRoundRobinAlternatesClasses();
+    void testDeficitRoundRobinHonoursWeights();
+    void testWeightedFairSharesByWeight();
+    void testDequeueReportsEnqueueTime();
+
+private:
+    static PacketPtr_t packetWithSequence(int sequence);
+    static QList<int> drain(OutputQueue &queue, int count);
+};
+
+PacketPtr_t OutputQueueTests::packetWithSequence(int sequence) {
+    auto packet = PacketPtr_t::create(PacketType::Data, QByteArray("payload"));
+    packet->setSequenceNumber(sequence);
+    return packet;
+}
+
+QList<int> OutputQueueTests::drain(OutputQueue &queue, int count) {
+    QList<int> order;
+    OutputQueue::Entry entry;
+    while (order.size() < count && queue.dequeue(entry)) {
+        order.append(entry.packet->getSequenceNumber());
+    }
+    return order;
+}
+
+void OutputQueueTests::testFifoKeepsArrivalOrder() {
+    OutputQueue queue(QueueScheduler::Fifo, 8);
+
+    // FIFO ignores the class.
+    queue.enqueue(packetWithSequence(1), 0, 100, 0);
+    queue.enqueue(packetWithSequence(2), 7, 100, 0);
+    queue.enqueue(packetWithSequence(3), 3, 100, 0);
+
+    QCOMPARE(drain(queue, 3), QList<int>({1, 2, 3}));
+    QVERIFY(queue.isEmpty());
+}
+
+void OutputQueueTests::testFullQueueDropsArrival() {
+    OutputQueue queue(QueueScheduler::StrictPriority, 2);
+
+    QVERIFY(queue.enqueue(packetWithSequence(1), 0, 100, 0));
+    QVERIFY(queue.enqueue(packetWithSequence(2), 1, 100, 0));
+    QVERIFY(!queue.enqueue(packetWithSequence(3), 7, 100, 0));
+
+    QCOMPARE(queue.size(), 2);
+    QCOMPARE(queue.drops(), static_cast<quint64>(1));
+    QCOMPARE(queue.highWatermark(), 2);
+}
+
+void OutputQueueTests::testStrictPriorityServesHighestClassFirst() {
+    OutputQueue queue(QueueScheduler::StrictPriority, 8);
+
+    queue.enqueue(packetWithSequence(1), 0, 100, 0);
+    queue.enqueue(packetWithSequence(2), 5, 100, 0);
+    queue.enqueue(packetWithSequence(3), 0, 100, 0);
+    queue.enqueue(packetWithSequence(4), 5, 100, 0);
+    queue.enqueue(packetWithSequence(5), 2, 100, 0);
+
+    QCOMPARE(drain(queue, 5), QList<int>({2, 4, 5, 1, 3}));
+}
+
+void OutputQueueTests::testDeficitRoundRobinAlternatesClasses() {
+    OutputQueue queue(QueueScheduler::DeficitRoundRobin, 16);
+
+    // Each class's quantum covers exactly one of these packets.
+    for (int i = 0; i < 3; ++i) {
+        queue.enqueue(packetWithSequence(10 + i), 0, OutputQueue::QUANTUM_BYTES, 0);
+    }
+    for (int i = 0; i < 3; ++i) {
+        queue.enqueue(packetWithSequence(20 + i), 1, OutputQueue::QUANTUM_BYTES, 0);
+    }
+
+    QCOMPARE(drain(queue, 6), QList<int>({10, 20, 11, 21, 12, 22}));
+}
+
+void OutputQueueTests::testDeficitRoundRobinHonoursWeights() {
+    OutputQueue queue(QueueScheduler::DeficitRoundRobin, 32);
+    std::array<int, OutputQueue::CLASS_COUNT> weights {1, 3, 1, 1, 1, 1, 1, 1};
+    queue.setWeights(weights);
+
+    for (int i = 0; i < 8; ++i) {
+        queue.enqueue(packetWithSequence(0), 0, OutputQueue::QUANTUM_BYTES, 0);
+        queue.enqueue(packetWithSequence(1), 1, OutputQueue::QUANTUM_BYTES, 0);
+    }
+
+    QList<int> classes = drain(queue, 8);
+    QCOMPARE(classes.count(1), 6);
+    QCOMPARE(classes.count(0), 2);
+}
+
+void OutputQueueTests::testWeightedFairSharesByWeight() {
+    OutputQueue queue(QueueScheduler::WeightedFair, 64);
+    std::array<int, OutputQueue::CLASS_COUNT> weights {1, 1, 1, 1, 1, 1, 1, 1};
+    weights[4] = 2;
+    queue.setWeights(weights);
+
+    for (int i = 0; i < 20; ++i) {
+        queue.enqueue(packetWithSequence(0), 0, 1000, 0);
+        queue.enqueue(packetWithSequence(4), 4, 1000, 0);
+    }
+
+    QList<int> classes = drain(queue, 12);
+    QCOMPARE(classes.count(4), 8);
+    QCOMPARE(classes.count(0), 4);
+}
+
+void OutputQueueTests::testDequeueReportsEnqueueTime() {
+    OutputQueue queue;
+    queue.enqueue(packetWithSequence(1), 0, 100, 42);
+
+    OutputQueue::Entry entry;
+    QVERIFY(queue.dequeue(entry));
+    QCOMPARE(entry.enqueueTime, static_cast<SimTime_t>(42));
+    QCOMPARE(entry.bytes, 100);
+    QVERIFY(!queue.dequeue(entry));
+}
+
+// QTEST_MAIN(OutputQueueTests)
+#include "OutputQueueTests.moc"
@@ -1,5 +1,6 @@
 #include <QtTest/QtTest>
 #include "../src/Packet/Packet.h"
+#include "../src/Packet/PacketPool.h"
 #include "../src/Header/DataLinkHeader.h"
 #include "../src/Header/TCPHeader.h"
 
@@ -15,8 +16,13 @@ private Q_SLOTS:
     void testQueueWaitCyclesManagement();
     void testSequenceNumber();
     void testDroppedFlag();
+    void testEcnMarking();
     void testDataLinkHeaderIntegration();
     void testTCPHeaderIntegration();
+    void testPoolRecyclesReleasedPackets();
+    void testPathTakenString();
+    void testPathRecordingModes();
+    void testControlTypeTravelsWithPacket();
 };
 
 void PacketTests::testDefaultConstructor() {
@@ -81,6 +87,18 @@ void PacketTests::testDroppedFlag() {
     QCOMPARE(packet.isDropped(), false);
 }
 
+void PacketTests::testEcnMarking() {
+    Packet packet;
+    QVERIFY(!packet.isEcnCapable());
+    QVERIFY(!packet.markCongestionExperienced());
+    QCOMPARE(packet.ecn(), EcnCodepoint::NotEct);
+
+    packet.setEcn(EcnCodepoint::Ect0);
+    QVERIFY(packet.markCongestionExperienced());
+    QVERIFY(packet.isCongestionExperienced());
+    QVERIFY(packet.isEcnCapable());
+}
+
 void PacketTests::testDataLinkHeaderIntegration() {
     Packet packet;
     DataLinkHeader header(MACAddress("12:34:56:78:9A:BC"), MACAddress("AB:CD:EF:01:23:45"), "0x0806", "FFFF");
@@ -110,5 +128,81 @@ void PacketTests::testTCPHeaderIntegration() {
     QCOMPARE(retrievedHeader.getUrgentPointer(), static_cast<uint16_t>(123));
 }
 
+void PacketTests::testPoolRecyclesReleasedPackets() {
+    PacketPool::resetCounters();
+
+    auto first = PacketPool::acquire(PacketType::Data, "First", 5);
+    first->addToPath("192.168.1.1");
+    first->setSequenceNumber(7);
+    Packet *slot = first.data();
+    qint64 firstId = first->getId();
+    first.reset();
+
+    auto second = PacketPool::acquire(PacketType::Control, "Second");
+    QCOMPARE(second.data(), slot);
+    QCOMPARE(second->getType(), PacketType::Control);
+    QCOMPARE(second->getPayload(), QByteArray("Second"));
+    QCOMPARE(second->getTTL(), Packet::DEFAULT_TTL);
+    QCOMPARE(second->getSequenceNumber(), 0);
+    QVERIFY(second->getPath().isEmpty());
+    QVERIFY(second->getId() != firstId);
+
+    auto copy = PacketPool::acquire(*second);
+    QCOMPARE(copy->getPayload(), second->getPayload());
+
+    QCOMPARE(PacketPool::hits(), static_cast<quint64>(1));
+    QCOMPARE(PacketPool::misses(), static_cast<quint64>(2));
+}
+
+void PacketTests::testPathTakenString() {
+    Packet packet;
+    packet.addToPathTaken("192.168.1.1");
+    packet.addToPathTaken(PacketPath::indexOf("192.168.1.2"));
+
+    QCOMPARE(packet.getPathTaken(), QString("-->192.168.1.1-->192.168.1.2"));
+    QCOMPARE(packet.path().size(), 0);
+}
+
+void PacketTests::testPathRecordingModes() {
+    PacketPath::setRecording(PathRecording::Off);
+    Packet unrecorded;
+    unrecorded.addToPath("192.168.1.1");
+    QVERIFY(unrecorded.getPath().isEmpty());
+
+    PacketPath::setRecording(PathRecording::Sampled, 2);
+    int recorded = 0;
+    for (int i = 0; i < 10; ++i) {
+        Packet packet;
+        packet.addToPath("192.168.1.1");
+        recorded += packet.path().size();
+    }
+    QCOMPARE(recorded, 5);
+
+    PacketPath::setRecording(PathRecording::Full);
+    Packet full;
+    for (int i = 0; i < PacketPath::MAX_HOPS + 3; ++i) {
+        full.addToPath(static_cast<quint16>(i));
+    }
+    QCOMPARE(full.path().size(), PacketPath::MAX_HOPS);
+    QVERIFY(full.path().isTruncated());
+}
+
+void PacketTests::testControlTypeTravelsWithPacket() {
+    Packet data;
+    QCOMPARE(data.controlType(), UT::PacketControlType::None);
+
+    auto hello = PacketPool::acquire(UT::PacketControlType::OSPF, PacketType::OSPFHello, "", 3);
+    QCOMPARE(hello->controlType(), UT::PacketControlType::OSPF);
+    QCOMPARE(hello->getTTL(), 3);
+
+    auto copy = PacketPool::acquire(*hello);
+    QCOMPARE(copy->controlType(), UT::PacketControlType::OSPF);
+
+    hello.reset();
+    copy.reset();
+    auto recycled = PacketPool::acquire(PacketType::Data, "Data");
+    QCOMPARE(recycled->controlType(), UT::PacketControlType::None);
+}
+
 // QTEST_MAIN(PacketTests)
 #include "PacketTests.moc"
@@ -9,6 +9,8 @@ private Q_SLOTS:
     void testSetAndGetRouterIP();
     void testConnectionState();
     void testPacketTransmission();
+    void testBurstTransmission();
+    void testServiceOutputLeavesControlReserve();
 };
 
 void PortTests::testSetAndGetPortNumber() {
@@ -46,5 +48,53 @@ void PortTests::testPacketTransmission() {
     QCOMPARE(spy2.count(), 1);
 }
 
+void PortTests::testBurstTransmission() {
+    Port port1, port2;
+
+    auto forward  = PacketRingPtr_t::create(4);
+    auto backward = PacketRingPtr_t::create(4);
+    port1.attachLink(forward, backward);
+    port2.attachLink(backward, forward);
+
+    QList<PacketPtr_t> burst;
+    for (int i = 0; i < 6; ++i) {
+        burst.append(QSharedPointer<Packet>::create(PacketType::Data, QByteArray::number(i)));
+    }
+
+    QCOMPARE(port1.sendPackets(burst), 4);
+    QCOMPARE(port1.getNumberOfPacketsSent(), static_cast<uint64_t>(4));
+    QCOMPARE(port1.getNumberOfPacketsBlocked(), static_cast<uint64_t>(2));
+    QVERIFY(!port1.canSend());
+
+    QCOMPARE(port1.flush(), static_cast<quint64>(4));
+
+    QList<QList<PacketPtr_t>> received;
+    QCOMPARE(port2.drainIngress([&](const QList<PacketPtr_t> &packets) { received.append(packets); }),
+             static_cast<quint64>(4));
+    QCOMPARE(received.size(), 1);
+    QCOMPARE(received.first(), burst.first(4));
+    QCOMPARE(port2.getNumberOfPacketsReceived(), static_cast<uint64_t>(4));
+}
+
+void PortTests::testServiceOutputLeavesControlReserve() {
+    Port port1, port2;
+
+    auto forward  = PacketRingPtr_t::create(16);
+    auto backward = PacketRingPtr_t::create(16);
+    port1.attachLink(forward, backward);
+    port2.attachLink(backward, forward);
+    port1.setServiceRate(64);
+
+    for (int i = 0; i < 20; ++i) {
+        QVERIFY(port1.enqueueOutput(QSharedPointer<Packet>::create(PacketType::Data, QByteArray::number(i)), 0));
+    }
+
+    // Data stops short of the reserve, which is still there for a control packet.
+    QCOMPARE(port1.serviceOutput(1), static_cast<quint64>(16 - Port::CONTROL_RESERVE));
+    QCOMPARE(port1.outputQueue().size(), 20 - (16 - Port::CONTROL_RESERVE));
+    QCOMPARE(port1.serviceOutput(1), static_cast<quint64>(0));
+    QVERIFY(port1.sendPacket(QSharedPointer<Packet>::create(PacketType::Control, "RIP")));
+}
+
 // QTEST_MAIN(PortTests)
 #include "PortTests.moc"
@@ -0,0 +1,139 @@
+#include <QtTest/QtTest>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "../src/Routing/RcuPointer.h"
+
+namespace {
+struct Tracked {
+    explicit Tracked(int v, std::atomic<int> *live) : value(v), live(live) { ++*live; }
+    ~Tracked() { --*live; }
+
+    int value;
+    std::atomic<int> *live;
+};
+}
+
+class RcuPointerTests : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testPublishReplacesValue();
+    void testRetiredFreedWithoutReaders();
+    void testPinnedReaderDelaysReclaim();
+    void testGuardsNest();
+    void testConcurrentReadersAndWriter();
+};
+
+void RcuPointerTests::testPublishReplacesValue() {
+    std::atomic<int> live {0};
+    RcuPointer<Tracked> pointer;
+    QVERIFY(pointer.load() == nullptr);
+
+    pointer.publish(std::make_unique<const Tracked>(1, &live));
+    pointer.publish(std::make_unique<const Tracked>(2, &live));
+
+    EpochReclaimer::ReadGuard guard;
+    QCOMPARE(pointer.load()->value, 2);
+}
+
+void RcuPointerTests::testRetiredFreedWithoutReaders() {
+    std::atomic<int> live {0};
+    {
+        RcuPointer<Tracked> pointer;
+        for (int i = 0; i < 5; ++i) {
+            pointer.publish(std::make_unique<const Tracked>(i, &live));
+        }
+
+        QCOMPARE(pointer.retiredCount(), 0);
+        QCOMPARE(live.load(), 1);
+    }
+    QCOMPARE(live.load(), 0);
+}
+
+void RcuPointerTests::testPinnedReaderDelaysReclaim() {
+    std::atomic<int> live {0};
+    RcuPointer<Tracked> pointer;
+    pointer.publish(std::make_unique<const Tracked>(1, &live));
+
+    std::atomic<bool> pinned {false};
+    std::atomic<bool> release {false};
+    int seen = 0;
+
+    std::thread reader([&]() {
+        EpochReclaimer::ReadGuard guard;
+        const Tracked *value = pointer.load();
+        pinned = true;
+        while (!release) std::this_thread::yield();
+        seen = value->value;
+    });
+
+    while (!pinned) std::this_thread::yield();
+    pointer.publish(std::make_unique<const Tracked>(2, &live));
+
+    QCOMPARE(pointer.retiredCount(), 1);
+    QCOMPARE(live.load(), 2);
+
+    release = true;
+    reader.join();
+
+    QCOMPARE(seen, 1);
+    QCOMPARE(pointer.reclaim(), 0);
+    QCOMPARE(live.load(), 1);
+}
+
+void RcuPointerTests::testGuardsNest() {
+    std::atomic<int> live {0};
+    RcuPointer<Tracked> pointer;
+    pointer.publish(std::make_unique<const Tracked>(1, &live));
+
+    {
+        EpochReclaimer::ReadGuard outer;
+        {
+            EpochReclaimer::ReadGuard inner;
+        }
+        pointer.publish(std::make_unique<const Tracked>(2, &live));
+
+        // The outer guard still pins the thread.
+        QCOMPARE(pointer.retiredCount(), 1);
+    }
+
+    QCOMPARE(pointer.reclaim(), 0);
+    QCOMPARE(live.load(), 1);
+}
+
+void RcuPointerTests::testConcurrentReadersAndWriter() {
+    std::atomic<int> live {0};
+    RcuPointer<Tracked> pointer;
+    pointer.publish(std::make_unique<const Tracked>(0, &live));
+
+    const int versions = 2000;
+    std::atomic<bool> done {false};
+    std::atomic<bool> ordered {true};
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&]() {
+            int last = 0;
+            while (!done) {
+                EpochReclaimer::ReadGuard guard;
+                int value = pointer.load()->value;
+                if (value < last) ordered = false;
+                last = value;
+            }
+        });
+    }
+
+    for (int i = 1; i <= versions; ++i) {
+        pointer.publish(std::make_unique<const Tracked>(i, &live));
+    }
+    done = true;
+    for (auto &reader : readers) reader.join();
+
+    QVERIFY(ordered.load());
+    QCOMPARE(pointer.reclaim(), 0);
+    QCOMPARE(live.load(), 1);
+}
+
+// QTEST_MAIN(RcuPointerTests)
+#include "RcuPointerTests.moc"
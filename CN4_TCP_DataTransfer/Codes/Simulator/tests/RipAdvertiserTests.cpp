@@ -0,0 +1,129 @@
+#include <QtTest/QtTest>
+#include "../src/Packet/ControlMessage.h"
+#include "../src/Routing/RipAdvertiser.h"
+
+class RipAdvertiserTests : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testFirstUpdateCarriesEverything();
+    void testConvergedTableSendsNothing();
+    void testOnlyChangedRoutesAreSent();
+    void testRemovedRoutesAreWithdrawn();
+    void testPoisonReversePerPort();
+    void testRefreshCarriesWholeTable();
+
+private:
+    static RouteEntry route(const QString &destination, int metric, int portIndex, bool direct = false);
+    static int metricOf(const QByteArray &payload, const QString &destination);
+};
+
+RouteEntry RipAdvertiserTests::route(const QString &destination, int metric, int portIndex,
+                                     bool direct) {
+    RouteEntry entry = RouteEntry::fromStrings(destination, "255.255.255.255", destination);
+    entry.metric = static_cast<qint16>(metric);
+    entry.portIndex = static_cast<qint16>(portIndex);
+    if (direct) entry.flags |= RouteEntry::FLAG_DIRECT;
+    return entry;
+}
+
+int RipAdvertiserTests::metricOf(const QByteArray &payload, const QString &destination) {
+    ControlMessageReader reader(payload);
+    for (int i = 0; i < reader.recordCount(); ++i) {
+        if (reader.recordAddress(i) == destination) return reader.record(i).metric;
+    }
+    return -1;
+}
+
+void RipAdvertiserTests::testFirstUpdateCarriesEverything() {
+    RoutingTable table;
+    table.insert(route("10.0.0.1", 0, -1, true));
+    table.insert(route("10.0.0.2", 2, 1));
+
+    RipAdvertiser advertiser(16);
+    QCOMPARE(advertiser.encodeChanges(table, 1), 2);
+    QCOMPARE(advertiser.advertisedCount(), 2);
+    QCOMPARE(ControlMessageReader(advertiser.payloadFor(0)).recordCount(), 2);
+}
+
+void RipAdvertiserTests::testConvergedTableSendsNothing() {
+    RoutingTable table;
+    table.insert(route("10.0.0.2", 2, 1));
+
+    RipAdvertiser advertiser(16);
+    advertiser.encodeChanges(table, 1);
+    QCOMPARE(advertiser.encodeChanges(table, 1), 0);
+    QCOMPARE(advertiser.encodeChanges(table, 1), 0);
+}
+
+void RipAdvertiserTests::testOnlyChangedRoutesAreSent() {
+    RoutingTable table;
+    table.insert(route("10.0.0.2", 2, 1));
+    table.insert(route("10.0.0.3", 3, 1));
+
+    RipAdvertiser advertiser(16);
+    advertiser.encodeChanges(table, 1);
+
+    table.find(ControlAddress::fromString("10.0.0.3"), 32, false)->metric = 5;
+    table.insert(route("10.0.0.4", 1, 2));
+
+    QCOMPARE(advertiser.encodeChanges(table, 1), 2);
+    QByteArray payload = advertiser.payloadFor(0);
+    QCOMPARE(metricOf(payload, "10.0.0.2"), -1);
+    QCOMPARE(metricOf(payload, "10.0.0.3"), 5);
+    QCOMPARE(metricOf(payload, "10.0.0.4"), 1);
+}
+
+void RipAdvertiserTests::testRemovedRoutesAreWithdrawn() {
+    RoutingTable table;
+    table.insert(route("10.0.0.2", 2, 1));
+    table.insert(route("10.0.0.3", 3, 1));
+
+    RipAdvertiser advertiser(16);
+    advertiser.encodeChanges(table, 1);
+    table.remove(ControlAddress::fromString("10.0.0.2"), 32, false);
+
+    QCOMPARE(advertiser.encodeChanges(table, 1), 1);
+    QCOMPARE(metricOf(advertiser.payloadFor(0), "10.0.0.2"), 16);
+    QCOMPARE(advertiser.advertisedCount(), 1);
+    QCOMPARE(advertiser.encodeChanges(table, 1), 0);
+}
+
+void RipAdvertiserTests::testPoisonReversePerPort() {
+    RoutingTable table;
+    table.insert(route("10.0.0.1", 0, 1, true));
+    table.insert(route("10.0.0.2", 2, 1));
+    table.insert(route("10.0.0.3", 3, 2));
+
+    RipAdvertiser advertiser(16);
+    advertiser.encodeTable(table, 1);
+
+    QByteArray port1 = advertiser.payloadFor(1);
+    QCOMPARE(metricOf(port1, "10.0.0.1"), 0);
+    QCOMPARE(metricOf(port1, "10.0.0.2"), 16);
+    QCOMPARE(metricOf(port1, "10.0.0.3"), 3);
+
+    QByteArray port2 = advertiser.payloadFor(2);
+    QCOMPARE(metricOf(port2, "10.0.0.2"), 2);
+    QCOMPARE(metricOf(port2, "10.0.0.3"), 16);
+
+    QByteArray unpoisoned = advertiser.payloadFor(0);
+    QCOMPARE(metricOf(unpoisoned, "10.0.0.2"), 2);
+    QCOMPARE(metricOf(unpoisoned, "10.0.0.3"), 3);
+    QCOMPARE(advertiser.payloadFor(3), unpoisoned);
+    QCOMPARE(advertiser.payloadFor(1), port1);
+}
+
+void RipAdvertiserTests::testRefreshCarriesWholeTable() {
+    RoutingTable table;
+    table.insert(route("10.0.0.2", 2, 1));
+    table.insert(route("10.0.0.3", 3, 1));
+
+    RipAdvertiser advertiser(16);
+    advertiser.encodeChanges(table, 1);
+    QCOMPARE(advertiser.encodeTable(table, 1), 2);
+    QCOMPARE(advertiser.encodeChanges(table, 1), 0);
+}
+
+// QTEST_MAIN(RipAdvertiserTests)
+#include "RipAdvertiserTests.moc"
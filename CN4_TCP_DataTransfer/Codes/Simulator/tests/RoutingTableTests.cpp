@@ -0,0 +1,135 @@
+#include <QtTest/QtTest>
+#include "../src/Routing/RoutingTable.h"
+
+namespace {
+RouteEntry route(const QString &destination, const QString &mask, int metric, bool direct = false) {
+    RouteEntry entry = RouteEntry::fromStrings(destination, mask, "10.0.0.1");
+    entry.metric = static_cast<qint16>(metric);
+    if (direct) entry.flags |= RouteEntry::FLAG_DIRECT;
+    return entry;
+}
+}
+
+class RoutingTableTests : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testFromStringsRoundTrip();
+    void testWildcardIsSlash24();
+    void testInsertReplacesSameKey();
+    void testDirectAndLearnedKeptApart();
+    void testRemoveKeepsIndexConsistent();
+    void testRemoveIf();
+    void testCompileKeepsBestUsableRoute();
+};
+
+void RoutingTableTests::testFromStringsRoundTrip() {
+    RouteEntry entry = RouteEntry::fromStrings("192.168.1.7", "255.255.255.0", "::ffff:10.0.0.2");
+
+    QCOMPARE(entry.destination(), QString("192.168.1.0"));
+    QCOMPARE(entry.mask(), QString("255.255.255.0"));
+    QCOMPARE(entry.nextHopAddress(), QString("::ffff:10.0.0.2"));
+    QCOMPARE(entry.length, static_cast<quint8>(24));
+    QVERIFY(entry.isNull());
+}
+
+void RoutingTableTests::testWildcardIsSlash24() {
+    RouteEntry entry = RouteEntry::fromStrings("192.168.200.xx", "255.255.255.255", "10.0.0.1");
+
+    QCOMPARE(entry.length, static_cast<quint8>(24));
+    QCOMPARE(entry.destination(), QString("192.168.200.xx"));
+}
+
+void RoutingTableTests::testInsertReplacesSameKey() {
+    RoutingTable table;
+    RouteEntry entry = route("192.168.1.0", "255.255.255.0", 3);
+    table.insert(entry);
+    table.insert(route("192.168.1.0", "255.255.255.0", 1));
+
+    QCOMPARE(table.size(), 1);
+    const RouteEntry *found = table.find(entry.prefix, 24, false);
+    QVERIFY(found);
+    QCOMPARE(found->metric, static_cast<qint16>(1));
+}
+
+void RoutingTableTests::testDirectAndLearnedKeptApart() {
+    RoutingTable table;
+    RouteEntry learned = route("10.0.0.5", "255.255.255.255", 2);
+    RouteEntry direct = route("10.0.0.5", "255.255.255.255", 1, true);
+    table.insert(learned);
+    table.insert(direct);
+
+    QCOMPARE(table.size(), 2);
+    QVERIFY(table.find(learned.prefix, 32, false));
+    QVERIFY(table.find(direct.prefix, 32, true));
+
+    QVERIFY(table.remove(learned.prefix, 32, false));
+    QVERIFY(!table.remove(learned.prefix, 32, false));
+    QVERIFY(table.find(direct.prefix, 32, true));
+}
+
+void RoutingTableTests::testRemoveKeepsIndexConsistent() {
+    RoutingTable table;
+    for (int i = 0; i < 8; ++i) {
+        table.insert(route(QString("10.0.%1.0").arg(i), "255.255.255.0", i));
+    }
+
+    // Removing from the front moves the last entry into the freed slot.
+    RouteEntry first = route("10.0.0.0", "255.255.255.0", 0);
+    QVERIFY(table.remove(first.prefix, 24, false));
+    QCOMPARE(table.size(), 7);
+
+    for (int i = 1; i < 8; ++i) {
+        RouteEntry expected = route(QString("10.0.%1.0").arg(i), "255.255.255.0", i);
+        const RouteEntry *found = table.find(expected.prefix, 24, false);
+        QVERIFY(found);
+        QCOMPARE(found->metric, static_cast<qint16>(i));
+    }
+}
+
+void RoutingTableTests::testRemoveIf() {
+    RoutingTable table;
+    for (int i = 0; i < 10; ++i) {
+        table.insert(route(QString("172.16.%1.0").arg(i), "255.255.255.0", i));
+    }
+
+    int removed = table.removeIf([](const RouteEntry &entry) { return entry.metric % 2 == 0; });
+
+    QCOMPARE(removed, 5);
+    QCOMPARE(table.size(), 5);
+    for (const auto &entry : table) {
+        QVERIFY(entry.metric % 2 == 1);
+        QVERIFY(table.find(entry.prefix, entry.length, false) == &entry);
+    }
+}
+
+void RoutingTableTests::testCompileKeepsBestUsableRoute() {
+    RoutingTable table;
+    RouteEntry subnet = route("192.168.1.0", "255.255.255.0", 2);
+    RouteEntry host = route("192.168.1.9", "255.255.255.255", 5);
+    RouteEntry unreachable = route("10.1.0.0", "255.255.0.0", 16);
+    RouteEntry direct = route("192.168.1.0", "255.255.255.0", 2, true);
+    table.insert(subnet);
+    table.insert(host);
+    table.insert(unreachable);
+    table.insert(direct);
+
+    std::unique_ptr<ForwardingSnapshot> snapshot = table.compile(16);
+    QCOMPARE(snapshot->routes.size(), static_cast<size_t>(2));
+
+    RouteEntry viaHost = snapshot->lookup(host.prefix);
+    QCOMPARE(viaHost.length, static_cast<quint8>(32));
+
+    RouteEntry viaSubnet = snapshot->lookup(host.prefix + 1);
+    QCOMPARE(viaSubnet.length, static_cast<quint8>(24));
+    QVERIFY(viaSubnet.isDirect());
+
+    QVERIFY(snapshot->lookup(unreachable.prefix).isNull());
+
+    // The snapshot does not follow later changes to the table.
+    table.remove(host.prefix, 32, false);
+    QCOMPARE(snapshot->lookup(host.prefix).length, static_cast<quint8>(32));
+}
+
+// QTEST_MAIN(RoutingTableTests)
+#include "RoutingTableTests.moc"
@@ -0,0 +1,199 @@
+#include <QtTest/QtTest>
+#include <algorithm>
+#include <random>
+#include "../src/Routing/DaryHeap.h"
+#include "../src/Routing/ShortestPath.h"
+
+namespace {
+// Undirected rows x cols torus, every link in both directions with weight 1.
+CsrGraph torus(int rows, int cols) {
+    std::vector<CsrGraph::Arc> arcs;
+    auto id = [cols](int r, int c) { return r * cols + c; };
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            int right = id(r, (c + 1) % cols);
+            int down = id((r + 1) % rows, c);
+            arcs.push_back({id(r, c), right, 1});
+            arcs.push_back({right, id(r, c), 1});
+            arcs.push_back({id(r, c), down, 1});
+            arcs.push_back({down, id(r, c), 1});
+        }
+    }
+    return CsrGraph::fromArcs(rows * cols, arcs);
+}
+}
+
+class ShortestPathTests : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testHeapPopsInKeyOrder();
+    void testHeapDecreaseKey();
+    void testCsrLayout();
+    void testWeightedPathAndFirstHop();
+    void testUnreachableNodes();
+    void testTorusDistancesAndFirstHops();
+    void testRepairAfterLinkLoss();
+    void testRepairMatchesFullRun();
+};
+
+void ShortestPathTests::testHeapPopsInKeyOrder() {
+    std::mt19937 rng(7);
+    std::vector<qint64> keys(500);
+    DaryHeap<4> heap(500);
+    for (int i = 0; i < 500; ++i) {
+        keys[i] = static_cast<qint64>(rng() % 1000);
+        heap.pushOrDecrease(i, keys[i]);
+    }
+
+    qint64 previous = -1;
+    while (!heap.isEmpty()) {
+        qint64 key = heap.topKey();
+        int item = heap.pop();
+        QCOMPARE(key, keys[item]);
+        QVERIFY(key >= previous);
+        previous = key;
+    }
+}
+
+void ShortestPathTests::testHeapDecreaseKey() {
+    DaryHeap<3> heap(4);
+    heap.pushOrDecrease(0, 10);
+    heap.pushOrDecrease(1, 20);
+    heap.pushOrDecrease(2, 30);
+
+    heap.pushOrDecrease(2, 5);
+    heap.pushOrDecrease(0, 50);    // not a decrease: ignored
+
+    QCOMPARE(heap.size(), 3);
+    QCOMPARE(heap.pop(), 2);
+    QCOMPARE(heap.pop(), 0);
+    QVERIFY(!heap.contains(0));
+    QVERIFY(heap.contains(1));
+}
+
+void ShortestPathTests::testCsrLayout() {
+    CsrGraph graph = CsrGraph::fromArcs(3, {{2, 0, 1}, {0, 1, 4}, {0, 2, 1}});
+
+    QCOMPARE(graph.nodeCount(), 3);
+    QCOMPARE(graph.arcCount(), 3);
+    QCOMPARE(graph.offsets, std::vector<int>({0, 2, 2, 3}));
+    QCOMPARE(graph.targets[2], 0);
+}
+
+void ShortestPathTests::testWeightedPathAndFirstHop() {
+    // 0 -> 1 costs 10 directly but 3 through 2.
+    CsrGraph graph = CsrGraph::fromArcs(4, {{0, 1, 10}, {0, 2, 1}, {2, 1, 2}, {1, 3, 1}});
+    ShortestPathTree tree;
+    tree.compute(graph, 0);
+
+    QCOMPARE(tree.distance(1), static_cast<qint64>(3));
+    QCOMPARE(tree.parent(1), 2);
+    QCOMPARE(tree.firstHop(1), 2);
+    QCOMPARE(tree.distance(3), static_cast<qint64>(4));
+    QCOMPARE(tree.firstHop(3), 2);
+    QCOMPARE(tree.firstHop(0), ShortestPathTree::NO_NODE);
+}
+
+void ShortestPathTests::testUnreachableNodes() {
+    CsrGraph graph = CsrGraph::fromArcs(3, {{0, 1, 1}});
+    ShortestPathTree tree;
+    tree.compute(graph, 0);
+
+    QVERIFY(tree.isReachable(1));
+    QVERIFY(!tree.isReachable(2));
+    QCOMPARE(tree.firstHop(2), ShortestPathTree::NO_NODE);
+
+    tree.compute(graph, ShortestPathTree::NO_NODE);
+    QVERIFY(!tree.isReachable(0));
+}
+
+void ShortestPathTests::testTorusDistancesAndFirstHops() {
+    const int rows = 6, cols = 8;
+    CsrGraph graph = torus(rows, cols);
+    ShortestPathTree tree;
+    tree.compute(graph, 0);
+
+    for (int node = 1; node < rows * cols; ++node) {
+        int r = node / cols, c = node % cols;
+        qint64 expected = std::min(r, rows - r) + std::min(c, cols - c);
+        QCOMPARE(tree.distance(node), expected);
+
+        // The first hop is a neighbour of the source one step closer to the destination.
+        int hop = tree.firstHop(node);
+        QCOMPARE(tree.distance(hop), static_cast<qint64>(1));
+        ShortestPathTree fromHop;
+        fromHop.compute(graph, hop);
+        QCOMPARE(fromHop.distance(node), expected - 1);
+    }
+}
+
+void ShortestPathTests::testRepairAfterLinkLoss() {
+    // A line 0 - 1 - 2 - 3 with a detour 0 - 4 - 5 - 3.
+    std::vector<CsrGraph::Arc> arcs = {{0, 1, 1}, {1, 2, 1}, {2, 3, 1}, {0, 4, 1}, {4, 5, 1}, {5, 3, 2}};
+    ShortestPathTree tree;
+    tree.compute(CsrGraph::fromArcs(6, arcs), 0);
+    QCOMPARE(tree.distance(3), static_cast<qint64>(3));
+    QCOMPARE(tree.firstHop(3), 1);
+
+    arcs.erase(arcs.begin() + 1);    // 1 - 2 goes down
+    std::vector<int> touched = tree.repair(CsrGraph::fromArcs(6, arcs), {1});
+
+    QCOMPARE(touched, std::vector<int>({2, 3}));
+    QVERIFY(!tree.isReachable(2));
+    QCOMPARE(tree.distance(3), static_cast<qint64>(4));
+    QCOMPARE(tree.firstHop(3), 4);
+    QCOMPARE(tree.firstHop(1), 1);
+}
+
+void ShortestPathTests::testRepairMatchesFullRun() {
+    std::mt19937 rng(11);
+    const int nodes = 40;
+    std::vector<std::vector<std::pair<int, int>>> links(nodes);
+    auto graphOf = [&]() {
+        std::vector<CsrGraph::Arc> arcs;
+        for (int from = 0; from < nodes; ++from) {
+            for (const auto &link : links[from]) arcs.push_back({from, link.first, link.second});
+        }
+        return CsrGraph::fromArcs(nodes, arcs);
+    };
+
+    for (int from = 0; from < nodes; ++from) {
+        for (int k = 0; k < 3; ++k) links[from].push_back({int(rng() % nodes), int(1 + rng() % 5)});
+    }
+
+    ShortestPathTree repaired;
+    repaired.compute(graphOf(), 0);
+
+    for (int round = 0; round < 200; ++round) {
+        // Rewrite the links of one or two nodes, as a new LSA would.
+        std::vector<int> changed;
+        for (int c = 0; c < 1 + int(rng() % 2); ++c) {
+            int node = int(rng() % nodes);
+            links[node].clear();
+            for (int k = 0; k < int(rng() % 4); ++k) links[node].push_back({int(rng() % nodes), int(1 + rng() % 5)});
+            changed.push_back(node);
+        }
+
+        CsrGraph graph = graphOf();
+        repaired.repair(graph, changed);
+        ShortestPathTree full;
+        full.compute(graph, 0);
+
+        for (int node = 0; node < nodes; ++node) {
+            QCOMPARE(repaired.distance(node), full.distance(node));
+            if (node == 0 || !full.isReachable(node)) continue;
+
+            // Ties may pick another first hop, but it has to start a shortest path.
+            int hop = repaired.firstHop(node);
+            int weight = graph.arcWeight(0, hop);
+            QVERIFY(weight >= 0);
+            ShortestPathTree fromHop;
+            fromHop.compute(graph, hop);
+            QCOMPARE(weight + fromHop.distance(node), full.distance(node));
+        }
+    }
+}
+
+// QTEST_MAIN(ShortestPathTests)
+#include "ShortestPathTests.moc"
@@ -0,0 +1,130 @@
+#include <QtTest/QtTest>
+#include <QList>
+#include "../src/EventsCoordinator/SimulationScheduler.h"
+
+class SimulationSchedulerTests : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testEventsRunInTimeOrder();
+    void testPriorityBreaksTies();
+    void testRecurringEventAndCancel();
+    void testRunUntilIdleIgnoresRecurring();
+    void testRunUntilAdvancesClock();
+    void testBetweenTicksRunsOncePerTick();
+    void testPostponeSkipsIdleTicks();
+};
+
+void SimulationSchedulerTests::testEventsRunInTimeOrder() {
+    SimulationScheduler scheduler;
+    QList<int> order;
+
+    scheduler.scheduleAt(30, [&]() { order.append(3); });
+    scheduler.scheduleAt(10, [&]() { order.append(1); });
+    scheduler.scheduleAt(20, [&]() { order.append(2); });
+
+    scheduler.run();
+
+    QCOMPARE(order, QList<int>({1, 2, 3}));
+    QCOMPARE(scheduler.now(), static_cast<SimTime_t>(30));
+    QCOMPARE(scheduler.executedEvents(), static_cast<quint64>(3));
+    QVERIFY(scheduler.isIdle());
+}
+
+void SimulationSchedulerTests::testPriorityBreaksTies() {
+    SimulationScheduler scheduler;
+    QList<int> order;
+
+    scheduler.scheduleAt(5, [&]() { order.append(3); }, EventPriority::Control);
+    scheduler.scheduleAt(5, [&]() { order.append(2); }, EventPriority::Tick);
+    scheduler.scheduleAt(5, [&]() { order.append(1); }, EventPriority::Delivery);
+    scheduler.scheduleAt(5, [&]() { order.append(4); }, EventPriority::Control);
+
+    scheduler.run();
+
+    QCOMPARE(order, QList<int>({1, 2, 3, 4}));
+}
+
+void SimulationSchedulerTests::testRecurringEventAndCancel() {
+    SimulationScheduler scheduler;
+    int ticks = 0;
+
+    EventId_t id = 0;
+    id = scheduler.scheduleEvery(2, [&]() {
+        if(++ticks == 5) scheduler.cancel(id);
+    });
+
+    scheduler.run();
+
+    QCOMPARE(ticks, 5);
+    QCOMPARE(scheduler.now(), static_cast<SimTime_t>(10));
+    QCOMPARE(scheduler.pendingEvents(), static_cast<size_t>(0));
+}
+
+void SimulationSchedulerTests::testRunUntilIdleIgnoresRecurring() {
+    SimulationScheduler scheduler;
+    int ticks = 0;
+    bool delivered = false;
+
+    scheduler.scheduleEvery(1, [&]() { ++ticks; });
+    scheduler.scheduleIn(3, [&]() {
+        scheduler.scheduleIn(1, [&]() { delivered = true; }, EventPriority::Delivery);
+    });
+
+    scheduler.runUntilIdle();
+
+    QVERIFY(delivered);
+    QCOMPARE(scheduler.now(), static_cast<SimTime_t>(4));
+    QCOMPARE(ticks, 3);
+    QCOMPARE(scheduler.pendingOneShotEvents(), static_cast<size_t>(0));
+    QCOMPARE(scheduler.pendingEvents(), static_cast<size_t>(1));
+}
+
+void SimulationSchedulerTests::testRunUntilAdvancesClock() {
+    SimulationScheduler scheduler;
+    bool late = false;
+
+    scheduler.scheduleAt(50, [&]() { late = true; });
+    scheduler.runUntil(20);
+
+    QVERIFY(!late);
+    QCOMPARE(scheduler.now(), static_cast<SimTime_t>(20));
+
+    scheduler.runUntil(50);
+    QVERIFY(late);
+}
+
+void SimulationSchedulerTests::testBetweenTicksRunsOncePerTick() {
+    SimulationScheduler scheduler;
+    QList<int> order;
+
+    scheduler.scheduleAt(1, [&]() { order.append(1); });
+    scheduler.scheduleAt(1, [&]() { order.append(1); }, EventPriority::Delivery);
+    scheduler.scheduleAt(2, [&]() { order.append(2); });
+
+    scheduler.run([&]() { order.append(0); });
+
+    QCOMPARE(order, QList<int>({0, 1, 1, 0, 2, 0}));
+}
+
+void SimulationSchedulerTests::testPostponeSkipsIdleTicks() {
+    SimulationScheduler scheduler;
+    QList<SimTime_t> ticks;
+
+    // A tick that finds nothing to do jumps to the next event, and picks up every tick after it.
+    scheduler.scheduleAt(50, [&]() { scheduler.stop(); });
+    EventId_t tick = 0;
+    tick = scheduler.scheduleEvery(1, [&]() {
+        ticks.append(scheduler.now());
+        SimTime_t next;
+        if (scheduler.now() == 2 && scheduler.nextEventTime(next)) scheduler.postpone(tick, next);
+    });
+
+    scheduler.run();
+
+    QCOMPARE(ticks, QList<SimTime_t>({1, 2, 50}));
+    QCOMPARE(scheduler.now(), static_cast<SimTime_t>(50));
+}
+
+// QTEST_MAIN(SimulationSchedulerTests)
+#include "SimulationSchedulerTests.moc"
@@ -0,0 +1,65 @@
+#include <QtTest/QtTest>
+#include "../src/Routing/SpfThrottle.h"
+
+class SpfThrottleTests : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testFirstRequestUsesInitialDelay();
+    void testRequestsCoalesceWhilePending();
+    void testHoldDoublesUnderLoad();
+    void testHoldResetsAfterQuietPeriod();
+};
+
+void SpfThrottleTests::testFirstRequestUsesInitialDelay() {
+    SpfThrottle throttle(2, 5, 40);
+    QVERIFY(!throttle.isPending());
+
+    QCOMPARE(throttle.request(10), static_cast<quint64>(12));
+    QVERIFY(!throttle.isDue(11));
+    QVERIFY(throttle.isDue(12));
+}
+
+void SpfThrottleTests::testRequestsCoalesceWhilePending() {
+    SpfThrottle throttle(1, 5, 40);
+    throttle.request(0);
+    for (int i = 0; i < 50; ++i) {
+        QCOMPARE(throttle.request(0), static_cast<quint64>(1));
+    }
+
+    QCOMPARE(throttle.coalescedRequests(), static_cast<quint64>(50));
+    throttle.completed(1);
+    QVERIFY(!throttle.isPending());
+    QCOMPARE(throttle.runs(), static_cast<quint64>(1));
+}
+
+void SpfThrottleTests::testHoldDoublesUnderLoad() {
+    SpfThrottle throttle(1, 5, 20);
+    throttle.request(0);
+    throttle.completed(1);
+
+    // Each change right after a run waits out the hold, which then doubles up to the maximum.
+    QCOMPARE(throttle.request(2), static_cast<quint64>(6));
+    throttle.completed(6);
+    QCOMPARE(throttle.request(7), static_cast<quint64>(16));
+    throttle.completed(16);
+    QCOMPARE(throttle.request(17), static_cast<quint64>(36));
+    throttle.completed(36);
+    QCOMPARE(throttle.currentHold(), static_cast<quint64>(20));
+    QCOMPARE(throttle.request(37), static_cast<quint64>(56));
+}
+
+void SpfThrottleTests::testHoldResetsAfterQuietPeriod() {
+    SpfThrottle throttle(1, 5, 20);
+    throttle.request(0);
+    throttle.completed(1);
+    throttle.request(2);
+    throttle.completed(6);
+    QCOMPARE(throttle.currentHold(), static_cast<quint64>(10));
+
+    QCOMPARE(throttle.request(100), static_cast<quint64>(101));
+    QCOMPARE(throttle.currentHold(), static_cast<quint64>(5));
+}
+
+// QTEST_MAIN(SpfThrottleTests)
+#include "SpfThrottleTests.moc"
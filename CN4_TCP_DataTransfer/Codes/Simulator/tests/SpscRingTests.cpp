@@ -0,0 +1,95 @@
+#include <QtTest/QtTest>
+#include <QList>
+#include <thread>
+#include "../src/Queue/SpscRing.h"
+
+class SpscRingTests : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testCapacityRoundsUpToPowerOfTwo();
+    void testItemsInvisibleUntilPublished();
+    void testPushFailsWhenFull();
+    void testDrainRespectsBatchLimit();
+    void testProducerConsumerThreads();
+};
+
+void SpscRingTests::testCapacityRoundsUpToPowerOfTwo() {
+    SpscRing<int> ring(100);
+    QCOMPARE(ring.capacity(), static_cast<size_t>(128));
+}
+
+void SpscRingTests::testItemsInvisibleUntilPublished() {
+    SpscRing<int> ring(8);
+    QList<int> received;
+
+    QVERIFY(ring.push(1));
+    QVERIFY(ring.push(2));
+    QCOMPARE(ring.drain([&](int v) { received.append(v); }), static_cast<size_t>(0));
+
+    QCOMPARE(ring.publish(), static_cast<size_t>(2));
+    QCOMPARE(ring.drain([&](int v) { received.append(v); }), static_cast<size_t>(2));
+    QCOMPARE(received, QList<int>({1, 2}));
+}
+
+void SpscRingTests::testPushFailsWhenFull() {
+    SpscRing<int> ring(4);
+
+    for (int i = 0; i < 4; ++i) {
+        QVERIFY(ring.push(i));
+    }
+    QVERIFY(!ring.push(4));
+    QCOMPARE(ring.freeSlots(), static_cast<size_t>(0));
+
+    ring.publish();
+    QCOMPARE(ring.drain([](int) {}, 1), static_cast<size_t>(1));
+
+    QVERIFY(ring.push(4));
+}
+
+void SpscRingTests::testDrainRespectsBatchLimit() {
+    SpscRing<int> ring(16);
+    for (int i = 0; i < 10; ++i) {
+        ring.push(i);
+    }
+    ring.publish();
+
+    QList<int> received;
+    QCOMPARE(ring.drain([&](int v) { received.append(v); }, 4), static_cast<size_t>(4));
+    QCOMPARE(ring.drain([&](int v) { received.append(v); }, 4), static_cast<size_t>(4));
+    QCOMPARE(ring.drain([&](int v) { received.append(v); }, 4), static_cast<size_t>(2));
+    QCOMPARE(received.size(), 10);
+    QCOMPARE(received.last(), 9);
+}
+
+void SpscRingTests::testProducerConsumerThreads() {
+    SpscRing<int> ring(64);
+    const int count = 100000;
+
+    std::thread producer([&]() {
+        for (int i = 0; i < count; ++i) {
+            while (!ring.push(i)) {
+                ring.publish();
+                std::this_thread::yield();
+            }
+            if (i % 16 == 0) ring.publish();
+        }
+        ring.publish();
+    });
+
+    int expected = 0;
+    bool inOrder = true;
+    while (expected < count) {
+        ring.drain([&](int v) {
+            inOrder = inOrder && (v == expected);
+            ++expected;
+        });
+    }
+    producer.join();
+
+    QVERIFY(inOrder);
+    QCOMPARE(expected, count);
+}
+
+// QTEST_MAIN(SpscRingTests)
+#include "SpscRingTests.moc"
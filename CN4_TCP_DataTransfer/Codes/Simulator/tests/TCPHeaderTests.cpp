@@ -8,6 +8,8 @@ private Q_SLOTS:
     void testDefaultConstructor();
     void testParameterizedConstructor();
     void testFieldManagement();
+    void testEcnFlags();
+    void testSackBlocks();
 };
 
 void TCPHeaderTests::testDefaultConstructor() {
@@ -69,5 +71,40 @@ void TCPHeaderTests::testFieldManagement() {
     QCOMPARE(header.getUrgentPointer(), static_cast<uint16_t>(456));
 }
 
+void TCPHeaderTests::testEcnFlags() {
+    TCPHeader header;
+
+    header.setFlag(TCPHeader::FLAG_ACK);
+    header.setFlag(TCPHeader::FLAG_ECE);
+    QVERIFY(header.hasFlag(TCPHeader::FLAG_ACK));
+    QVERIFY(header.hasFlag(TCPHeader::FLAG_ECE));
+    QVERIFY(!header.hasFlag(TCPHeader::FLAG_CWR));
+    QCOMPARE(header.getFlags(), static_cast<uint8_t>(0x50));
+
+    header.setFlag(TCPHeader::FLAG_ECE, false);
+    QVERIFY(!header.hasFlag(TCPHeader::FLAG_ECE));
+    QCOMPARE(header.getFlags(), static_cast<uint8_t>(TCPHeader::FLAG_ACK));
+}
+
+void TCPHeaderTests::testSackBlocks() {
+    TCPHeader header;
+    QCOMPARE(header.sackBlockCount(), 0);
+
+    QVERIFY(!header.addSackBlock(5, 5));
+    QVERIFY(header.addSackBlock(10, 12));
+    QVERIFY(header.addSackBlock(4, 6));
+    QVERIFY(header.addSackBlock(20, 21));
+    QVERIFY(!header.addSackBlock(30, 31));
+
+    QCOMPARE(header.sackBlockCount(), TCPHeader::MAX_SACK_BLOCKS);
+    QCOMPARE(header.sackBlock(0).left, static_cast<uint32_t>(10));
+    QCOMPARE(header.sackBlock(1).right, static_cast<uint32_t>(6));
+
+    TCPHeader copy = header;
+    header.clearSackBlocks();
+    QCOMPARE(header.sackBlockCount(), 0);
+    QCOMPARE(copy.sackBlock(2).left, static_cast<uint32_t>(20));
+}
+
 // QTEST_MAIN(TCPHeaderTests)
 #include "TCPHeaderTests.moc"
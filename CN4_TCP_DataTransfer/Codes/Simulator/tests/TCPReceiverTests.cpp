@@ -0,0 +1,144 @@
+#include <QtTest/QtTest>
+#include "../src/Transport/TCPReceiver.h"
+
+class TCPReceiverTests : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testInOrderIsDeliveredAtOnce();
+    void testOutOfOrderWaitsForTheHole();
+    void testDuplicatesAndOutOfWindow();
+    void testOutOfWindowAliasingAHeldSlot();
+    void testAckCarriesSackBlocksLatestFirst();
+    void testSackBlocksAreCapped();
+    void testRingWrapsAround();
+};
+
+void TCPReceiverTests::testInOrderIsDeliveredAtOnce() {
+    TCPReceiver receiver;
+    QCOMPARE(receiver.onSegment(0, QByteArray("ab")), TCPReceiver::Arrival::InOrder);
+    QCOMPARE(receiver.onSegment(1, QByteArray("cd")), TCPReceiver::Arrival::InOrder);
+
+    QCOMPARE(receiver.nextExpected(), static_cast<quint32>(2));
+    QCOMPARE(receiver.read(), QByteArray("abcd"));
+    QCOMPARE(receiver.read(), QByteArray());
+    QCOMPARE(receiver.stats().deliveredBytes, quint64(4));
+}
+
+void TCPReceiverTests::testOutOfOrderWaitsForTheHole() {
+    TCPReceiver receiver;
+    QCOMPARE(receiver.onSegment(2, QByteArray("c")), TCPReceiver::Arrival::OutOfOrder);
+    QCOMPARE(receiver.onSegment(3, QByteArray("d")), TCPReceiver::Arrival::OutOfOrder);
+    QCOMPARE(receiver.onSegment(1, QByteArray("b")), TCPReceiver::Arrival::OutOfOrder);
+
+    QCOMPARE(receiver.nextExpected(), static_cast<quint32>(0));
+    QCOMPARE(receiver.buffered(), 3);
+    QCOMPARE(receiver.holes(), 1);
+    QCOMPARE(receiver.read(), QByteArray());
+
+    // Filling the hole delivers the whole run behind it, in order.
+    QCOMPARE(receiver.onSegment(0, QByteArray("a")), TCPReceiver::Arrival::InOrder);
+    QCOMPARE(receiver.nextExpected(), static_cast<quint32>(4));
+    QCOMPARE(receiver.buffered(), 0);
+    QCOMPARE(receiver.holes(), 0);
+    QCOMPARE(receiver.read(), QByteArray("abcd"));
+    QCOMPARE(receiver.stats().outOfOrder, quint64(3));
+    QCOMPARE(receiver.stats().highWatermark, 3);
+}
+
+void TCPReceiverTests::testDuplicatesAndOutOfWindow() {
+    TCPReceiver receiver(4);
+    receiver.onSegment(0, QByteArray("a"));
+    receiver.onSegment(2, QByteArray("c"));
+
+    QCOMPARE(receiver.onSegment(0, QByteArray("a")), TCPReceiver::Arrival::Duplicate);
+    QCOMPARE(receiver.onSegment(2, QByteArray("c")), TCPReceiver::Arrival::Duplicate);
+    QCOMPARE(receiver.onSegment(5, QByteArray("f")), TCPReceiver::Arrival::OutOfWindow);
+
+    TCPReceiverStats stats = receiver.stats();
+    QCOMPARE(stats.received, quint64(5));
+    QCOMPARE(stats.duplicates, quint64(2));
+    QCOMPARE(stats.outOfWindow, quint64(1));
+    QCOMPARE(receiver.buffered(), 1);
+}
+
+void TCPReceiverTests::testOutOfWindowAliasingAHeldSlot() {
+    TCPReceiver receiver(4);
+    receiver.onSegment(2, QByteArray("c"));
+
+    // 6 maps onto the slot 2 occupies, but lies beyond the window [0, 4).
+    QCOMPARE(receiver.onSegment(6, QByteArray("g")), TCPReceiver::Arrival::OutOfWindow);
+
+    TCPReceiverStats stats = receiver.stats();
+    QCOMPARE(stats.outOfWindow, quint64(1));
+    QCOMPARE(stats.duplicates, quint64(0));
+    QCOMPARE(receiver.buffered(), 1);
+
+    receiver.onSegment(0, QByteArray("a"));
+    receiver.onSegment(1, QByteArray("b"));
+    QCOMPARE(receiver.read(), QByteArray("abc"));
+}
+
+void TCPReceiverTests::testAckCarriesSackBlocksLatestFirst() {
+    TCPReceiver receiver;
+    receiver.onSegment(0, QByteArray("a"));
+    receiver.onSegment(2, QByteArray("c"));
+    receiver.onSegment(3, QByteArray("d"));
+    receiver.onSegment(6, QByteArray("g"));
+    receiver.onSegment(4, QByteArray("e"));
+
+    TCPHeader header;
+    receiver.fillAck(header);
+
+    QCOMPARE(header.getAcknowledgmentNumber(), static_cast<uint32_t>(1));
+    QCOMPARE(header.sackBlockCount(), 2);
+    QCOMPARE(header.sackBlock(0).left, static_cast<uint32_t>(2));
+    QCOMPARE(header.sackBlock(0).right, static_cast<uint32_t>(5));
+    QCOMPARE(header.sackBlock(1).left, static_cast<uint32_t>(6));
+    QCOMPARE(header.sackBlock(1).right, static_cast<uint32_t>(7));
+    QCOMPARE(receiver.holes(), 2);
+
+    // Nothing held: a plain cumulative ACK.
+    receiver.onSegment(1, QByteArray("b"));
+    receiver.onSegment(5, QByteArray("f"));
+    receiver.fillAck(header);
+    QCOMPARE(header.getAcknowledgmentNumber(), static_cast<uint32_t>(7));
+    QCOMPARE(header.sackBlockCount(), 0);
+}
+
+void TCPReceiverTests::testSackBlocksAreCapped() {
+    TCPReceiver receiver;
+    for (quint32 sequence = 2; sequence <= 10; sequence += 2) {
+        receiver.onSegment(sequence, QByteArray("x"));
+    }
+
+    TCPHeader header;
+    receiver.fillAck(header);
+
+    QCOMPARE(header.sackBlockCount(), TCPHeader::MAX_SACK_BLOCKS);
+    QCOMPARE(header.sackBlock(0).left, static_cast<uint32_t>(10));
+    QCOMPARE(header.sackBlock(1).left, static_cast<uint32_t>(2));
+    QCOMPARE(header.sackBlock(2).left, static_cast<uint32_t>(4));
+}
+
+void TCPReceiverTests::testRingWrapsAround() {
+    TCPReceiver receiver(4);
+    QByteArray expected;
+
+    // Pairs arrive swapped, many times round a four-slot ring.
+    for (quint32 base = 0; base < 40; base += 2) {
+        QByteArray first(1, static_cast<char>('a' + base % 26));
+        QByteArray second(1, static_cast<char>('a' + (base + 1) % 26));
+        expected += first + second;
+
+        QCOMPARE(receiver.onSegment(base + 1, second), TCPReceiver::Arrival::OutOfOrder);
+        QCOMPARE(receiver.onSegment(base, first), TCPReceiver::Arrival::InOrder);
+    }
+
+    QCOMPARE(receiver.nextExpected(), static_cast<quint32>(40));
+    QCOMPARE(receiver.read(), expected);
+    QCOMPARE(receiver.buffered(), 0);
+}
+
+// QTEST_MAIN(TCPReceiverTests)
+#include "TCPReceiverTests.moc"
@@ -0,0 +1,292 @@
+#include <QtTest/QtTest>
+#include "../src/Transport/TCPReceiver.h"
+#include "../src/Transport/TCPSender.h"
+
+class TCPSenderTests : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testInitialWindowLimitsNewData();
+    void testSlowStartGrowsPerAck();
+    void testCongestionAvoidanceGrowsPerWindow();
+    void testThreeDuplicateAcksTriggerFastRetransmit();
+    void testPartialAckResendsNextHole();
+    void testFullAckEndsRecovery();
+    void testTimeoutResendsEverythingOutstanding();
+    void testKarnSkipsRetransmittedSamples();
+    void testEcnEchoCutsWindowOncePerWindow();
+    void testSackedSegmentsLeaveThePipe();
+    void testSackResendsEveryHoleInOneRecovery();
+
+private:
+    static int sendAll(TCPSender &sender, SimTime_t now);
+    static void growTo(TCPSender &sender, int window, SimTime_t now);
+    static void ackFrom(TCPSender &sender, const TCPReceiver &receiver, SimTime_t now);
+};
+
+void TCPSenderTests::ackFrom(TCPSender &sender, const TCPReceiver &receiver, SimTime_t now) {
+    TCPHeader header;
+    receiver.fillAck(header);
+
+    QList<TCPHeader::SackBlock> blocks;
+    for (int i = 0; i < header.sackBlockCount(); ++i) {
+        blocks.append(header.sackBlock(i));
+    }
+    sender.onAck(header.getAcknowledgmentNumber(), false, now, blocks);
+}
+
+int TCPSenderTests::sendAll(TCPSender &sender, SimTime_t now) {
+    int sent = 0;
+    while (sender.canSendNew()) {
+        sender.onSent(QByteArray("segment"), now);
+        ++sent;
+    }
+    return sent;
+}
+
+void TCPSenderTests::growTo(TCPSender &sender, int window, SimTime_t now) {
+    while (sender.window() < window) {
+        sendAll(sender, now);
+        sender.onAck(sender.nextSequence(), false, now + 1);
+    }
+}
+
+void TCPSenderTests::testInitialWindowLimitsNewData() {
+    TCPSender sender;
+    QCOMPARE(sendAll(sender, 0), TCPSender::INITIAL_WINDOW);
+    QCOMPARE(sender.outstanding(), TCPSender::INITIAL_WINDOW);
+    QCOMPARE(sender.nextSequence(), static_cast<quint32>(TCPSender::INITIAL_WINDOW));
+}
+
+void TCPSenderTests::testSlowStartGrowsPerAck() {
+    TCPSender sender;
+    sendAll(sender, 0);
+
+    for (quint32 ack = 1; ack <= 4; ++ack) {
+        sender.onAck(ack, false, 5);
+    }
+
+    QCOMPARE(sender.window(), 8.0);
+    QCOMPARE(sender.outstanding(), 0);
+    QCOMPARE(sendAll(sender, 5), 8);
+}
+
+void TCPSenderTests::testCongestionAvoidanceGrowsPerWindow() {
+    TCPSender sender;
+    growTo(sender, 8, 0);
+    sendAll(sender, 10);
+
+    // A timeout sets ssthresh to half the flight and restarts from one segment.
+    QVERIFY(sender.onTick(10 + TCPSender::INITIAL_RTO));
+    double ssthresh = sender.ssthresh();
+    QVERIFY(ssthresh >= 2);
+
+    // Slow start back up to ssthresh, then roughly one segment per window.
+    SimTime_t now = 50;
+    while (sender.window() < ssthresh) {
+        quint32 sequence;
+        QByteArray payload;
+        while (sender.nextRetransmission(sequence, payload)) sender.onRetransmitted(sequence, now);
+        sender.onAck(sender.unacknowledged() + 1, false, ++now);
+    }
+
+    double before = sender.window();
+    sender.onAck(sender.unacknowledged() + 1, false, ++now);
+    QVERIFY(sender.window() > before);
+    QVERIFY(sender.window() - before <= 1.0 / before + 1e-9);
+}
+
+void TCPSenderTests::testThreeDuplicateAcksTriggerFastRetransmit() {
+    TCPSender sender;
+    growTo(sender, 8, 0);
+    quint32 first = sender.nextSequence();
+    QCOMPARE(sendAll(sender, 10), 8);
+
+    // The first segment is lost; the next three arrive and each ACK asks for it again.
+    sender.onAck(first, false, 12);
+    sender.onAck(first, false, 12);
+    QVERIFY(!sender.inRecovery());
+    sender.onAck(first, false, 12);
+
+    QVERIFY(sender.inRecovery());
+    QCOMPARE(sender.stats().fastRetransmits, static_cast<quint64>(1));
+    QCOMPARE(sender.ssthresh(), 4.0);
+    QCOMPARE(sender.window(), 4.0 + TCPSender::DUP_ACK_THRESHOLD);
+
+    quint32 sequence;
+    QByteArray payload;
+    QVERIFY(sender.nextRetransmission(sequence, payload));
+    QCOMPARE(sequence, first);
+    QCOMPARE(payload, QByteArray("segment"));
+    sender.onRetransmitted(sequence, 12);
+    QVERIFY(!sender.nextRetransmission(sequence, payload));
+
+    // Further duplicates inflate the window.
+    sender.onAck(first, false, 13);
+    QCOMPARE(sender.window(), 8.0);
+}
+
+void TCPSenderTests::testPartialAckResendsNextHole() {
+    TCPSender sender;
+    growTo(sender, 8, 0);
+    quint32 first = sender.nextSequence();
+    sendAll(sender, 10);
+
+    // Segments first and first + 4 are lost.
+    for (int i = 0; i < 3; ++i) sender.onAck(first, false, 12);
+    quint32 sequence;
+    QByteArray payload;
+    QVERIFY(sender.nextRetransmission(sequence, payload));
+    sender.onRetransmitted(sequence, 12);
+    for (int i = 0; i < 3; ++i) sender.onAck(first, false, 13);
+
+    // The resent segment fills the first hole; the ACK stops at the second one.
+    sender.onAck(first + 4, false, 20);
+    QVERIFY(sender.inRecovery());
+    QVERIFY(sender.nextRetransmission(sequence, payload));
+    QCOMPARE(sequence, first + 4);
+}
+
+void TCPSenderTests::testFullAckEndsRecovery() {
+    TCPSender sender;
+    growTo(sender, 8, 0);
+    quint32 first = sender.nextSequence();
+    sendAll(sender, 10);
+
+    for (int i = 0; i < 3; ++i) sender.onAck(first, false, 12);
+    quint32 sequence;
+    QByteArray payload;
+    sender.nextRetransmission(sequence, payload);
+    sender.onRetransmitted(sequence, 12);
+
+    sender.onAck(sender.nextSequence(), false, 20);
+    QVERIFY(!sender.inRecovery());
+    QVERIFY(sender.window() <= sender.ssthresh());
+    QCOMPARE(sender.outstanding(), 0);
+}
+
+void TCPSenderTests::testTimeoutResendsEverythingOutstanding() {
+    TCPSender sender;
+    sendAll(sender, 0);
+
+    QVERIFY(!sender.onTick(TCPSender::INITIAL_RTO - 1));
+    QVERIFY(sender.onTick(TCPSender::INITIAL_RTO));
+    QCOMPARE(sender.window(), 1.0);
+    QCOMPARE(sender.rto(), 2 * TCPSender::INITIAL_RTO);
+    QCOMPARE(sender.pipe(), 0);
+    QVERIFY(!sender.canSendNew());
+
+    // The head goes out at once, the rest as ACKs open the window again.
+    quint32 sequence;
+    QByteArray payload;
+    QVERIFY(sender.nextRetransmission(sequence, payload));
+    QCOMPARE(sequence, static_cast<quint32>(0));
+    sender.onRetransmitted(sequence, 30);
+    QVERIFY(!sender.nextRetransmission(sequence, payload));
+
+    sender.onAck(1, false, 35);
+    QVERIFY(sender.nextRetransmission(sequence, payload));
+    QCOMPARE(sequence, static_cast<quint32>(1));
+    QCOMPARE(sender.stats().timeouts, static_cast<quint64>(1));
+}
+
+void TCPSenderTests::testKarnSkipsRetransmittedSamples() {
+    TCPSender sender;
+    sender.onSent(QByteArray("a"), 0);
+    sender.onAck(1, false, 4);
+    QCOMPARE(sender.stats().srtt, 4.0);
+
+    sender.onSent(QByteArray("b"), 10);
+    QVERIFY(sender.onTick(10 + sender.rto()));
+    quint32 sequence;
+    QByteArray payload;
+    QVERIFY(sender.nextRetransmission(sequence, payload));
+    sender.onRetransmitted(sequence, 30);
+    sender.onAck(2, false, 200);
+
+    QCOMPARE(sender.stats().srtt, 4.0);
+}
+
+void TCPSenderTests::testEcnEchoCutsWindowOncePerWindow() {
+    TCPSender sender;
+    sender.setEcn(true);
+    sender.setCongestionControl(CongestionAlgorithm::Dctcp);
+    const auto &dctcp = static_cast<const DctcpControl &>(sender.congestionControl());
+    growTo(sender, 16, 0);
+    quint64 cutsBefore = sender.stats().windowCuts;
+    double before = sender.window();
+    double alpha = dctcp.alpha();
+
+    // A whole window comes back marked: alpha moves towards 1 and the window shrinks once.
+    sendAll(sender, 10);
+    quint32 end = sender.nextSequence();
+    for (quint32 ack = sender.unacknowledged() + 1; ack <= end; ++ack) {
+        sender.onAck(ack, true, 12);
+    }
+
+    QCOMPARE(sender.stats().windowCuts, cutsBefore + 1);
+    QVERIFY(dctcp.alpha() > alpha * (1 - DctcpControl::GAIN));
+    QVERIFY(sender.window() < before);
+    QVERIFY(sender.stats().ecnEchoes > 0);
+}
+
+void TCPSenderTests::testSackedSegmentsLeaveThePipe() {
+    TCPSender sender;
+    sendAll(sender, 0);
+
+    // Segment 0 is missing; 2 and 3 arrived.
+    QList<TCPHeader::SackBlock> blocks {TCPHeader::SackBlock{2, 4}};
+    sender.onAck(0, false, 2, blocks);
+
+    QCOMPARE(sender.sacked(), 2);
+    QCOMPARE(sender.pipe(), 2);
+    QCOMPARE(sender.stats().sacked, quint64(2));
+
+    // The cumulative ACK covers them; nothing is counted twice.
+    sender.onAck(4, false, 3);
+    QCOMPARE(sender.sacked(), 0);
+    QCOMPARE(sender.outstanding(), 0);
+}
+
+void TCPSenderTests::testSackResendsEveryHoleInOneRecovery() {
+    TCPSender sender;
+    growTo(sender, 16, 0);
+
+    TCPReceiver receiver;
+    for (quint32 sequence = 0; sequence < sender.unacknowledged(); ++sequence) {
+        receiver.onSegment(sequence, QByteArray("segment"));
+    }
+
+    // Two segments of the window are lost; everything else arrives and is SACKed.
+    quint32 first = sender.nextSequence();
+    sendAll(sender, 10);
+    quint32 end = sender.nextSequence();
+    for (quint32 sequence = first; sequence < end; ++sequence) {
+        if (sequence == first || sequence == first + 2) continue;
+        receiver.onSegment(sequence, QByteArray("segment"));
+        ackFrom(sender, receiver, 12);
+    }
+
+    QVERIFY(sender.inRecovery());
+    QCOMPARE(sender.stats().fastRetransmits, quint64(1));
+
+    // Both holes go out in the same tick, without waiting for a partial ACK.
+    quint32 sequence;
+    QByteArray payload;
+    QList<quint32> resent;
+    while (sender.nextRetransmission(sequence, payload)) {
+        sender.onRetransmitted(sequence, 13);
+        resent.append(sequence);
+    }
+    QCOMPARE(resent, (QList<quint32> {first, first + 2}));
+
+    receiver.onSegment(first, payload);
+    receiver.onSegment(first + 2, payload);
+    ackFrom(sender, receiver, 20);
+    QVERIFY(!sender.inRecovery());
+    QCOMPARE(sender.outstanding(), 0);
+    QCOMPARE(sender.stats().retransmitted, quint64(2));
+}
+
+// QTEST_MAIN(TCPSenderTests)
+#include "TCPSenderTests.moc"
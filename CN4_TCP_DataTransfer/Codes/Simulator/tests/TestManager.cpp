@@ -1,16 +1,50 @@
 #include <QtTest/QtTest>
+#include "ActiveQueueManagerTests.cpp"
+#include "CongestionControlTests.cpp"
+#include "ControlMessageTests.cpp"
 #include "DataGeneratorTests.cpp"
 #include "DataLinkHeaderTests.cpp"
+#include "ForwardingTableTests.cpp"
 #include "IPHeaderTests.cpp"
+#include "LinkStateDatabaseTests.cpp"
 #include "MACAddressTests.cpp"
+#include "MpscRingTests.cpp"
+#include "OutputQueueTests.cpp"
 #include "PacketTests.cpp"
 #include "PortTests.cpp"
+#include "RcuPointerTests.cpp"
+#include "RipAdvertiserTests.cpp"
+#include "RoutingTableTests.cpp"
 #include "RouterRegistryTests.cpp"
+#include "ShortestPathTests.cpp"
+#include "SimulationSchedulerTests.cpp"
+#include "SpfThrottleTests.cpp"
+#include "SpscRingTests.cpp"
 #include "TCPHeaderTests.cpp"
+#include "TCPReceiverTests.cpp"
+#include "TCPSenderTests.cpp"
+#include "TickExecutorTests.cpp"
+#include "TimerServiceTests.cpp"
+#include "TimingWheelTests.cpp"
 
 int main(int argc, char *argv[]) {
     int status = 0;
 
+    {
+        ActiveQueueManagerTests activeQueueManagerTests;
+        status |= QTest::qExec(&activeQueueManagerTests, argc, argv);
+    }
+
+    {
+        CongestionControlTests congestionControlTests;
+        status |= QTest::qExec(&congestionControlTests, argc, argv);
+    }
+
+    {
+        ControlMessageTests controlMessageTests;
+        status |= QTest::qExec(&controlMessageTests, argc, argv);
+    }
+
     {
         DataGeneratorTests dataGeneratorTests;
         status |= QTest::qExec(&dataGeneratorTests, argc, argv);
@@ -21,16 +55,36 @@ int main(int argc, char *argv[]) {
         status |= QTest::qExec(&dataLinkHeaderTests, argc, argv);
     }
 
+    {
+        ForwardingTableTests forwardingTableTests;
+        status |= QTest::qExec(&forwardingTableTests, argc, argv);
+    }
+
     {
         IPHeaderTests ipHeaderTests;
         status |= QTest::qExec(&ipHeaderTests, argc, argv);
     }
 
+    {
+        LinkStateDatabaseTests linkStateDatabaseTests;
+        status |= QTest::qExec(&linkStateDatabaseTests, argc, argv);
+    }
+
     {
         MACAddressTests macAddressTests;
         status |= QTest::qExec(&macAddressTests, argc, argv);
     }
 
+    {
+        MpscRingTests mpscRingTests;
+        status |= QTest::qExec(&mpscRingTests, argc, argv);
+    }
+
+    {
+        OutputQueueTests outputQueueTests;
+        status |= QTest::qExec(&outputQueueTests, argc, argv);
+    }
+
     {
         PacketTests packetTests;
         status |= QTest::qExec(&packetTests, argc, argv);
@@ -41,15 +95,75 @@ int main(int argc, char *argv[]) {
         status |= QTest::qExec(&portTests, argc, argv);
     }
 
+    {
+        RcuPointerTests rcuPointerTests;
+        status |= QTest::qExec(&rcuPointerTests, argc, argv);
+    }
+
+    {
+        RipAdvertiserTests ripAdvertiserTests;
+        status |= QTest::qExec(&ripAdvertiserTests, argc, argv);
+    }
+
+    {
+        RoutingTableTests routingTableTests;
+        status |= QTest::qExec(&routingTableTests, argc, argv);
+    }
+
     {
         RouterRegistryTests routerRegistryTests;
         status |= QTest::qExec(&routerRegistryTests, argc, argv);
     }
 
+    {
+        ShortestPathTests shortestPathTests;
+        status |= QTest::qExec(&shortestPathTests, argc, argv);
+    }
+
+    {
+        SimulationSchedulerTests simulationSchedulerTests;
+        status |= QTest::qExec(&simulationSchedulerTests, argc, argv);
+    }
+
+    {
+        SpfThrottleTests spfThrottleTests;
+        status |= QTest::qExec(&spfThrottleTests, argc, argv);
+    }
+
+    {
+        SpscRingTests spscRingTests;
+        status |= QTest::qExec(&spscRingTests, argc, argv);
+    }
+
     {
         TCPHeaderTests tcpHeaderTests;
         status |= QTest::qExec(&tcpHeaderTests, argc, argv);
     }
 
+    {
+        TCPReceiverTests tcpReceiverTests;
+        status |= QTest::qExec(&tcpReceiverTests, argc, argv);
+    }
+
+    {
+        TCPSenderTests tcpSenderTests;
+        status |= QTest::qExec(&tcpSenderTests, argc, argv);
+    }
+
+    {
+        TickExecutorTests tickExecutorTests;
+        status |= QTest::qExec(&tickExecutorTests, argc, argv);
+    }
+
+    {
+        TimerServiceTests timerServiceTests;
+        status |= QTest::qExec(&timerServiceTests, argc, argv);
+    }
+
+    {
+        TimingWheelTests timingWheelTests;
+        status |= QTest::qExec(&timingWheelTests, argc, argv);
+    }
+
     return status;
 }
@@ -0,0 +1,157 @@
+#include <QtTest/QtTest>
+#include <QThread>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "../src/EventsCoordinator/TickExecutor.h"
+#include "../src/Network/Node.h"
+
+// What the probe nodes of one executor share: how many receive phases have finished so far, and
+// whether a route phase ever started before all of its tick's receive phases were done.
+struct TickProbe
+{
+    int               nodeCount = 0;
+    std::atomic<int>  receivesDone {0};
+    std::atomic<bool> orderViolated {false};
+};
+
+class TickProbeNode : public Node
+{
+public:
+    TickProbeNode(int id, TickProbe *probe, unsigned long receiveDelayMs = 0) :
+        Node(id, "10.0.0.1", NodeType::Router),
+        m_probe(probe),
+        m_receiveDelayMs(receiveDelayMs)
+    {}
+
+    quint64 receivePhase(const TickContext &context) override {
+        Q_UNUSED(context)
+        if (m_receiveDelayMs > 0) QThread::msleep(m_receiveDelayMs);
+        receives.fetch_add(1);
+        m_probe->receivesDone.fetch_add(1);
+        return 1;
+    }
+
+    quint64 routePhase(const TickContext &context) override {
+        // Ticks are numbered from 1, so tick t may only route once t receive rounds are done.
+        if (m_probe->receivesDone.load() < static_cast<int>(context.now) * m_probe->nodeCount)
+            m_probe->orderViolated = true;
+        routes.fetch_add(1);
+        return 0;
+    }
+
+    quint64 transmitPhase(const TickContext &context) override {
+        Q_UNUSED(context)
+        transmits.fetch_add(1);
+        return 0;
+    }
+
+    std::atomic<int> receives {0};
+    std::atomic<int> routes {0};
+    std::atomic<int> transmits {0};
+
+private:
+    TickProbe     *m_probe;
+    unsigned long  m_receiveDelayMs;
+};
+
+class TickExecutorTests : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testEveryNodeRunsOncePerPhase();
+    void testRoutePhaseWaitsForReceivePhase();
+    void testIdleWorkersStealFromBusyOnes();
+    void testSingleWorkerRunsInline();
+
+private:
+    static std::vector<Node *> nodes(const std::vector<std::unique_ptr<TickProbeNode>> &probes);
+    static quint64 runTicks(TickExecutor &executor, int ticks);
+};
+
+std::vector<Node *> TickExecutorTests::nodes(const std::vector<std::unique_ptr<TickProbeNode>> &probes) {
+    std::vector<Node *> result;
+    for (const auto &probe : probes) result.push_back(probe.get());
+    return result;
+}
+
+quint64 TickExecutorTests::runTicks(TickExecutor &executor, int ticks) {
+    quint64 work = 0;
+    for (int tick = 1; tick <= ticks; ++tick) {
+        TickContext context;
+        context.now = static_cast<SimTime_t>(tick);
+        work += executor.runTick(context);
+    }
+    return work;
+}
+
+void TickExecutorTests::testEveryNodeRunsOncePerPhase() {
+    TickProbe probe;
+    probe.nodeCount = 37;
+    std::vector<std::unique_ptr<TickProbeNode>> probes;
+    for (int i = 0; i < probe.nodeCount; ++i) probes.push_back(std::make_unique<TickProbeNode>(i, &probe));
+
+    TickExecutor executor(4);
+    executor.setNodes(nodes(probes));
+
+    // Every receive phase reports one packet, so a tick moves exactly one per node.
+    QCOMPARE(runTicks(executor, 5), static_cast<quint64>(5 * probe.nodeCount));
+
+    for (const auto &node : probes) {
+        QCOMPARE(node->receives.load(), 5);
+        QCOMPARE(node->routes.load(), 5);
+        QCOMPARE(node->transmits.load(), 5);
+    }
+}
+
+void TickExecutorTests::testRoutePhaseWaitsForReceivePhase() {
+    TickProbe probe;
+    probe.nodeCount = 12;
+    std::vector<std::unique_ptr<TickProbeNode>> probes;
+    for (int i = 0; i < probe.nodeCount; ++i)
+        probes.push_back(std::make_unique<TickProbeNode>(i, &probe, static_cast<unsigned long>(i % 3)));
+
+    TickExecutor executor(4);
+    executor.setNodes(nodes(probes));
+    runTicks(executor, 3);
+
+    QVERIFY(!probe.orderViolated.load());
+    QCOMPARE(probe.receivesDone.load(), 3 * probe.nodeCount);
+}
+
+void TickExecutorTests::testIdleWorkersStealFromBusyOnes() {
+    // Round-robin puts every slow node on worker 0 and every fast one on worker 1, which runs out of
+    // its own work long before worker 0 does.
+    TickProbe probe;
+    probe.nodeCount = 32;
+    std::vector<std::unique_ptr<TickProbeNode>> probes;
+    for (int i = 0; i < probe.nodeCount; ++i)
+        probes.push_back(std::make_unique<TickProbeNode>(i, &probe, i % 2 == 0 ? 5 : 0));
+
+    TickExecutor executor(2);
+    executor.setNodes(nodes(probes));
+    QCOMPARE(executor.stolenTasks(), static_cast<quint64>(0));
+
+    runTicks(executor, 1);
+
+    QVERIFY(executor.stolenTasks() > 0);
+    for (const auto &node : probes) QCOMPARE(node->receives.load(), 1);
+}
+
+void TickExecutorTests::testSingleWorkerRunsInline() {
+    TickProbe probe;
+    probe.nodeCount = 5;
+    std::vector<std::unique_ptr<TickProbeNode>> probes;
+    for (int i = 0; i < probe.nodeCount; ++i) probes.push_back(std::make_unique<TickProbeNode>(i, &probe));
+
+    TickExecutor executor(1);
+    QCOMPARE(executor.workerCount(), 1);
+    executor.setNodes(nodes(probes));
+
+    QCOMPARE(runTicks(executor, 3), static_cast<quint64>(3 * probe.nodeCount));
+    QVERIFY(!probe.orderViolated.load());
+    QCOMPARE(executor.stolenTasks(), static_cast<quint64>(0));
+}
+
+// QTEST_MAIN(TickExecutorTests)
+#include "TickExecutorTests.moc"
@@ -0,0 +1,104 @@
+#include <QtTest/QtTest>
+#include <QList>
+#include "../src/EventsCoordinator/TimerService.h"
+
+class TimerServiceTests : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testOneShotFiresOnce();
+    void testPeriodicTimerRepeats();
+    void testCancelStopsTimer();
+    void testDestroyedContextDropsTimer();
+    void testCallbackMayCancelLaterTimer();
+    void testNextExpiryIsEarliestTimer();
+};
+
+void TimerServiceTests::testOneShotFiresOnce() {
+    TimerService timers;
+    QList<SimTime_t> firedAt;
+    timers.scheduleIn(5, nullptr, [&]() { firedAt.append(timers.now()); });
+    QCOMPARE(timers.pendingTimers(), static_cast<size_t>(1));
+
+    QCOMPARE(timers.advance(4), 0);
+    QCOMPARE(timers.advance(5), 1);
+    QCOMPARE(timers.advance(50), 0);
+
+    QCOMPARE(firedAt, QList<SimTime_t>({5}));
+    QCOMPARE(timers.pendingTimers(), static_cast<size_t>(0));
+}
+
+void TimerServiceTests::testPeriodicTimerRepeats() {
+    TimerService timers;
+    QList<SimTime_t> firedAt;
+    timers.scheduleEvery(10, nullptr, [&]() { firedAt.append(timers.now()); });
+
+    for (SimTime_t tick = 1; tick <= 35; ++tick) {
+        timers.advance(tick);
+    }
+
+    QCOMPARE(firedAt, QList<SimTime_t>({10, 20, 30}));
+    QCOMPARE(timers.pendingTimers(), static_cast<size_t>(1));
+}
+
+void TimerServiceTests::testCancelStopsTimer() {
+    TimerService timers;
+    int runs = 0;
+    TimerService::TimerId_t id = timers.scheduleEvery(2, nullptr, [&]() { ++runs; });
+
+    timers.advance(2);
+    QVERIFY(timers.cancel(id));
+    QVERIFY(!timers.cancel(id));
+    timers.advance(10);
+
+    QCOMPARE(runs, 1);
+}
+
+void TimerServiceTests::testDestroyedContextDropsTimer() {
+    TimerService timers;
+    int runs = 0;
+    {
+        QObject context;
+        timers.scheduleEvery(3, &context, [&]() { ++runs; });
+        timers.advance(3);
+    }
+
+    timers.advance(20);
+    QCOMPARE(runs, 1);
+    QCOMPARE(timers.pendingTimers(), static_cast<size_t>(0));
+}
+
+void TimerServiceTests::testCallbackMayCancelLaterTimer() {
+    TimerService timers;
+    QList<int> order;
+    TimerService::TimerId_t second = TimerService::NO_TIMER;
+    timers.scheduleIn(4, nullptr, [&]() {
+        order.append(1);
+        timers.cancel(second);
+        timers.scheduleIn(1, nullptr, [&]() { order.append(3); });
+    });
+    second = timers.scheduleIn(4, nullptr, [&]() { order.append(2); });
+
+    timers.advance(4);
+    timers.advance(5);
+    QCOMPARE(order, QList<int>({1, 3}));
+}
+
+void TimerServiceTests::testNextExpiryIsEarliestTimer() {
+    TimerService timers;
+    SimTime_t expiry = 0;
+    QVERIFY(!timers.nextExpiry(expiry));
+
+    // One timer far beyond the finest wheel level, one close by.
+    timers.scheduleIn(5000, nullptr, []() {});
+    TimerService::TimerId_t near = timers.scheduleIn(40, nullptr, []() {});
+    QVERIFY(timers.nextExpiry(expiry));
+    QCOMPARE(expiry, static_cast<SimTime_t>(40));
+
+    timers.cancel(near);
+    QVERIFY(timers.nextExpiry(expiry));
+    QCOMPARE(expiry, static_cast<SimTime_t>(5000));
+}
+
+// QTEST_MAIN(TimerServiceTests)
+#include "TimerServiceTests.moc"
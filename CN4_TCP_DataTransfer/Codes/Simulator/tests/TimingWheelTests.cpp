@@ -0,0 +1,104 @@
+#include <QtTest/QtTest>
+#include <QList>
+#include "../src/EventsCoordinator/TimingWheel.h"
+
+class TimingWheelTests : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testTimersFireAtTheirExpiry();
+    void testCancelledTimersDoNotFire();
+    void testFarTimersCascade();
+    void testPastExpiryFiresOnNextAdvance();
+    void testCallbackMayReschedule();
+};
+
+void TimingWheelTests::testTimersFireAtTheirExpiry() {
+    TimingWheel wheel;
+    QList<SimTime_t> firedAt;
+    QList<quint64> fired;
+    auto record = [&](TimingWheel::TimerId_t, quint64 data) {
+        firedAt.append(wheel.now());
+        fired.append(data);
+    };
+
+    wheel.schedule(30, 3);
+    wheel.schedule(5, 1);
+    wheel.schedule(63, 4);
+    wheel.schedule(5, 2);
+    QCOMPARE(wheel.size(), static_cast<size_t>(4));
+
+    QCOMPARE(wheel.advance(4, record), 0);
+    QCOMPARE(wheel.advance(100, record), 4);
+
+    QCOMPARE(firedAt, QList<SimTime_t>({5, 5, 30, 63}));
+    QCOMPARE(fired[2], static_cast<quint64>(3));
+    QCOMPARE(fired[3], static_cast<quint64>(4));
+    QCOMPARE(wheel.size(), static_cast<size_t>(0));
+}
+
+void TimingWheelTests::testCancelledTimersDoNotFire() {
+    TimingWheel wheel;
+    TimingWheel::TimerId_t kept = wheel.schedule(10, 1);
+    TimingWheel::TimerId_t dropped = wheel.schedule(10, 2);
+
+    QVERIFY(wheel.cancel(dropped));
+    QVERIFY(!wheel.cancel(dropped));
+    QVERIFY(!wheel.isPending(dropped));
+    QVERIFY(wheel.isPending(kept));
+
+    QList<quint64> fired;
+    wheel.advance(10, [&](TimingWheel::TimerId_t, quint64 data) { fired.append(data); });
+    QCOMPARE(fired, QList<quint64>({1}));
+    QVERIFY(!wheel.isPending(kept));
+
+    // A recycled slot gets a new id, so the stale one stays dead.
+    TimingWheel::TimerId_t reused = wheel.schedule(20, 3);
+    QVERIFY(reused != kept && reused != dropped);
+    QVERIFY(!wheel.cancel(kept));
+}
+
+void TimingWheelTests::testFarTimersCascade() {
+    TimingWheel wheel(7);
+    const QList<SimTime_t> expiries = {70, 4'100, 4'103, 300'000, 20'000'000};
+    for (SimTime_t expiry : expiries) {
+        wheel.schedule(expiry, expiry);
+    }
+
+    QList<SimTime_t> firedAt;
+    wheel.advance(20'000'100, [&](TimingWheel::TimerId_t, quint64 data) {
+        QCOMPARE(static_cast<quint64>(wheel.now()), data);
+        firedAt.append(wheel.now());
+    });
+    QCOMPARE(firedAt, expiries);
+}
+
+void TimingWheelTests::testPastExpiryFiresOnNextAdvance() {
+    TimingWheel wheel(50);
+    wheel.schedule(10, 1);
+
+    SimTime_t firedAt = 0;
+    wheel.advance(51, [&](TimingWheel::TimerId_t, quint64) { firedAt = wheel.now(); });
+    QCOMPARE(firedAt, static_cast<SimTime_t>(51));
+}
+
+void TimingWheelTests::testCallbackMayReschedule() {
+    TimingWheel wheel;
+    wheel.schedule(5, 1);
+    TimingWheel::TimerId_t other = wheel.schedule(6, 2);
+
+    QList<quint64> fired;
+    wheel.advance(30, [&](TimingWheel::TimerId_t, quint64 data) {
+        fired.append(data);
+        if (data == 1) {
+            QVERIFY(wheel.cancel(other));
+            wheel.schedule(wheel.now() + 10, 3);
+        }
+    });
+
+    QCOMPARE(fired, QList<quint64>({1, 3}));
+    QCOMPARE(wheel.size(), static_cast<size_t>(0));
+}
+
+// QTEST_MAIN(TimingWheelTests)
+#include "TimingWheelTests.moc"
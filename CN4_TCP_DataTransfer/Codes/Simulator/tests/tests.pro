@@ -5,14 +5,33 @@ QT += core testlib
 QT += network
 
 SOURCES += $$PWD/TestManager.cpp \
+           $$PWD/ActiveQueueManagerTests.cpp \
+           $$PWD/CongestionControlTests.cpp \
+           $$PWD/ControlMessageTests.cpp \
            $$PWD/MACAddressTests.cpp \
+           $$PWD/MpscRingTests.cpp \
+           $$PWD/OutputQueueTests.cpp \
            $$PWD/PacketTests.cpp \
            $$PWD/DataGeneratorTests.cpp \
            $$PWD/DataLinkHeaderTests.cpp \
+           $$PWD/ForwardingTableTests.cpp \
            $$PWD/TCPHeaderTests.cpp \
+           $$PWD/TCPReceiverTests.cpp \
+           $$PWD/TCPSenderTests.cpp \
            $$PWD/IPHeaderTests.cpp \
+           $$PWD/LinkStateDatabaseTests.cpp \
            $$PWD/PortTests.cpp \
-           $$PWD/RouterRegistryTests.cpp
+           $$PWD/RcuPointerTests.cpp \
+           $$PWD/RipAdvertiserTests.cpp \
+           $$PWD/RoutingTableTests.cpp \
+           $$PWD/RouterRegistryTests.cpp \
+           $$PWD/ShortestPathTests.cpp \
+           $$PWD/SimulationSchedulerTests.cpp \
+           $$PWD/SpfThrottleTests.cpp \
+           $$PWD/SpscRingTests.cpp \
+           $$PWD/TickExecutorTests.cpp \
+           $$PWD/TimerServiceTests.cpp \
+           $$PWD/TimingWheelTests.cpp
 
 INCLUDEPATH += $$PWD/../src \
                $$PWD/../src/Globals